@@ -0,0 +1,69 @@
+ /**
+ ******************************************************************************
+ * @file    boot_conf.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef BOOT_CONF_H
+#define BOOT_CONF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+#define BOOT_CONF_ERROR_NONE     0
+#define BOOT_CONF_ERROR_EMPTY   -1  /*!< No configuration saved */
+#define BOOT_CONF_ERROR_NVM     -2
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  /* Display */
+  uint32_t is_hdmi;          /*!< HDMI transmitter drives the display */
+  uint32_t edid_hash;        /*!< Monitor, see HDMI_GetEdidHash() */
+  uint32_t width;
+  uint32_t height;
+  uint32_t pixel_clock_hz;
+  uint32_t refresh_mhz;
+  uint32_t layer_formats;    /*!< Background layer << 16 | foreground layer LCD_PIXEL_FORMAT_xxx */
+  /* Camera */
+  uint32_t sensor_id;        /*!< Sensor default resolution, see CAMERA_MODE_GetSensorName() */
+  uint32_t sensor_width;     /*!< Sensor mode */
+  uint32_t sensor_height;
+  uint32_t sensor_fps;
+  uint32_t camera_format;    /*!< DCMIPP pipe output DCMIPP_PIXEL_PACKER_FORMAT_xxx */
+} BOOT_CONF_t;
+
+/* Exported functions ------------------------------------------------------- */
+/*
+ * Last-known-good configuration, applied at boot instead of detecting the
+ * monitor and probing the sensor. The caller verifies it once running and
+ * saves the configuration in use; unchanged configurations are not rewritten.
+ */
+int32_t BOOT_CONF_Load(BOOT_CONF_t *conf);
+int32_t BOOT_CONF_Save(const BOOT_CONF_t *conf);
+int32_t BOOT_CONF_Invalidate(void);
+int BOOT_CONF_IsSameDisplay(const BOOT_CONF_t *a, const BOOT_CONF_t *b);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_CONF_H */
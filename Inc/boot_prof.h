@@ -0,0 +1,57 @@
+ /**
+ ******************************************************************************
+ * @file    boot_prof.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef BOOT_PROF_H
+#define BOOT_PROF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* Boot phases, in the order they usually complete */
+#define BOOT_PROF_HARDWARE      0U  /*!< Caches, clocks, HAL, BSP */
+#define BOOT_PROF_NOR           1U  /*!< IQ profile loaded from NOR */
+#define BOOT_PROF_HDMI_DETECT   2U  /*!< ADV7513 probed, bring-up started */
+#define BOOT_PROF_LCD           3U  /*!< LTDC running */
+#define BOOT_PROF_CAMERA_INIT   4U  /*!< Sensor mode negotiated and sensor programmed */
+#define BOOT_PROF_CAMERA_START  5U  /*!< Capture started */
+#define BOOT_PROF_HDMI_READY    6U  /*!< Monitor plugged, transmitter locked */
+#define BOOT_PROF_FIRST_FRAME   7U  /*!< First camera frame scanned out on a ready display */
+#define BOOT_PROF_NB            8U
+
+/* Exported functions ------------------------------------------------------- */
+/*
+ * Times are measured from BOOT_PROF_Init(), first call of main(), with the
+ * DWT cycle counter and the core clock in effect when each phase starts.
+ */
+void BOOT_PROF_Init(void);
+void BOOT_PROF_Mark(uint32_t phase);
+uint32_t BOOT_PROF_GetUs(uint32_t phase);
+const char *BOOT_PROF_GetName(uint32_t phase);
+void BOOT_PROF_Trace(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_PROF_H */
@@ -0,0 +1,78 @@
+ /**
+ ******************************************************************************
+ * @file    bus_arb.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef BUS_ARB_H
+#define BUS_ARB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32n6xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Presets, the higher the more bus is left to the LTDC reads */
+#define BUS_ARB_PRESET_RELAXED   0U  /*!< Camera writes at full speed */
+#define BUS_ARB_PRESET_BALANCED  1U  /*!< 720p class pixel clocks */
+#define BUS_ARB_PRESET_TIGHT     2U  /*!< 1080p class pixel clocks */
+#define BUS_ARB_PRESET_NB        3U
+
+/* Underruns are checked over this period */
+#define BUS_ARB_PERIOD_MS        1000U
+
+#define BUS_ARB_ERROR_NONE       0
+#define BUS_ARB_ERROR_PARAM     -1
+#define BUS_ARB_ERROR_HAL       -2
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t max_pixel_clock_hz;  /*!< Display modes up to this pixel clock start here */
+  uint32_t dcmipp_traffic;      /*!< DCMIPP_TRAFFIC_BURST_SIZE_xxx of the pipe 1 client */
+  uint32_t dcmipp_outstanding;  /*!< DCMIPP_OUTSTANDING_TRANSACTION_xxx of the pipe 1 client */
+  uint32_t dma2d_dead_time;     /*!< Cycles between DMA2D bus accesses, 0..255, 0 for none */
+} BUS_ARB_Preset_t;
+
+typedef struct
+{
+  uint32_t preset;              /*!< BUS_ARB_PRESET_xxx in use */
+  uint32_t escalations;         /*!< Presets raised after underruns */
+  uint32_t clean_periods;       /*!< Periods without underrun with the camera writing */
+  uint32_t deferred;            /*!< IP-Plug updates retried next period, pipe busy */
+} BUS_ARB_Stats_t;
+
+/* Exported functions ------------------------------------------------------- */
+/*
+ * Bus arbitration between the LTDC reads and the DCMIPP and DMA2D writes.
+ * This device exposes no AXI QoS setting for these masters: the LTDC gets the
+ * bus by throttling the others, through the DCMIPP IP-Plug of the pipe 1
+ * client and the DMA2D dead time. The preset of the display mode is raised
+ * each period the LTDC underruns while the camera writes.
+ */
+int32_t BUS_ARB_Init(DCMIPP_HandleTypeDef *hdcmipp, uint32_t pixel_clock_hz);
+int32_t BUS_ARB_SetPreset(uint32_t preset);
+void BUS_ARB_Process(void);
+void BUS_ARB_GetStats(BUS_ARB_Stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BUS_ARB_H */
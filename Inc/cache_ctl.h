@@ -0,0 +1,67 @@
+ /**
+ ******************************************************************************
+ * @file    cache_ctl.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CACHE_CTL_H
+#define CACHE_CTL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* D-cache policy of a memory range */
+#define CACHE_CTL_POLICY_WRITE_BACK     0U  /*!< CPU data: read and write allocate */
+#define CACHE_CTL_POLICY_WRITE_THROUGH  1U  /*!< CPU writes, DMA reads: stores reach memory, no clean needed */
+#define CACHE_CTL_POLICY_NON_CACHEABLE  2U  /*!< DMA only buffers: never take a cache line */
+
+/* MPU regions managed, at most */
+#define CACHE_CTL_REGION_NB    8U
+#define CACHE_CTL_LINE         32U
+
+#define CACHE_CTL_ERROR_NONE        0
+#define CACHE_CTL_ERROR_PARAM      -1
+#define CACHE_CTL_ERROR_NO_REGION  -2
+
+/* Exported functions ------------------------------------------------------- */
+/*
+ * Per buffer D-cache policy through MPU regions, on top of the default memory
+ * map (AXISRAM write-back, PSRAM write-through). Regions must not overlap and
+ * are aligned on CACHE_CTL_LINE.
+ *
+ * Range maintenance applies the policy of the range start: cleaning a
+ * write-through or non-cacheable range, invalidating a non-cacheable one, do
+ * nothing. Ranges are widened to whole cache lines; with write-back memory,
+ * partial lines at the edges are written back before being invalidated.
+ */
+void CACHE_CTL_Init(void);
+int32_t CACHE_CTL_SetRegion(void *base, uint32_t size, uint32_t policy);
+int32_t CACHE_CTL_ClearRegion(void *base);
+uint32_t CACHE_CTL_GetPolicy(const void *address);
+void CACHE_CTL_Clean(const void *address, uint32_t size);
+void CACHE_CTL_Invalidate(void *address, uint32_t size);
+void CACHE_CTL_CleanInvalidate(void *address, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CACHE_CTL_H */
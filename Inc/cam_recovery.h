@@ -0,0 +1,86 @@
+ /**
+ ******************************************************************************
+ * @file    cam_recovery.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CAM_RECOVERY_H
+#define CAM_RECOVERY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32n6xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* CSI_SR1 error classes */
+#define CAM_RECOVERY_CSI_CRC        CSI_SR1_CRCERRF
+#define CAM_RECOVERY_CSI_ECC        (CSI_SR1_ECCERRF | CSI_SR1_CECCERRF)
+#define CAM_RECOVERY_CSI_SYNC       (CSI_SR1_SYNCERRF | CSI_SR1_WDERRF | CSI_SR1_SPKTERRF | CSI_SR1_IDERRF)
+
+/* DCMIPP_CMSR2 errors */
+#define CAM_RECOVERY_DCMIPP_OVR     (DCMIPP_CMSR2_P0OVRF | DCMIPP_CMSR2_P1OVRF | DCMIPP_CMSR2_P2OVRF)
+#define CAM_RECOVERY_DCMIPP_ERRORS  (CAM_RECOVERY_DCMIPP_OVR | DCMIPP_CMSR2_ATXERRF | DCMIPP_CMSR2_PRERRF)
+
+/* Restart causes, in the trace */
+#define CAM_RECOVERY_CAUSE_ERRORS   1U  /*!< Errors in consecutive frame periods */
+#define CAM_RECOVERY_CAUSE_STALL    2U  /*!< No frame captured */
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t frame_period_ms;     /*!< Sensor frame period */
+  int32_t (*restart)(void);     /*!< Restarts sensor and pipe, 0 on success */
+} CAM_RECOVERY_Conf_t;
+
+typedef struct
+{
+  uint32_t csi_crc;
+  uint32_t csi_ecc;             /*!< Corrected and uncorrectable header errors */
+  uint32_t csi_sync;            /*!< Frame sync, word count, packet and ID errors */
+  uint32_t csi_phy;             /*!< Data lane (D-PHY) errors */
+  uint32_t dcmipp_overruns;
+  uint32_t dcmipp_errors;       /*!< AXI transfer and parallel sync errors */
+  uint32_t isp_errors;          /*!< ISP (AE/AWB) updates failed */
+  uint32_t restarts;
+  uint32_t restart_failures;
+  uint32_t last_outage_ms;      /*!< Last good frame to first frame after restart */
+  uint32_t max_outage_ms;
+} CAM_RECOVERY_Stats_t;
+
+/* Exported functions ------------------------------------------------------- */
+/*
+ * Camera link error accounting and in-place recovery. CSI and DCMIPP errors
+ * are counted from their interrupts, failed ISP updates from the application
+ * loop; when they persist over consecutive frame
+ * periods, or when no frame is captured, the sensor and pipe are restarted
+ * from the application loop. LTDC and HDMI are not touched: the last frame
+ * stays on screen during the outage.
+ */
+void CAM_RECOVERY_Init(const CAM_RECOVERY_Conf_t *conf);
+void CAM_RECOVERY_OnCsiErrors(uint32_t sr1);
+void CAM_RECOVERY_OnDcmippErrors(uint32_t cmsr2);
+void CAM_RECOVERY_OnIspError(void);
+void CAM_RECOVERY_Process(void);
+void CAM_RECOVERY_GetStats(CAM_RECOVERY_Stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAM_RECOVERY_H */
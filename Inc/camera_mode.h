@@ -0,0 +1,72 @@
+ /**
+ ******************************************************************************
+ * @file    camera_mode.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CAMERA_MODE_H
+#define CAMERA_MODE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+#define CAMERA_MODE_MAX               4
+
+#define CAMERA_MODE_FLAG_BINNING      (1U << 0)
+#define CAMERA_MODE_FLAG_ROI          (1U << 1)
+
+#define CAMERA_MODE_ERROR_NONE         0
+#define CAMERA_MODE_ERROR_NO_MODE     -1  /*!< No sensor mode covers the output */
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t width;
+  uint32_t height;
+  uint32_t min_fps;
+  uint32_t max_fps;
+  uint32_t bpp;       /*!< Bits per pixel on the CSI link */
+  uint32_t flags;     /*!< CAMERA_MODE_FLAG_xxx */
+} CAMERA_MODE_Mode_t;
+
+typedef struct
+{
+  const CAMERA_MODE_Mode_t *mode;
+  uint32_t fps;
+  uint32_t refresh_divider;  /*!< Display frames per camera frame, 0 if fps does not divide the refresh */
+  uint32_t readout_us;       /*!< Sensor readout time of one frame */
+  uint32_t csi_mbps;         /*!< CSI payload bandwidth at fps */
+} CAMERA_MODE_Choice_t;
+
+/* Exported functions ------------------------------------------------------- */
+/*
+ * Sensors are identified by their driver default resolution, as returned by
+ * CMW_CAMERA_Init() called with width = height = 0.
+ */
+const char *CAMERA_MODE_GetSensorName(uint32_t sensor_id);
+int32_t CAMERA_MODE_Negotiate(uint32_t sensor_id, uint32_t out_width, uint32_t out_height, uint32_t refresh_mhz,
+                              CAMERA_MODE_Choice_t choices[CAMERA_MODE_MAX], uint32_t *nb_choices);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAMERA_MODE_H */
@@ -0,0 +1,40 @@
+ /**
+ ******************************************************************************
+ * @file    cpu_load.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CPU_LOAD_H
+#define CPU_LOAD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported functions ------------------------------------------------------- */
+void CPU_LOAD_Init(void);
+void CPU_LOAD_Sleep(void);
+uint32_t CPU_LOAD_GetPercent(void);
+uint32_t CPU_LOAD_GetPermille(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CPU_LOAD_H */
@@ -0,0 +1,60 @@
+ /**
+ ******************************************************************************
+ * @file    disp_latency.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef DISP_LATENCY_H
+#define DISP_LATENCY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+#define DISP_LATENCY_ERROR_NONE       0
+#define DISP_LATENCY_ERROR_SCANLINE  -1
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t x;                    /*!< Patch position in the current UTIL_LCD layer */
+  uint32_t y;                    /*!< Also the display line of the patch top */
+  uint32_t size;                 /*!< Patch side, in pixels */
+  uint32_t period_ms;            /*!< Between two flashes */
+  uint32_t flashes_per_content;  /*!< Flashes before the content type is switched */
+} DISP_LATENCY_Conf_t;
+
+/* Exported functions ------------------------------------------------------- */
+/*
+ * Display latency test: a patch flashes black / white and LED_GREEN toggles
+ * when the scanout reaches the patch top line of the first refresh showing
+ * it. A photodiode on the patch and a probe on the LED give the monitor
+ * latency on a scope, without the pipeline before the LTDC. The AVI
+ * InfoFrame content type alternates between none and Game, each flash is
+ * traced with the content type in use.
+ */
+int32_t DISP_LATENCY_Init(const DISP_LATENCY_Conf_t *conf);
+void DISP_LATENCY_Process(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DISP_LATENCY_H */
@@ -0,0 +1,72 @@
+ /**
+ ******************************************************************************
+ * @file    fb_alloc.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef FB_ALLOC_H
+#define FB_ALLOC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* Buffers allocated at the same time */
+#define FB_ALLOC_BUFFER_NB       8U
+#define FB_ALLOC_ALIGN           32U
+
+/* Access pattern: who reads and writes the buffer */
+#define FB_ALLOC_ACCESS_SCANOUT  (1U << 0)  /*!< Read by the LTDC every refresh */
+#define FB_ALLOC_ACCESS_CAPTURE  (1U << 1)  /*!< Written by the DCMIPP every camera frame */
+#define FB_ALLOC_ACCESS_CPU      (1U << 2)  /*!< Drawn by the CPU or the DMA2D, through the D-cache */
+
+#define FB_ALLOC_ERROR_NONE       0
+#define FB_ALLOC_ERROR_PARAM     -1
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t internal_free;    /*!< Bytes left in the AXISRAM pools */
+  uint32_t internal_largest; /*!< Largest buffer the AXISRAM pools can still hold */
+  uint32_t external_free;    /*!< Bytes left in the PSRAM pool */
+  uint32_t buffers;          /*!< Buffers allocated */
+} FB_ALLOC_Stats_t;
+
+/* Exported functions ------------------------------------------------------- */
+/*
+ * Framebuffers out of the AXISRAM2..6 banks and the PSRAM, what the linker
+ * script leaves of each. Contiguous banks form a single pool. Buffers read or
+ * written by the display and camera go to the AXISRAM if they fit, other
+ * buffers to the PSRAM first. The PSRAM must be memory mapped before use.
+ * Each buffer gets an MPU region: non-cacheable without CPU access,
+ * write-through if shared between the CPU and a DMA master, write-back else.
+ */
+void FB_ALLOC_Init(void);
+void *FB_ALLOC_Alloc(uint32_t size, uint32_t access);
+void *FB_ALLOC_Realloc(void *buffer, uint32_t size, uint32_t access);
+int32_t FB_ALLOC_Free(void *buffer);
+int FB_ALLOC_IsExternal(const void *buffer);
+void FB_ALLOC_GetStats(FB_ALLOC_Stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FB_ALLOC_H */
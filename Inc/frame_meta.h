@@ -0,0 +1,94 @@
+ /**
+ ******************************************************************************
+ * @file    frame_meta.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef FRAME_META_H
+#define FRAME_META_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32n6xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Records kept, power of two */
+#define FRAME_META_NB              16U
+
+#define FRAME_META_FLAG_COMPLETE   (1U << 0)  /*!< Capture end seen */
+#define FRAME_META_FLAG_PRESENTED  (1U << 1)  /*!< Complete at the start of a refresh */
+#define FRAME_META_FLAG_DROPPED    (1U << 2)  /*!< Superseded or aborted before a refresh started */
+#define FRAME_META_FLAG_REPEATED   (1U << 3)  /*!< Scanned out on more than one refresh */
+#define FRAME_META_FLAG_SEQ_GAP    (1U << 4)  /*!< DCMIPP counted frames not seen before this one */
+
+#define FRAME_META_ERROR_NONE       0
+#define FRAME_META_ERROR_NOT_FOUND -1
+#define FRAME_META_ERROR_SCANLINE  -2
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t sequence;       /*!< DCMIPP frame counter at capture end */
+  uint32_t capture_start;  /*!< DWT cycles at camera vsync */
+  uint32_t capture_end;    /*!< DWT cycles at camera frame end */
+  uint32_t presented;      /*!< DWT cycles at the vblank starting its first scanout */
+  int32_t exposure;        /*!< Sensor exposure programmed at capture start, -1 if unknown */
+  int32_t gain;            /*!< Sensor gain programmed at capture start, -1 if unknown */
+  uint16_t flags;          /*!< FRAME_META_FLAG_xxx */
+  uint16_t repeats;        /*!< Extra refreshes showing this frame */
+} FRAME_META_Record_t;
+
+typedef struct
+{
+  uint32_t captured;       /*!< Frames fully captured */
+  uint32_t presented;      /*!< Frames complete at the start of a refresh */
+  uint32_t dropped;        /*!< Frames superseded before a refresh started */
+  uint32_t repeated;       /*!< Refreshes without a new frame */
+  uint32_t missing;        /*!< Frames counted by DCMIPP but not seen by the application */
+} FRAME_META_Stats_t;
+
+/* Exported functions ------------------------------------------------------- */
+/*
+ * One record per frame captured in the display buffer, filled from the camera
+ * vsync and frame end events and from a vblank scanline job. Records are
+ * looked up by sequence number; FRAME_META_GetDisplayed() describes the
+ * frame last completed before the current scanout started.
+ *
+ * The camera writes into the buffer the LTDC scans out, there is no buffer
+ * swap: events are accounted at vblank only. "Presented" means a frame was
+ * complete at the start of a refresh; the next capture may already overwrite
+ * lines ahead of the scanout, so a presented frame can be shown torn. "Dropped"
+ * means a newer frame was complete (or the capture was aborted) before the
+ * next refresh started; parts of it may still have been scanned out. Tearing
+ * is not detected.
+ */
+int32_t FRAME_META_Init(DCMIPP_HandleTypeDef *hdcmipp, uint32_t pipe, uint32_t vblank_line);
+void FRAME_META_OnPipeRestart(void);
+void FRAME_META_SetSensor(int32_t exposure, int32_t gain);
+void FRAME_META_OnCaptureStart(void);
+void FRAME_META_OnCaptureEnd(void);
+int32_t FRAME_META_Get(uint32_t sequence, FRAME_META_Record_t *record);
+int32_t FRAME_META_GetDisplayed(FRAME_META_Record_t *record);
+void FRAME_META_GetStats(FRAME_META_Stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FRAME_META_H */
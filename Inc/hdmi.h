@@ -23,8 +23,65 @@ extern "C" {
 
 #include <stdint.h>
 
+/* Bring-up states, reported in the trace and by HDMI_Process() */
+#define HDMI_STATE_ABSENT      0
+#define HDMI_STATE_DETECTED    1
+#define HDMI_STATE_WAIT_HPD    2
+#define HDMI_STATE_PLUGGED     3
+#define HDMI_STATE_POWERED     4
+#define HDMI_STATE_CONFIGURED  5
+
+/* Causes of a link loss, in the trace */
+#define HDMI_CAUSE_HPD         1   /* Monitor unplugged or power-cycled */
+#define HDMI_CAUSE_SENSE       2   /* Monitor TMDS receiver not sensed (standby) */
+#define HDMI_CAUSE_PLL         3   /* TMDS PLL unlocked */
+#define HDMI_CAUSE_CHIP_RESET  4   /* Transmitter found powered down */
+
+/* AVI InfoFrame content type: none, or IT content of the given type */
+#define HDMI_CONTENT_NONE      0
+#define HDMI_CONTENT_GRAPHICS  1
+#define HDMI_CONTENT_PHOTO     2
+#define HDMI_CONTENT_CINEMA    3
+#define HDMI_CONTENT_GAME      4
+
+/* Output video format. HDMI mode for CEA formats (VIC) and monitors with the
+ * HDMI VSDB in the CEA-861 extension of their EDID, DVI mode otherwise. The
+ * RGB range is the one requested for monitors with the range selectable (QS
+ * in their VCDB), the default range of the format otherwise */
+typedef struct
+{
+  uint8_t vic;           /* CEA-861 video identification code, 0 for none */
+  uint8_t aspect_16_9;   /* Picture aspect ratio 16:9, 4:3 otherwise */
+  uint8_t pixel_repeat;  /* Times each LTDC pixel is sent: 1, 2 or 4 */
+  uint8_t full_range;    /* RGB 0-255 from the LTDC, sent as 16-235 if limited */
+  uint8_t content;       /* HDMI_CONTENT_xxx */
+} HDMI_Video_t;
+
+/* Link health counters, see HDMI_GetHealth() */
+typedef struct
+{
+  uint32_t checks;
+  uint32_t hpd_losses;
+  uint32_t sense_losses;
+  uint32_t pll_unlocks;
+  uint32_t chip_resets;
+  uint32_t i2c_errors;
+  uint32_t recoveries;
+  uint32_t last_recovery_ms;  /* Loss to link configured again */
+  uint32_t max_check_us;      /* Longest health check, reads queued to done */
+} HDMI_Health_t;
+
 int32_t HDMI_Detect(void);
 void HDMI_Init(void);
+void HDMI_SetVideo(const HDMI_Video_t *video);
+void HDMI_SetContentType(uint8_t content);
+int HDMI_IsHdmiMode(void);
+void HDMI_Start(void);
+void HDMI_Resume(void);
+int32_t HDMI_Process(void);
+int32_t HDMI_GetState(void);
+uint32_t HDMI_GetEdidHash(void);
+void HDMI_GetHealth(HDMI_Health_t *health);
 
 #ifdef __cplusplus
 }
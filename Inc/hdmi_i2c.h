@@ -0,0 +1,84 @@
+ /**
+ ******************************************************************************
+ * @file    hdmi_i2c.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef HDMI_I2C_H
+#define HDMI_I2C_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+#define HDMI_I2C_SPEED_STANDARD     100000U
+#define HDMI_I2C_SPEED_FAST         400000U
+#define HDMI_I2C_SPEED_FAST_PLUS   1000000U
+
+/* Longest transfers: writes are copied in the queue, reads go to the caller */
+#define HDMI_I2C_WRITE_MAX    16U
+#define HDMI_I2C_READ_MAX    128U
+/* Transfers queued, at most */
+#define HDMI_I2C_OP_NB        32U
+
+#define HDMI_I2C_ERROR_NONE    0
+#define HDMI_I2C_ERROR_BUS    -1   /*!< NACK, arbitration lost or timeout: queue flushed */
+#define HDMI_I2C_ERROR_BUSY   -2   /*!< Transfers still queued */
+#define HDMI_I2C_ERROR_FULL   -3
+#define HDMI_I2C_ERROR_PARAM  -4
+#define HDMI_I2C_ERROR_HAL    -5
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t transfers;     /*!< I2C transfers completed, read-modify-write counts 2 */
+  uint32_t bytes;         /*!< Register bytes read or written */
+  uint32_t merged;        /*!< Writes and updates folded into the previous queued one */
+  uint32_t errors;        /*!< Transfers failed or timed out */
+  uint32_t max_queued;    /*!< Most transfers waiting at once */
+  uint32_t idle_cycles;   /*!< DWT->CYCCNT when the queue last emptied */
+} HDMI_I2C_Stats_t;
+
+/* Exported functions ------------------------------------------------------- */
+/*
+ * ADV7513 transport on the BSP I2C2 bus: register transfers are queued and
+ * run back to back by DMA, from the I2C and DMA interrupts. Writes to
+ * consecutive registers are sent as one transfer. A failed transfer flushes
+ * the queue: later transfers usually depend on it.
+ *
+ * HDMI_I2C_Write/Update/Read() never wait; read data is valid once
+ * HDMI_I2C_Poll() no longer returns HDMI_I2C_ERROR_BUSY. Poll() returns the
+ * first error since the previous call.
+ */
+int32_t HDMI_I2C_Init(uint32_t speed_hz);
+void HDMI_I2C_DeInit(void);
+uint32_t HDMI_I2C_GetSpeed(void);
+int32_t HDMI_I2C_Write(uint16_t dev, uint8_t reg, const uint8_t *data, uint16_t size);
+int32_t HDMI_I2C_Update(uint16_t dev, uint8_t reg, uint8_t value, uint8_t mask);
+int32_t HDMI_I2C_Read(uint16_t dev, uint8_t reg, uint8_t *data, uint16_t size);
+int32_t HDMI_I2C_Poll(void);
+int32_t HDMI_I2C_Sync(void);
+void HDMI_I2C_GetStats(HDMI_I2C_Stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HDMI_I2C_H */
@@ -0,0 +1,63 @@
+ /**
+ ******************************************************************************
+ * @file    hud.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef HUD_H
+#define HUD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "perf_mon.h"
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+#define HUD_LINE_NB       5U
+/* Characters per line: 320 pixels wide overlay, Font20 */
+#define HUD_LINE_CHARS    22U
+
+#define HUD_ERROR_NONE       0
+#define HUD_ERROR_SCANLINE  -1
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t first_line;       /*!< Overlay text line of the first HUD line */
+  uint32_t vblank_line;      /*!< First vertical blanking line, see SCANLINE_VBLANK() */
+  uint32_t display_bytes;    /*!< PSRAM bytes scanned out per refresh, all layers */
+  uint32_t camera_bytes;     /*!< PSRAM bytes written per captured frame */
+} HUD_Conf_t;
+
+/* Exported functions ------------------------------------------------------- */
+/*
+ * Performance HUD drawn with the current UTIL_LCD layer and font. Values are
+ * measured between two updates; only the characters that changed are redrawn.
+ * The application reads the PMU region counters once per period and passes
+ * them to HUD_Process().
+ */
+int32_t HUD_Init(const HUD_Conf_t *conf);
+void HUD_SetVisible(int visible);
+void HUD_Process(const PERF_MON_Stats_t *pmu);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HUD_H */
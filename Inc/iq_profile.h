@@ -0,0 +1,78 @@
+ /**
+ ******************************************************************************
+ * @file    iq_profile.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef IQ_PROFILE_H
+#define IQ_PROFILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+#define IQ_PROFILE_MAGIC        0x46505149U  /* "IQPF" */
+#define IQ_PROFILE_VERSION      1
+#define IQ_PROFILE_NAME_LEN     16
+
+/* Index in ISP_IQParamCacheInit[] (see isp_param_conf.h) */
+#define IQ_PROFILE_TABLE_IMX335  0
+#define IQ_PROFILE_TABLE_VD66GY  1
+#define IQ_PROFILE_TABLE_NB      2
+#define IQ_PROFILE_TABLE_NONE   -1
+
+/* Profile index used when nothing was selected */
+#define IQ_PROFILE_BUILTIN      -1
+
+#define IQ_PROFILE_ERROR_NONE    0
+#define IQ_PROFILE_ERROR_NVM    -1
+#define IQ_PROFILE_ERROR_FORMAT -2  /*!< Bad magic, version, layout or CRC */
+#define IQ_PROFILE_ERROR_BUSY   -3  /*!< A switch is already pending */
+#define IQ_PROFILE_ERROR_PARAM  -4
+
+/* Exported types ------------------------------------------------------------*/
+/*
+ * Profile image layout in NOR, little endian, as produced by
+ * Utilities/iq_profile/iq_profile.py:
+ *   IQ_PROFILE_Header_t
+ *   ISP_IQParamTypeDef[count], in ISP_IQParamCacheInit[] order
+ */
+typedef struct
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t count;        /*!< Number of ISP_IQParamTypeDef tables */
+  uint32_t param_size;   /*!< sizeof(ISP_IQParamTypeDef) on the generator side */
+  char name[IQ_PROFILE_NAME_LEN];
+  uint32_t crc;          /*!< CRC-32 of the tables */
+} IQ_PROFILE_Header_t;
+
+/* Exported functions ------------------------------------------------------- */
+int32_t IQ_PROFILE_Init(int32_t profile);
+int32_t IQ_PROFILE_Select(int32_t profile, int32_t table);
+void IQ_PROFILE_OnFrameStart(void);
+int32_t IQ_PROFILE_GetCurrent(void);
+const char *IQ_PROFILE_GetName(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IQ_PROFILE_H */
@@ -25,5 +25,7 @@
 
 #define ISP_MW_SW_AEC_ALGO_SUPPORT
 #define ISP_MW_SW_AWB_ALGO_SUPPORT
+/* IQ tuning tool served over the ST-LINK virtual COM port (isp_tool_uart.c) */
+#define ISP_MW_TUNING_TOOL_SUPPORT
 
 #endif /* __ISP_CONF_H */
@@ -197,9 +197,13 @@ static const ISP_IQParamTypeDef ISP_IQParamCacheInit_VD66GY = {
     },
 };
 
+/* Tables above are the built-in defaults. The ISP is initialized from their
+ * RAM copies which IQ_PROFILE_Init() may replace by a profile stored in NOR */
+extern ISP_IQParamTypeDef iq_profile_active[];
+
 static const ISP_IQParamTypeDef* ISP_IQParamCacheInit[] = {
-    &ISP_IQParamCacheInit_IMX335,
-    &ISP_IQParamCacheInit_VD66GY
+    &iq_profile_active[0], /* IMX335 */
+    &iq_profile_active[1]  /* VD66GY */
 };
 
 #endif /* __ISP_PARAM_CONF__H */
@@ -0,0 +1,66 @@
+ /**
+ ******************************************************************************
+ * @file    isp_sched.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef ISP_SCHED_H
+#define ISP_SCHED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t period_converging; /*!< Frames between ISP runs while AE/AWB converge */
+  uint32_t period_stable;     /*!< Frames between ISP runs once the scene is stable */
+  uint32_t stable_runs;       /*!< Consecutive runs without sensor change to declare stable */
+  uint32_t budget_us;         /*!< Average ISP CPU time allowed per frame, 0 = unbounded */
+} ISP_SCHED_Conf_t;
+
+typedef struct
+{
+  uint32_t frames;       /*!< Frames seen by the scheduler */
+  uint32_t runs;         /*!< ISP runs (AE + AWB) */
+  uint32_t budget_skips; /*!< Runs deferred because the CPU budget was exhausted */
+  uint32_t last_us;      /*!< Duration of the last run */
+  uint32_t max_us;       /*!< Longest run */
+  uint32_t avg_converging_us; /*!< Average run time while converging */
+  uint32_t avg_stable_us;     /*!< Average run time while stable */
+  uint32_t converging;   /*!< 1 while exposure/gain are still moving */
+  uint32_t held;         /*!< 1 while ISP runs are suspended (no AE/AWB) */
+  int32_t exposure;      /*!< Sensor exposure after the last run, -1 if unknown */
+  int32_t gain;          /*!< Sensor gain after the last run, -1 if unknown */
+} ISP_SCHED_Stats_t;
+
+/* Exported functions ------------------------------------------------------- */
+void ISP_SCHED_Init(const ISP_SCHED_Conf_t *conf);
+int32_t ISP_SCHED_OnFrame(void);
+void ISP_SCHED_Wake(void);
+void ISP_SCHED_Kick(void);
+void ISP_SCHED_Hold(int hold);
+void ISP_SCHED_GetStats(ISP_SCHED_Stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ISP_SCHED_H */
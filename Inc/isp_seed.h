@@ -0,0 +1,51 @@
+ /**
+ ******************************************************************************
+ * @file    isp_seed.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef ISP_SEED_H
+#define ISP_SEED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t seeded;          /*!< 1 if a stored state was applied at start */
+  uint32_t converged;       /*!< 1 once AE reached a stable state */
+  uint32_t convergence_ms;  /*!< Camera start to first stable AE */
+  uint32_t convergence_frames;
+  int32_t exposure;
+  int32_t gain;
+  uint32_t color_temp;
+} ISP_SEED_Status_t;
+
+/* Exported functions ------------------------------------------------------- */
+void ISP_SEED_Apply(uint32_t sensor_id);
+void ISP_SEED_Process(int converging);
+void ISP_SEED_GetStatus(ISP_SEED_Status_t *status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ISP_SEED_H */
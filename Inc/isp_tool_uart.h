@@ -0,0 +1,72 @@
+ /**
+ ******************************************************************************
+ * @file    isp_tool_uart.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef ISP_TOOL_UART_H
+#define ISP_TOOL_UART_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* Must match the COM port settings of the tuning tool */
+#define ISP_TOOL_UART_BAUDRATE      921600
+/* Largest command, ended by an idle line */
+#define ISP_TOOL_UART_CMD_MAX       1024
+
+#define ISP_TOOL_UART_ERROR_NONE    0
+#define ISP_TOOL_UART_ERROR_HAL    -1
+#define ISP_TOOL_UART_ERROR_FULL   -2
+#define ISP_TOOL_UART_ERROR_PARAM  -3
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t rx_bytes;      /*!< Bytes received on the line */
+  uint32_t rx_overruns;   /*!< Bytes lost: RX ring full or UART overrun */
+  uint32_t frame_errors;  /*!< Commands dropped: oversized or bytes lost */
+  uint32_t commands;      /*!< Commands handed to the ISP command parser */
+  uint32_t tx_bytes;      /*!< Bytes sent */
+  uint32_t tx_drops;      /*!< Replies dropped because the TX queue was full */
+} ISP_TOOL_UART_Stats_t;
+
+/* Exported functions ------------------------------------------------------- */
+/*
+ * Transport of the ISP IQ tuning tool protocol over the ST-LINK virtual COM
+ * port, with the bytes of the USB link unchanged: each command is the block
+ * of bytes the tool writes at once, ended by an idle line, and replies are
+ * sent raw. Reception and emission are DMA driven into ring buffers, so that
+ * neither the interrupts nor the ISP background process ever wait for the
+ * line. The ISP core pulls commands through ISP_ToolCom_xxx() from
+ * CMW_CAMERA_Run(), one command per run. printf output is dropped: the
+ * port only carries the tool stream.
+ */
+int32_t ISP_TOOL_UART_Init(void);
+int ISP_TOOL_UART_Process(void);
+int32_t ISP_TOOL_UART_Send(const uint8_t *data, uint32_t size);
+void ISP_TOOL_UART_GetStats(ISP_TOOL_UART_Stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ISP_TOOL_UART_H */
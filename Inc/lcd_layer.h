@@ -0,0 +1,62 @@
+ /**
+ ******************************************************************************
+ * @file    lcd_layer.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef LCD_LAYER_H
+#define LCD_LAYER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32n6xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define LCD_LAYER_ERROR_NONE   0
+#define LCD_LAYER_ERROR_BUSY  -1  /*!< Previous commit not yet latched by LTDC */
+#define LCD_LAYER_ERROR_HAL   -2
+
+/* Exported functions ------------------------------------------------------- */
+/*
+ * Layer transactions: the setters below only stage values. LCD_LAYER_Commit()
+ * writes every staged field to the LTDC shadow registers and requests a single
+ * vertical blanking reload so that all of them reach the scanout on the same
+ * frame. Layer index is LTDC_LAYER_1 or LTDC_LAYER_2.
+ */
+void LCD_LAYER_Init(LTDC_HandleTypeDef *hltdc);
+void LCD_LAYER_SetAddress(uint32_t layer, uint32_t address);
+void LCD_LAYER_SetPitch(uint32_t layer, uint32_t pitch_in_pixels);
+void LCD_LAYER_SetWindow(uint32_t layer, uint32_t x0, uint32_t y0, uint32_t width, uint32_t height);
+void LCD_LAYER_SetPosition(uint32_t layer, uint32_t x0, uint32_t y0);
+void LCD_LAYER_SetAlpha(uint32_t layer, uint8_t alpha);
+void LCD_LAYER_SetColorKey(uint32_t layer, int enable, uint32_t rgb888);
+void LCD_LAYER_SetEnable(uint32_t layer, int enable);
+void LCD_LAYER_Abort(void);
+int32_t LCD_LAYER_Commit(void);
+int LCD_LAYER_IsCommitPending(void);
+void LCD_LAYER_WaitCommit(void);
+uint32_t LCD_LAYER_GetCommitCount(void);
+uint32_t LCD_LAYER_GetUnderruns(void);
+void LCD_LAYER_RearmUnderrun(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LCD_LAYER_H */
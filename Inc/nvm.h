@@ -0,0 +1,61 @@
+ /**
+ ******************************************************************************
+ * @file    nvm.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef NVM_H
+#define NVM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* Records stored in the last megabyte of the MX66UW1G45G octo-SPI NOR, far
+ * from the FSBL (offset 0) and application (offset 1MB) images */
+#define NVM_SLOT_ISP_STATE     0  /*!< Last converged AE/AWB state */
+#define NVM_SLOT_BOOT_CONF     1  /*!< Last-known-good display and sensor configuration */
+#define NVM_SLOT_PSRAM_CLOCK   2  /*!< Tuned PSRAM XSPI clock */
+#define NVM_SLOT_NB            3
+
+/* IQ profiles written by Utilities/iq_profile, outside of the record slots.
+ * Memory mapped address for STM32_Programmer_CLI is 0x70000000 + offset. */
+#define NVM_IQ_PROFILE_OFFSET(n)  (0x07F10000U + (n) * NVM_IQ_PROFILE_SIZE)
+#define NVM_IQ_PROFILE_SIZE       0x2000U
+#define NVM_IQ_PROFILE_NB         8
+
+#define NVM_ERROR_NONE          0
+#define NVM_ERROR_BSP          -1
+#define NVM_ERROR_EMPTY        -2  /*!< No valid record (erased, corrupted or other version) */
+#define NVM_ERROR_PARAM        -3
+
+/* Exported functions ------------------------------------------------------- */
+int32_t NVM_Init(void);
+int32_t NVM_Read(uint32_t slot, uint32_t version, void *data, uint32_t size);
+int32_t NVM_Write(uint32_t slot, uint32_t version, const void *data, uint32_t size);
+int32_t NVM_Erase(uint32_t slot);
+int32_t NVM_ReadRaw(uint32_t offset, void *data, uint32_t size);
+uint32_t NVM_Crc32(uint32_t crc, const void *data, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NVM_H */
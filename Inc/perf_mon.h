@@ -0,0 +1,66 @@
+ /**
+ ******************************************************************************
+ * @file    perf_mon.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PERF_MON_H
+#define PERF_MON_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* Tagged code regions */
+#define PERF_MON_REGION_ISP         0U  /*!< CMW_CAMERA_Run() */
+#define PERF_MON_REGION_OVERLAY     1U  /*!< Overlay text drawing */
+#define PERF_MON_REGION_ISR_DCMIPP  2U  /*!< DCMIPP interrupt */
+#define PERF_MON_REGION_ISR_LTDC    3U  /*!< LTDC interrupt */
+#define PERF_MON_REGION_NB          4U
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t runs;
+  uint32_t cycles;         /*!< Total over the runs, interrupts included */
+  uint32_t max_cycles;     /*!< Longest run */
+  uint32_t instructions;   /*!< Instructions retired */
+  uint32_t dcache_misses;  /*!< L1 D-cache refills */
+  uint32_t stalls;         /*!< Cycles the backend stalled, mostly on memory */
+  uint32_t bus_accesses;   /*!< AXI/AHB accesses (cache line fills, non cacheable) */
+} PERF_MON_Stats_t;
+
+/* Exported functions ------------------------------------------------------- */
+/*
+ * Cortex-M55 PMU counters sampled at region entry and exit. Counters are
+ * free running: an interrupt taken inside a region is accounted to it too.
+ * A region must not be entered again before it is left.
+ */
+void PERF_MON_Init(void);
+void PERF_MON_Begin(uint32_t region);
+void PERF_MON_End(uint32_t region);
+void PERF_MON_GetStats(uint32_t region, PERF_MON_Stats_t *stats, int reset);
+void PERF_MON_Trace(uint32_t region, const PERF_MON_Stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PERF_MON_H */
@@ -0,0 +1,84 @@
+ /**
+ ******************************************************************************
+ * @file    psram_tune.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PSRAM_TUNE_H
+#define PSRAM_TUNE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* Build with PSRAM_TUNE=1 to benchmark the PSRAM at boot and search the
+ * XSPI1 kernel clock, saved in NOR. Other builds apply the saved clock
+ * (PSRAM_TUNE_Apply). */
+#ifndef PSRAM_TUNE
+#define PSRAM_TUNE              0
+#endif
+
+/* Clocks above the 200 MHz APS256XX rating are only searched and applied in
+ * builds with PSRAM_TUNE_OVERCLOCK=1. They keep the latency codes of
+ * aps256xx_conf.h, rated for 200 MHz: at the user's own risk, per board. */
+#ifndef PSRAM_TUNE_OVERCLOCK
+#define PSRAM_TUNE_OVERCLOCK    0
+#endif
+
+/* Scratch area at the top of the PSRAM: only used before anything else is
+ * placed in PSRAM, its content is destroyed */
+#define PSRAM_TUNE_AREA         0x91E00000U
+#define PSRAM_TUNE_AREA_SIZE    0x00200000U
+/* Bytes between accesses of the strided benchmark */
+#define PSRAM_TUNE_STRIDE       256U
+
+#define PSRAM_TUNE_ERROR_NONE      0
+#define PSRAM_TUNE_ERROR_BSP      -1
+#define PSRAM_TUNE_ERROR_PATTERN  -2  /*!< Data read back differs from data written */
+#define PSRAM_TUNE_ERROR_EMPTY    -3  /*!< No tuned clock saved */
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t seq_read_mbps;      /*!< Sequential reads, as the LTDC scanout */
+  uint32_t seq_write_mbps;     /*!< Sequential writes, cache write-back included */
+  uint32_t stride_read_mbps;   /*!< One cache line every PSRAM_TUNE_STRIDE bytes, lines fetched */
+  uint32_t stride_write_mbps;  /*!< Same, lines written back */
+  uint32_t latency_ns;         /*!< Dependent cache line misses */
+} PSRAM_TUNE_Bench_t;
+
+typedef struct
+{
+  uint32_t clock_hz;           /*!< XSPI1 kernel clock */
+  PSRAM_TUNE_Bench_t idle;     /*!< CPU alone on the PSRAM */
+  PSRAM_TUNE_Bench_t loaded;   /*!< DMA2D copying within the PSRAM meanwhile */
+} PSRAM_TUNE_Result_t;
+
+/* Exported functions ------------------------------------------------------- */
+int32_t PSRAM_TUNE_Bench(int dma_load, PSRAM_TUNE_Bench_t *bench);
+int32_t PSRAM_TUNE_Run(PSRAM_TUNE_Result_t *baseline, PSRAM_TUNE_Result_t *best);
+int32_t PSRAM_TUNE_Apply(void);
+uint32_t PSRAM_TUNE_GetClock(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PSRAM_TUNE_H */
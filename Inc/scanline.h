@@ -0,0 +1,71 @@
+ /**
+ ******************************************************************************
+ * @file    scanline.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef SCANLINE_H
+#define SCANLINE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32n6xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define SCANLINE_MAX_JOBS       8
+
+#define SCANLINE_ERROR_NONE     0
+#define SCANLINE_ERROR_FULL    -1
+#define SCANLINE_ERROR_PARAM   -2
+
+/* Exported types ------------------------------------------------------------*/
+typedef void (*SCANLINE_Callback_t)(void *arg);
+
+typedef struct
+{
+  uint32_t runs;        /*!< Number of times the callback was executed */
+  uint32_t misses;      /*!< Runs that completed after line + budget */
+  uint32_t late_starts; /*!< Runs that started after line + budget */
+  uint32_t max_lines;   /*!< Longest observed run, in scanlines */
+} SCANLINE_Stats_t;
+
+/* Exported macro ------------------------------------------------------------*/
+/* First line of the vertical blanking, in active area line coordinates */
+#define SCANLINE_VBLANK(active_height)  (active_height)
+
+/* Exported functions ------------------------------------------------------- */
+/*
+ * Lines are expressed in active area coordinates: 0 is the first displayed
+ * line, lines >= active height are in vertical blanking (front porch, sync,
+ * back porch) up to SCANLINE_GetTotalLines() - 1.
+ */
+int32_t SCANLINE_Init(LTDC_HandleTypeDef *hltdc);
+int32_t SCANLINE_Add(uint32_t line, uint32_t budget_lines, int periodic, SCANLINE_Callback_t cb, void *arg);
+int32_t SCANLINE_Remove(int32_t job);
+int32_t SCANLINE_GetStats(int32_t job, SCANLINE_Stats_t *stats);
+uint32_t SCANLINE_GetMisses(void);
+uint32_t SCANLINE_GetCurrentLine(void);
+uint32_t SCANLINE_GetTotalLines(void);
+uint32_t SCANLINE_GetRefreshMilliHz(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SCANLINE_H */
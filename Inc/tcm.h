@@ -0,0 +1,58 @@
+ /**
+ ******************************************************************************
+ * @file    tcm.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TCM_H
+#define TCM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* Function run from ITCM. Whole modules are placed by the linker scripts. */
+#define TCM_CODE                __attribute__ ((section (".itcm_text"))) __attribute__ ((noinline))
+
+/* Interrupts taken per latency measurement */
+#define TCM_LATENCY_RUNS        256U
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t min_cycles;
+  uint32_t avg_cycles;
+  uint32_t max_cycles;
+} TCM_Latency_t;
+
+/* Exported functions ------------------------------------------------------- */
+/*
+ * ITCM holds the interrupt hot paths and the ISP algorithms, DTCM the main
+ * stack (see the linker scripts). TCM_Init() copies the ITCM code: call it
+ * first in main(), before any interrupt is enabled.
+ */
+void TCM_Init(void);
+void TCM_MeasureLatency(TCM_Latency_t *itcm, TCM_Latency_t *axisram);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TCM_H */
@@ -0,0 +1,107 @@
+ /**
+ ******************************************************************************
+ * @file    trace.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TRACE_H
+#define TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* Records kept in RAM, power of two */
+#define TRACE_RECORD_NB         1024U
+
+/* Drain sinks */
+#define TRACE_SINK_NONE         0  /*!< Kept in RAM, read with the debugger */
+#define TRACE_SINK_SWO          1  /*!< ITM stimulus port TRACE_ITM_PORT */
+#define TRACE_SINK_UART         2  /*!< Virtual COM port, shared with the ISP tuning tool */
+
+#ifndef TRACE_SINK
+#define TRACE_SINK              TRACE_SINK_SWO
+#endif
+#define TRACE_ITM_PORT          1U
+
+/* Drained packet: magic, record count (16-bit), records lost before this
+ * packet (16-bit), index of the first record, records */
+#define TRACE_PACKET_MAGIC      0x45435254U /* "TRCE" */
+#define TRACE_PACKET_MAX        32U
+
+/* Events, arg is 24-bit */
+#define TRACE_EVT_CAM_VSYNC        0x01U  /*!< DCMIPP frame start, arg: pipe */
+#define TRACE_EVT_CAM_FRAME        0x02U  /*!< DCMIPP frame end, arg: pipe */
+#define TRACE_EVT_CSI_ERROR        0x03U  /*!< CSI error interrupt, arg: CSI SR1 */
+#define TRACE_EVT_CAM_RESTART      0x04U  /*!< Sensor and pipe restarted, arg: cause << 16 | restarts */
+#define TRACE_EVT_CAM_RECOVERED    0x05U  /*!< First frame after a restart, arg: outage in ms */
+#define TRACE_EVT_LTDC_RELOAD      0x10U  /*!< Shadow registers latched at vblank */
+#define TRACE_EVT_LTDC_LINE        0x11U  /*!< Line event, arg: line counter */
+#define TRACE_EVT_FRAME_PRESENT    0x12U  /*!< First scanout of a frame, arg: sequence */
+#define TRACE_EVT_LTDC_UNDERRUN    0x13U  /*!< FIFO underrun, arg: underrun count */
+#define TRACE_EVT_ISP_RUN_START    0x20U  /*!< CMW_CAMERA_Run() entry */
+#define TRACE_EVT_ISP_RUN_END      0x21U  /*!< CMW_CAMERA_Run() exit, arg: status */
+#define TRACE_EVT_HDMI_STATE       0x30U  /*!< arg: HDMI_STATE_xxx */
+#define TRACE_EVT_HDMI_LINK_LOST   0x31U  /*!< arg: HDMI_CAUSE_xxx */
+#define TRACE_EVT_HDMI_RECOVERED   0x32U  /*!< arg: HDMI_CAUSE_xxx << 20 | time to recover in ms */
+#define TRACE_EVT_BOOT_PHASE       0x38U  /*!< arg: phase << 20 | time from main() in 10 us */
+/* PMU report of one region (see perf_mon.h), values are averages per run */
+#define TRACE_EVT_PMU_REGION       0x40U  /*!< arg: region << 16 | runs */
+#define TRACE_EVT_PMU_CYCLES       0x41U
+#define TRACE_EVT_PMU_INSTR        0x42U
+#define TRACE_EVT_PMU_DCACHE_MISS  0x43U
+#define TRACE_EVT_PMU_STALL        0x44U
+#define TRACE_EVT_PMU_BUS          0x45U
+#define TRACE_EVT_PSRAM_BENCH      0x50U  /*!< arg: XSPI1 clock MHz << 12 | sequential read MB/s under DMA load */
+#define TRACE_EVT_IRQ_LATENCY      0x58U  /*!< arg: handler in AXISRAM << 22 | max << 11 | average, in cycles */
+#define TRACE_EVT_BUS_ARB          0x5CU  /*!< Underruns with the camera writing, arg: preset << 16 | underruns */
+#define TRACE_EVT_DISP_LATENCY     0x60U  /*!< Flash scanned out, arg: HDMI content << 16 | white << 15 | flash */
+#define TRACE_EVT_USER             0x80U  /*!< 0x80..0xff free for the application */
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t timestamp;  /*!< DWT cycle counter */
+  uint32_t event;      /*!< Event (bits 31..24) and argument (bits 23..0) */
+} TRACE_Record_t;
+
+typedef struct
+{
+  uint32_t recorded;
+  uint32_t drained;
+  uint32_t lost;       /*!< Overwritten before being drained */
+} TRACE_Stats_t;
+
+/* Exported functions ------------------------------------------------------- */
+/*
+ * TRACE_Record() is lock-free and may be called from any context, including
+ * interrupts. The ring keeps the most recent records; TRACE_Drain() sends
+ * them to the sink from the application loop.
+ */
+void TRACE_Init(void);
+void TRACE_Record(uint32_t event, uint32_t arg);
+uint32_t TRACE_Drain(uint32_t max_records);
+void TRACE_GetStats(TRACE_Stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRACE_H */
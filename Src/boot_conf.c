@@ -0,0 +1,107 @@
+ /**
+ ******************************************************************************
+ * @file    boot_conf.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "boot_conf.h"
+#include "nvm.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(DEBUG)
+#define PRINTF(...)    printf(__VA_ARGS__)
+#else
+#define PRINTF(...)
+#endif /* defined(DEBUG) */
+
+/* Private define ------------------------------------------------------------*/
+#define BOOT_CONF_VERSION   1
+
+/* Private variables ---------------------------------------------------------*/
+/* Content of the NOR record, to skip rewriting it unchanged */
+static BOOT_CONF_t boot_conf_stored;
+static int boot_conf_has_record;
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+  * @brief  Read the last-known-good configuration
+  * @param  conf Configuration saved by the previous successful boot
+  * @retval BOOT_CONF_ERROR_NONE or BOOT_CONF_ERROR_EMPTY
+  */
+int32_t BOOT_CONF_Load(BOOT_CONF_t *conf)
+{
+  boot_conf_has_record = NVM_Read(NVM_SLOT_BOOT_CONF, BOOT_CONF_VERSION, &boot_conf_stored,
+                                  sizeof(boot_conf_stored)) == NVM_ERROR_NONE;
+  if (!boot_conf_has_record)
+  {
+    PRINTF("No boot configuration stored, full detection\n");
+    return BOOT_CONF_ERROR_EMPTY;
+  }
+
+  *conf = boot_conf_stored;
+
+  return BOOT_CONF_ERROR_NONE;
+}
+
+/**
+  * @brief  Save the configuration of a verified boot
+  * @note   Blocking while the NOR sector is rewritten, only if it changed.
+  * @param  conf Configuration in use
+  * @retval BOOT_CONF_ERROR_NONE or BOOT_CONF_ERROR_NVM
+  */
+int32_t BOOT_CONF_Save(const BOOT_CONF_t *conf)
+{
+  int32_t ret;
+
+  if (boot_conf_has_record && memcmp(conf, &boot_conf_stored, sizeof(*conf)) == 0)
+  {
+    return BOOT_CONF_ERROR_NONE;
+  }
+
+  ret = NVM_Write(NVM_SLOT_BOOT_CONF, BOOT_CONF_VERSION, conf, sizeof(*conf));
+  PRINTF("Boot configuration saved (%ld)\n", (long) ret);
+  if (ret != NVM_ERROR_NONE)
+  {
+    return BOOT_CONF_ERROR_NVM;
+  }
+  boot_conf_stored = *conf;
+  boot_conf_has_record = 1;
+
+  return BOOT_CONF_ERROR_NONE;
+}
+
+/**
+  * @brief  Force full detection at next boot
+  * @retval BOOT_CONF_ERROR_NONE or BOOT_CONF_ERROR_NVM
+  */
+int32_t BOOT_CONF_Invalidate(void)
+{
+  boot_conf_has_record = 0;
+
+  return NVM_Erase(NVM_SLOT_BOOT_CONF) == NVM_ERROR_NONE ? BOOT_CONF_ERROR_NONE : BOOT_CONF_ERROR_NVM;
+}
+
+/**
+  * @brief  Same display output: a sensor mode chosen for one applies to the other
+  * @note   The monitor (EDID) is not compared, the output does not depend on it.
+  */
+int BOOT_CONF_IsSameDisplay(const BOOT_CONF_t *a, const BOOT_CONF_t *b)
+{
+  return a->is_hdmi == b->is_hdmi && a->width == b->width && a->height == b->height &&
+         a->pixel_clock_hz == b->pixel_clock_hz && a->refresh_mhz == b->refresh_mhz &&
+         a->layer_formats == b->layer_formats;
+}
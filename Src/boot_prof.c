@@ -0,0 +1,124 @@
+ /**
+ ******************************************************************************
+ * @file    boot_prof.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "boot_prof.h"
+#include "trace.h"
+#include "stm32n6xx_hal.h"
+#include <assert.h>
+
+/* Private define ------------------------------------------------------------*/
+/* Longer phases (e.g. waiting for a monitor) are measured with the tick, the
+ * cycle counter wraps after 5 s at 800 MHz */
+#define BOOT_PROF_TICK_MIN_MS   4000U
+
+/* Private variables ---------------------------------------------------------*/
+static const char *const boot_prof_names[BOOT_PROF_NB] = {
+  "hw", "nor", "hdmi", "lcd", "cam", "start", "hpd", "frame",
+};
+
+/* Elapsed time is accumulated at each mark: the core clock changes during
+ * boot, cycles are converted with the frequency of the previous mark */
+static uint32_t boot_prof_last_cycles;
+static uint32_t boot_prof_last_hz;
+static uint32_t boot_prof_last_tick;
+static uint32_t boot_prof_elapsed_us;
+static uint32_t boot_prof_us[BOOT_PROF_NB];
+
+/* Functions Definition ------------------------------------------------------*/
+void BOOT_PROF_Init(void)
+{
+  uint32_t i;
+
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  boot_prof_last_cycles = 0;
+  boot_prof_last_hz = SystemCoreClock;
+  boot_prof_last_tick = HAL_GetTick();
+  boot_prof_elapsed_us = 0;
+  for (i = 0; i < BOOT_PROF_NB; i++)
+  {
+    boot_prof_us[i] = 0;
+  }
+}
+
+/**
+  * @brief  Record the completion of a boot phase, first call only
+  * @param  phase BOOT_PROF_xxx
+  * @retval None
+  */
+void BOOT_PROF_Mark(uint32_t phase)
+{
+  uint32_t now = DWT->CYCCNT;
+  uint32_t tick = HAL_GetTick();
+
+  assert(phase < BOOT_PROF_NB);
+
+  if (tick - boot_prof_last_tick >= BOOT_PROF_TICK_MIN_MS)
+  {
+    boot_prof_elapsed_us += (tick - boot_prof_last_tick) * 1000U;
+  }
+  else
+  {
+    boot_prof_elapsed_us += (uint32_t)(((uint64_t)(now - boot_prof_last_cycles) * 1000000U) / boot_prof_last_hz);
+  }
+  boot_prof_last_cycles = now;
+  boot_prof_last_hz = SystemCoreClock;
+  boot_prof_last_tick = tick;
+
+  if (boot_prof_us[phase] == 0)
+  {
+    boot_prof_us[phase] = boot_prof_elapsed_us;
+  }
+}
+
+/**
+  * @brief  Time from main() to the end of a phase
+  * @retval Microseconds, 0 if the phase is not complete
+  */
+uint32_t BOOT_PROF_GetUs(uint32_t phase)
+{
+  assert(phase < BOOT_PROF_NB);
+
+  return boot_prof_us[phase];
+}
+
+const char *BOOT_PROF_GetName(uint32_t phase)
+{
+  assert(phase < BOOT_PROF_NB);
+
+  return boot_prof_names[phase];
+}
+
+/**
+  * @brief  Report completed phases in the trace, in units of 10 us
+  */
+void BOOT_PROF_Trace(void)
+{
+  uint32_t i;
+
+  for (i = 0; i < BOOT_PROF_NB; i++)
+  {
+    if (boot_prof_us[i] != 0)
+    {
+      TRACE_Record(TRACE_EVT_BOOT_PHASE, (i << 20) | ((boot_prof_us[i] / 10U) & 0xfffffU));
+    }
+  }
+}
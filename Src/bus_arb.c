@@ -0,0 +1,230 @@
+ /**
+ ******************************************************************************
+ * @file    bus_arb.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "bus_arb.h"
+#include "frame_meta.h"
+#include "lcd_layer.h"
+#include "trace.h"
+#include <stdio.h>
+
+#if defined(DEBUG)
+#define PRINTF(...)    printf(__VA_ARGS__)
+#else
+#define PRINTF(...)
+#endif /* defined(DEBUG) */
+
+/* Private define ------------------------------------------------------------*/
+/* Pipe 1 writes the display buffer through IP-Plug client 2 */
+#define BUS_ARB_DCMIPP_PIPE      DCMIPP_PIPE1
+#define BUS_ARB_DCMIPP_CLIENT    DCMIPP_CLIENT2
+/* Whole write FIFO for the client, single client arbitration */
+#define BUS_ARB_DCMIPP_DPREG_END 559U
+#define BUS_ARB_DCMIPP_WLRU      15U
+
+#define BUS_ARB_TRACE_MAX        0xffffU
+
+/* Private variables ---------------------------------------------------------*/
+static const BUS_ARB_Preset_t bus_arb_presets[BUS_ARB_PRESET_NB] = {
+  [BUS_ARB_PRESET_RELAXED] = {
+    .max_pixel_clock_hz = 40000000U,
+    .dcmipp_traffic = DCMIPP_TRAFFIC_BURST_SIZE_128BYTES,
+    .dcmipp_outstanding = DCMIPP_OUTSTANDING_TRANSACTION_NONE,
+    .dma2d_dead_time = 0,
+  },
+  [BUS_ARB_PRESET_BALANCED] = {
+    .max_pixel_clock_hz = 80000000U,
+    .dcmipp_traffic = DCMIPP_TRAFFIC_BURST_SIZE_128BYTES,
+    .dcmipp_outstanding = DCMIPP_OUTSTANDING_TRANSACTION_4,
+    .dma2d_dead_time = 16,
+  },
+  [BUS_ARB_PRESET_TIGHT] = {
+    .max_pixel_clock_hz = UINT32_MAX,
+    .dcmipp_traffic = DCMIPP_TRAFFIC_BURST_SIZE_64BYTES,
+    .dcmipp_outstanding = DCMIPP_OUTSTANDING_TRANSACTION_2,
+    .dma2d_dead_time = 64,
+  },
+};
+
+static DCMIPP_HandleTypeDef *bus_arb_hdcmipp;
+static BUS_ARB_Stats_t bus_arb_stats;
+static int bus_arb_ipplug_pending;
+static uint32_t bus_arb_tick;
+static uint32_t bus_arb_last_underruns;
+static uint32_t bus_arb_last_captured;
+
+/* Private functions ---------------------------------------------------------*/
+static void BUS_ARB_set_dma2d(uint32_t dead_time)
+{
+  /* AHB master timer only, applies to every DMA2D user (BSP drawing, PSRAM
+   * benchmark) */
+  DMA2D_HandleTypeDef hdma2d = { .Instance = DMA2D };
+
+  __HAL_RCC_DMA2D_CLK_ENABLE();
+  if (dead_time)
+  {
+    HAL_DMA2D_ConfigDeadTime(&hdma2d, (uint8_t) dead_time);
+    HAL_DMA2D_EnableDeadTime(&hdma2d);
+  }
+  else
+  {
+    HAL_DMA2D_DisableDeadTime(&hdma2d);
+  }
+}
+
+static HAL_StatusTypeDef BUS_ARB_set_ipplug(const BUS_ARB_Preset_t *preset)
+{
+  DCMIPP_IPPlugConfTypeDef ipplug = {0};
+  HAL_StatusTypeDef status;
+  int running;
+
+  ipplug.Client = BUS_ARB_DCMIPP_CLIENT;
+  ipplug.MemoryPageSize = DCMIPP_MEMORY_PAGE_SIZE_256BYTES;
+  ipplug.Traffic = preset->dcmipp_traffic;
+  ipplug.MaxOutstandingTransactions = preset->dcmipp_outstanding;
+  ipplug.DPREGStart = 0;
+  ipplug.DPREGEnd = BUS_ARB_DCMIPP_DPREG_END;
+  ipplug.WLRURatio = BUS_ARB_DCMIPP_WLRU;
+
+  /* The IP-Plug is only reconfigured idle: the pipe is suspended, a frame
+   * may be dropped */
+  running = HAL_DCMIPP_PIPE_GetState(bus_arb_hdcmipp, BUS_ARB_DCMIPP_PIPE) == HAL_DCMIPP_PIPE_STATE_BUSY;
+  if (running && HAL_DCMIPP_PIPE_Suspend(bus_arb_hdcmipp, BUS_ARB_DCMIPP_PIPE) != HAL_OK)
+  {
+    return HAL_BUSY;
+  }
+  status = HAL_DCMIPP_SetIPPlugConfig(bus_arb_hdcmipp, &ipplug);
+  if (running && HAL_DCMIPP_PIPE_Resume(bus_arb_hdcmipp, BUS_ARB_DCMIPP_PIPE) != HAL_OK)
+  {
+    status = HAL_ERROR;
+  }
+
+  return status;
+}
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+  * @brief  Apply the preset of a display mode, before the camera starts
+  * @param  hdcmipp DCMIPP handle of the camera middleware
+  * @param  pixel_clock_hz LTDC pixel clock of the display mode
+  * @retval BUS_ARB_ERROR_NONE or BUS_ARB_ERROR_HAL
+  */
+int32_t BUS_ARB_Init(DCMIPP_HandleTypeDef *hdcmipp, uint32_t pixel_clock_hz)
+{
+  FRAME_META_Stats_t frames;
+  uint32_t preset = 0;
+
+  bus_arb_hdcmipp = hdcmipp;
+  bus_arb_stats = (BUS_ARB_Stats_t) {0};
+  while (pixel_clock_hz > bus_arb_presets[preset].max_pixel_clock_hz)
+  {
+    preset++;
+  }
+
+  FRAME_META_GetStats(&frames);
+  bus_arb_tick = HAL_GetTick();
+  bus_arb_last_underruns = LCD_LAYER_GetUnderruns();
+  bus_arb_last_captured = frames.captured;
+
+  return BUS_ARB_SetPreset(preset);
+}
+
+/**
+  * @brief  Apply a preset
+  * @note   If the camera pipe cannot be suspended, the IP-Plug part is
+  *         retried by BUS_ARB_Process().
+  * @param  preset BUS_ARB_PRESET_xxx
+  * @retval BUS_ARB_ERROR_NONE or error
+  */
+int32_t BUS_ARB_SetPreset(uint32_t preset)
+{
+  HAL_StatusTypeDef status;
+
+  if (preset >= BUS_ARB_PRESET_NB)
+  {
+    return BUS_ARB_ERROR_PARAM;
+  }
+
+  bus_arb_stats.preset = preset;
+  BUS_ARB_set_dma2d(bus_arb_presets[preset].dma2d_dead_time);
+  status = BUS_ARB_set_ipplug(&bus_arb_presets[preset]);
+  bus_arb_ipplug_pending = status == HAL_BUSY;
+  if (bus_arb_ipplug_pending)
+  {
+    bus_arb_stats.deferred++;
+  }
+
+  return status == HAL_OK || status == HAL_BUSY ? BUS_ARB_ERROR_NONE : BUS_ARB_ERROR_HAL;
+}
+
+/**
+  * @brief  Check the LTDC underruns of the period, from the application loop
+  * @note   Underruns while the camera wrote frames raise the preset. Periods
+  *         without camera frames tell nothing about the arbitration.
+  * @param  None
+  * @retval None
+  */
+void BUS_ARB_Process(void)
+{
+  FRAME_META_Stats_t frames;
+  uint32_t underruns;
+  uint32_t captured;
+
+  if (HAL_GetTick() - bus_arb_tick < BUS_ARB_PERIOD_MS)
+  {
+    return;
+  }
+  bus_arb_tick = HAL_GetTick();
+
+  FRAME_META_GetStats(&frames);
+  underruns = LCD_LAYER_GetUnderruns() - bus_arb_last_underruns;
+  captured = frames.captured - bus_arb_last_captured;
+  bus_arb_last_underruns += underruns;
+  bus_arb_last_captured = frames.captured;
+
+  if (bus_arb_ipplug_pending)
+  {
+    BUS_ARB_SetPreset(bus_arb_stats.preset);
+    return;
+  }
+  if (captured == 0)
+  {
+    return;
+  }
+  if (underruns == 0)
+  {
+    bus_arb_stats.clean_periods++;
+    return;
+  }
+
+  TRACE_Record(TRACE_EVT_BUS_ARB, (bus_arb_stats.preset << 16) |
+               (underruns < BUS_ARB_TRACE_MAX ? underruns : BUS_ARB_TRACE_MAX));
+  if (bus_arb_stats.preset + 1 < BUS_ARB_PRESET_NB)
+  {
+    PRINTF("Bus arbitration: %lu underruns, preset %lu\n", (unsigned long) underruns,
+           (unsigned long)(bus_arb_stats.preset + 1));
+    bus_arb_stats.escalations++;
+    bus_arb_stats.clean_periods = 0;
+    BUS_ARB_SetPreset(bus_arb_stats.preset + 1);
+  }
+}
+
+void BUS_ARB_GetStats(BUS_ARB_Stats_t *stats)
+{
+  *stats = bus_arb_stats;
+}
@@ -0,0 +1,297 @@
+ /**
+ ******************************************************************************
+ * @file    cache_ctl.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "cache_ctl.h"
+#include "stm32n6xx_hal.h"
+
+/* Private define ------------------------------------------------------------*/
+/* MAIR attribute indexes, one per policy */
+#define CACHE_CTL_ATTR_WRITE_BACK     CACHE_CTL_POLICY_WRITE_BACK
+#define CACHE_CTL_ATTR_WRITE_THROUGH  CACHE_CTL_POLICY_WRITE_THROUGH
+#define CACHE_CTL_ATTR_NON_CACHEABLE  CACHE_CTL_POLICY_NON_CACHEABLE
+
+#define CACHE_CTL_LINE_MASK           (CACHE_CTL_LINE - 1U)
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint32_t base;
+  uint32_t limit;    /*!< Last byte */
+  uint32_t policy;
+  int used;
+} CACHE_CTL_Region_t;
+
+/* Private variables ---------------------------------------------------------*/
+/* Entry n is MPU region n */
+static CACHE_CTL_Region_t cache_ctl_regions[CACHE_CTL_REGION_NB];
+static uint32_t cache_ctl_region_nb;
+
+/* Private functions ---------------------------------------------------------*/
+/* Armv8-M default memory map, used outside the regions */
+static uint32_t CACHE_CTL_default_policy(uint32_t address)
+{
+  if (address < 0x20000000U)
+  {
+    return CACHE_CTL_POLICY_WRITE_THROUGH;  /* Code */
+  }
+  if (address < 0x40000000U)
+  {
+    return CACHE_CTL_POLICY_WRITE_BACK;     /* SRAM, AXISRAM */
+  }
+  if (address < 0x60000000U)
+  {
+    return CACHE_CTL_POLICY_NON_CACHEABLE;  /* Peripherals */
+  }
+  if (address < 0x80000000U)
+  {
+    return CACHE_CTL_POLICY_WRITE_BACK;     /* External RAM */
+  }
+  if (address < 0xA0000000U)
+  {
+    return CACHE_CTL_POLICY_WRITE_THROUGH;  /* External RAM, PSRAM */
+  }
+
+  return CACHE_CTL_POLICY_NON_CACHEABLE;    /* Devices, system */
+}
+
+static uint32_t CACHE_CTL_find(uint32_t base)
+{
+  uint32_t i;
+
+  for (i = 0; i < cache_ctl_region_nb; i++)
+  {
+    if (cache_ctl_regions[i].used && cache_ctl_regions[i].base == base)
+    {
+      return i;
+    }
+  }
+
+  return CACHE_CTL_REGION_NB;
+}
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+  * @brief  Program the memory attributes and enable the MPU without region
+  * @note   Call before the caches are enabled. Privileged accesses outside the
+  *         regions keep the default memory map.
+  */
+void CACHE_CTL_Init(void)
+{
+  uint32_t i;
+
+  ARM_MPU_Disable();
+
+  ARM_MPU_SetMemAttr(CACHE_CTL_ATTR_WRITE_BACK,
+                     ARM_MPU_ATTR(ARM_MPU_ATTR_MEMORY_(1, 1, 1, 1), ARM_MPU_ATTR_MEMORY_(1, 1, 1, 1)));
+  ARM_MPU_SetMemAttr(CACHE_CTL_ATTR_WRITE_THROUGH,
+                     ARM_MPU_ATTR(ARM_MPU_ATTR_MEMORY_(1, 0, 1, 0), ARM_MPU_ATTR_MEMORY_(1, 0, 1, 0)));
+  ARM_MPU_SetMemAttr(CACHE_CTL_ATTR_NON_CACHEABLE,
+                     ARM_MPU_ATTR(ARM_MPU_ATTR_NON_CACHEABLE, ARM_MPU_ATTR_NON_CACHEABLE));
+
+  cache_ctl_region_nb = (MPU->TYPE & MPU_TYPE_DREGION_Msk) >> MPU_TYPE_DREGION_Pos;
+  if (cache_ctl_region_nb > CACHE_CTL_REGION_NB)
+  {
+    cache_ctl_region_nb = CACHE_CTL_REGION_NB;
+  }
+  for (i = 0; i < cache_ctl_region_nb; i++)
+  {
+    ARM_MPU_ClrRegion(i);
+    cache_ctl_regions[i].used = 0;
+  }
+
+  ARM_MPU_Enable(MPU_CTRL_PRIVDEFENA_Msk);
+}
+
+/**
+  * @brief  Set the D-cache policy of a buffer, or update it if the buffer
+  *         already has a region
+  * @note   Lines of the buffer are written back and invalidated first: none
+  *         is left behind that would not follow the new policy.
+  * @param  base Buffer, aligned on CACHE_CTL_LINE
+  * @param  size Bytes, multiple of CACHE_CTL_LINE
+  * @param  policy CACHE_CTL_POLICY_xxx
+  * @retval CACHE_CTL_ERROR_NONE or error
+  */
+int32_t CACHE_CTL_SetRegion(void *base, uint32_t size, uint32_t policy)
+{
+  uint32_t address = (uint32_t) base;
+  uint32_t primask;
+  uint32_t index;
+  uint32_t i;
+
+  if (size == 0 || ((address | size) & CACHE_CTL_LINE_MASK) || policy > CACHE_CTL_POLICY_NON_CACHEABLE)
+  {
+    return CACHE_CTL_ERROR_PARAM;
+  }
+
+  index = CACHE_CTL_find(address);
+  for (i = 0; index == CACHE_CTL_REGION_NB && i < cache_ctl_region_nb; i++)
+  {
+    if (!cache_ctl_regions[i].used)
+    {
+      index = i;
+    }
+  }
+  if (index == CACHE_CTL_REGION_NB)
+  {
+    return CACHE_CTL_ERROR_NO_REGION;
+  }
+
+  SCB_CleanInvalidateDCache_by_Addr(base, (int32_t) size);
+
+  /* Region disabled while its base and limit change */
+  primask = __get_PRIMASK();
+  __disable_irq();
+  ARM_MPU_ClrRegion(index);
+  ARM_MPU_SetRegion(index, ARM_MPU_RBAR(address, ARM_MPU_SH_NON, 0, 1, 1),
+                    ARM_MPU_RLAR(address + size - 1U, policy));
+  __DSB();
+  __ISB();
+  cache_ctl_regions[index].base = address;
+  cache_ctl_regions[index].limit = address + size - 1U;
+  cache_ctl_regions[index].policy = policy;
+  cache_ctl_regions[index].used = 1;
+  __set_PRIMASK(primask);
+
+  return CACHE_CTL_ERROR_NONE;
+}
+
+/**
+  * @brief  Give a buffer back to the default memory map
+  * @param  base Buffer given to CACHE_CTL_SetRegion()
+  * @retval CACHE_CTL_ERROR_NONE or CACHE_CTL_ERROR_PARAM
+  */
+int32_t CACHE_CTL_ClearRegion(void *base)
+{
+  uint32_t index = CACHE_CTL_find((uint32_t) base);
+  uint32_t primask;
+
+  if (index == CACHE_CTL_REGION_NB)
+  {
+    return CACHE_CTL_ERROR_PARAM;
+  }
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  ARM_MPU_ClrRegion(index);
+  __DSB();
+  __ISB();
+  cache_ctl_regions[index].used = 0;
+  __set_PRIMASK(primask);
+
+  return CACHE_CTL_ERROR_NONE;
+}
+
+uint32_t CACHE_CTL_GetPolicy(const void *address)
+{
+  uint32_t addr = (uint32_t) address;
+  uint32_t i;
+
+  for (i = 0; i < cache_ctl_region_nb; i++)
+  {
+    if (cache_ctl_regions[i].used && addr >= cache_ctl_regions[i].base && addr <= cache_ctl_regions[i].limit)
+    {
+      return cache_ctl_regions[i].policy;
+    }
+  }
+
+  return CACHE_CTL_default_policy(addr);
+}
+
+/**
+  * @brief  Write back CPU stores before a DMA master reads the range
+  */
+void CACHE_CTL_Clean(const void *address, uint32_t size)
+{
+  uint32_t start = (uint32_t) address & ~CACHE_CTL_LINE_MASK;
+  uint32_t end = ((uint32_t) address + size + CACHE_CTL_LINE_MASK) & ~CACHE_CTL_LINE_MASK;
+
+  if (size == 0 || CACHE_CTL_GetPolicy(address) != CACHE_CTL_POLICY_WRITE_BACK)
+  {
+    return;
+  }
+
+  SCB_CleanDCache_by_Addr((void *) start, (int32_t)(end - start));
+}
+
+/**
+  * @brief  Drop cached lines after a DMA master wrote the range
+  */
+void CACHE_CTL_Invalidate(void *address, uint32_t size)
+{
+  uint32_t start = (uint32_t) address;
+  uint32_t end = start + size;
+  uint32_t policy = CACHE_CTL_GetPolicy(address);
+
+  if (size == 0 || policy == CACHE_CTL_POLICY_NON_CACHEABLE)
+  {
+    return;
+  }
+
+  if (policy == CACHE_CTL_POLICY_WRITE_BACK)
+  {
+    /* Partial lines may hold dirty data next to the range */
+    if (start & CACHE_CTL_LINE_MASK)
+    {
+      SCB_CleanInvalidateDCache_by_Addr((void *)(start & ~CACHE_CTL_LINE_MASK), CACHE_CTL_LINE);
+      start = (start + CACHE_CTL_LINE_MASK) & ~CACHE_CTL_LINE_MASK;
+    }
+    if ((end & CACHE_CTL_LINE_MASK) && end > start)
+    {
+      end &= ~CACHE_CTL_LINE_MASK;
+      SCB_CleanInvalidateDCache_by_Addr((void *) end, CACHE_CTL_LINE);
+    }
+  }
+  else
+  {
+    start &= ~CACHE_CTL_LINE_MASK;
+    end = (end + CACHE_CTL_LINE_MASK) & ~CACHE_CTL_LINE_MASK;
+  }
+
+  if (end > start)
+  {
+    SCB_InvalidateDCache_by_Addr((void *) start, (int32_t)(end - start));
+  }
+}
+
+/**
+  * @brief  Write back and drop cached lines, e.g. before a DMA master
+  *         overwrites a range the CPU wrote
+  */
+void CACHE_CTL_CleanInvalidate(void *address, uint32_t size)
+{
+  uint32_t start = (uint32_t) address & ~CACHE_CTL_LINE_MASK;
+  uint32_t end = ((uint32_t) address + size + CACHE_CTL_LINE_MASK) & ~CACHE_CTL_LINE_MASK;
+  uint32_t policy = CACHE_CTL_GetPolicy(address);
+
+  if (size == 0 || policy == CACHE_CTL_POLICY_NON_CACHEABLE)
+  {
+    return;
+  }
+
+  if (policy == CACHE_CTL_POLICY_WRITE_THROUGH)
+  {
+    /* Nothing dirty */
+    SCB_InvalidateDCache_by_Addr((void *) start, (int32_t)(end - start));
+  }
+  else
+  {
+    SCB_CleanInvalidateDCache_by_Addr((void *) start, (int32_t)(end - start));
+  }
+}
@@ -0,0 +1,212 @@
+ /**
+ ******************************************************************************
+ * @file    cam_recovery.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "cam_recovery.h"
+#include "frame_meta.h"
+#include "trace.h"
+#include <stdio.h>
+
+#if defined(DEBUG)
+#define PRINTF(...)    printf(__VA_ARGS__)
+#else
+#define PRINTF(...)
+#endif /* defined(DEBUG) */
+
+/* Private define ------------------------------------------------------------*/
+/* Frame periods with errors in a row before restarting */
+#define CAM_RECOVERY_ERROR_PERIODS  8U
+/* Frame periods without capture before restarting */
+#define CAM_RECOVERY_STALL_PERIODS  5U
+/* A failed or ineffective restart is tried again after this time */
+#define CAM_RECOVERY_RETRY_MS       1000U
+
+#define CAM_RECOVERY_TRACE_MAX      0xffffU
+
+/* Private variables ---------------------------------------------------------*/
+static CAM_RECOVERY_Conf_t cam_recovery_conf;
+static CAM_RECOVERY_Stats_t cam_recovery_stats;
+/* Error interrupts, all classes */
+static volatile uint32_t cam_recovery_errors;
+static uint32_t cam_recovery_last_errors;
+static uint32_t cam_recovery_error_periods;
+static uint32_t cam_recovery_check_tick;
+static uint32_t cam_recovery_captured;
+static uint32_t cam_recovery_frame_tick;
+/* Restart done, waiting for its first frame */
+static int cam_recovery_restarted;
+static uint32_t cam_recovery_restart_tick;
+
+/* Private functions ---------------------------------------------------------*/
+static uint32_t CAM_RECOVERY_bits(uint32_t value)
+{
+  uint32_t count = 0;
+
+  while (value)
+  {
+    value &= value - 1;
+    count++;
+  }
+
+  return count;
+}
+
+static void CAM_RECOVERY_restart(uint32_t cause)
+{
+  int32_t ret;
+
+  PRINTF("Camera restart, cause %lu\n", (unsigned long) cause);
+  cam_recovery_stats.restarts++;
+  TRACE_Record(TRACE_EVT_CAM_RESTART, (cause << 16) |
+               (cam_recovery_stats.restarts < CAM_RECOVERY_TRACE_MAX ? cam_recovery_stats.restarts :
+                CAM_RECOVERY_TRACE_MAX));
+
+  ret = cam_recovery_conf.restart();
+  if (ret != 0)
+  {
+    cam_recovery_stats.restart_failures++;
+  }
+  cam_recovery_restarted = 1;
+  cam_recovery_restart_tick = HAL_GetTick();
+  cam_recovery_error_periods = 0;
+  cam_recovery_last_errors = cam_recovery_errors;
+}
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+  * @brief  Start watching the camera, once it is started
+  * @param  conf Frame period and restart procedure
+  * @retval None
+  */
+void CAM_RECOVERY_Init(const CAM_RECOVERY_Conf_t *conf)
+{
+  FRAME_META_Stats_t frames;
+
+  cam_recovery_conf = *conf;
+  cam_recovery_stats = (CAM_RECOVERY_Stats_t) {0};
+  cam_recovery_last_errors = cam_recovery_errors;
+  cam_recovery_error_periods = 0;
+  cam_recovery_restarted = 0;
+
+  FRAME_META_GetStats(&frames);
+  cam_recovery_captured = frames.captured;
+  cam_recovery_frame_tick = HAL_GetTick();
+  cam_recovery_check_tick = cam_recovery_frame_tick;
+}
+
+/**
+  * @brief  CSI error flags, from the CSI interrupt
+  * @param  sr1 CSI_SR1 error flags raised
+  */
+void CAM_RECOVERY_OnCsiErrors(uint32_t sr1)
+{
+  if (sr1 & CAM_RECOVERY_CSI_CRC)
+  {
+    cam_recovery_stats.csi_crc++;
+  }
+  cam_recovery_stats.csi_ecc += CAM_RECOVERY_bits(sr1 & CAM_RECOVERY_CSI_ECC);
+  cam_recovery_stats.csi_sync += CAM_RECOVERY_bits(sr1 & CAM_RECOVERY_CSI_SYNC);
+  cam_recovery_stats.csi_phy += CAM_RECOVERY_bits(sr1 & ~(CAM_RECOVERY_CSI_CRC | CAM_RECOVERY_CSI_ECC |
+                                                          CAM_RECOVERY_CSI_SYNC));
+  cam_recovery_errors++;
+}
+
+/**
+  * @brief  DCMIPP error flags, from the DCMIPP interrupt
+  * @param  cmsr2 DCMIPP_CMSR2 error flags raised
+  */
+void CAM_RECOVERY_OnDcmippErrors(uint32_t cmsr2)
+{
+  cam_recovery_stats.dcmipp_overruns += CAM_RECOVERY_bits(cmsr2 & CAM_RECOVERY_DCMIPP_OVR);
+  cam_recovery_stats.dcmipp_errors += CAM_RECOVERY_bits(cmsr2 & ~CAM_RECOVERY_DCMIPP_OVR);
+  cam_recovery_errors++;
+}
+
+/**
+  * @brief  ISP update failed, from the application loop
+  */
+void CAM_RECOVERY_OnIspError(void)
+{
+  cam_recovery_stats.isp_errors++;
+  cam_recovery_errors++;
+}
+
+/**
+  * @brief  Check the camera once per frame period, from the application loop
+  * @note   Also to be called while no frame comes in: a stall is detected
+  *         after CAM_RECOVERY_STALL_PERIODS. The outage of a restart is
+  *         measured up to its first captured frame and traced.
+  */
+void CAM_RECOVERY_Process(void)
+{
+  FRAME_META_Stats_t frames;
+  uint32_t now = HAL_GetTick();
+  uint32_t errors = cam_recovery_errors;
+  uint32_t outage;
+  int stalled;
+
+  FRAME_META_GetStats(&frames);
+  if (frames.captured != cam_recovery_captured)
+  {
+    if (cam_recovery_restarted)
+    {
+      outage = now - cam_recovery_frame_tick;
+      cam_recovery_stats.last_outage_ms = outage;
+      if (outage > cam_recovery_stats.max_outage_ms)
+      {
+        cam_recovery_stats.max_outage_ms = outage;
+      }
+      TRACE_Record(TRACE_EVT_CAM_RECOVERED, outage);
+      PRINTF("Camera recovered, %lu ms outage\n", (unsigned long) outage);
+      cam_recovery_restarted = 0;
+    }
+    cam_recovery_captured = frames.captured;
+    cam_recovery_frame_tick = now;
+  }
+
+  if (now - cam_recovery_check_tick < cam_recovery_conf.frame_period_ms)
+  {
+    return;
+  }
+  cam_recovery_check_tick = now;
+
+  cam_recovery_error_periods = errors != cam_recovery_last_errors ? cam_recovery_error_periods + 1 : 0;
+  cam_recovery_last_errors = errors;
+  stalled = now - cam_recovery_frame_tick >= CAM_RECOVERY_STALL_PERIODS * cam_recovery_conf.frame_period_ms;
+
+  if (cam_recovery_error_periods < CAM_RECOVERY_ERROR_PERIODS && !stalled)
+  {
+    return;
+  }
+  if (cam_recovery_restarted && now - cam_recovery_restart_tick < CAM_RECOVERY_RETRY_MS)
+  {
+    /* Restart still settling */
+    return;
+  }
+
+  CAM_RECOVERY_restart(stalled ? CAM_RECOVERY_CAUSE_STALL : CAM_RECOVERY_CAUSE_ERRORS);
+}
+
+void CAM_RECOVERY_GetStats(CAM_RECOVERY_Stats_t *stats)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  *stats = cam_recovery_stats;
+  __set_PRIMASK(primask);
+}
@@ -0,0 +1,201 @@
+ /**
+ ******************************************************************************
+ * @file    camera_mode.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "camera_mode.h"
+#include <stddef.h>
+
+/* Private define ------------------------------------------------------------*/
+#define CAMERA_MODE_SENSOR_ID(w, h)     (((uint32_t)(w) << 16) | (h))
+#define CAMERA_MODE_NB(modes)           (sizeof(modes) / sizeof((modes)[0]))
+/* Largest number of display frames per camera frame considered */
+#define CAMERA_MODE_MAX_DIVIDER         6U
+/* Camera fps may differ from refresh / divider by this much (per mille) */
+#define CAMERA_MODE_RATE_TOLERANCE      10U
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint32_t id;
+  const char *name;
+  const CAMERA_MODE_Mode_t *modes;
+  uint32_t nb_modes;
+} CAMERA_MODE_Sensor_t;
+
+/* Private variables ---------------------------------------------------------*/
+/* Full frame resolution of each camera middleware sensor driver, the only one
+ * they expose. Binned or ROI readouts (CAMERA_MODE_FLAG_xxx) are listed once a
+ * driver supports them. Modes the driver rejects at init are skipped by the
+ * caller. */
+static const CAMERA_MODE_Mode_t camera_mode_imx335[] = {
+  { 2592, 1944, 10, 30, 10, 0 },
+};
+
+static const CAMERA_MODE_Mode_t camera_mode_vd66gy[] = {
+  { 1120, 720, 10, 60, 10, 0 },
+};
+
+static const CAMERA_MODE_Mode_t camera_mode_vd55g1[] = {
+  { 800, 600, 10, 60, 8, 0 },
+};
+
+static const CAMERA_MODE_Sensor_t camera_mode_sensors[] = {
+  { CAMERA_MODE_SENSOR_ID(2592, 1944), "IMX335", camera_mode_imx335, CAMERA_MODE_NB(camera_mode_imx335) },
+  { CAMERA_MODE_SENSOR_ID(1120, 720), "VD66GY", camera_mode_vd66gy, CAMERA_MODE_NB(camera_mode_vd66gy) },
+  { CAMERA_MODE_SENSOR_ID(800, 600), "VD55G1", camera_mode_vd55g1, CAMERA_MODE_NB(camera_mode_vd55g1) },
+};
+
+/* Sensor not in the tables: only its default resolution is known */
+static CAMERA_MODE_Mode_t camera_mode_default;
+
+/* Private functions ---------------------------------------------------------*/
+static const CAMERA_MODE_Sensor_t *CAMERA_MODE_find(uint32_t sensor_id)
+{
+  uint32_t i;
+
+  for (i = 0; i < CAMERA_MODE_NB(camera_mode_sensors); i++)
+  {
+    if (camera_mode_sensors[i].id == sensor_id)
+    {
+      return &camera_mode_sensors[i];
+    }
+  }
+
+  return NULL;
+}
+
+/* Highest fps up to the refresh rate within the mode range, locked (refresh /
+ * fps an integer) if that rate allows it: a larger divider would lower the
+ * rate, it is never taken to get the lock */
+static void CAMERA_MODE_pick_rate(const CAMERA_MODE_Mode_t *mode, uint32_t refresh_mhz, CAMERA_MODE_Choice_t *choice)
+{
+  uint32_t divider;
+  uint32_t fps;
+  uint32_t error;
+
+  for (divider = 1; refresh_mhz != 0 && divider <= CAMERA_MODE_MAX_DIVIDER; divider++)
+  {
+    fps = (refresh_mhz / divider + 500) / 1000;
+    if (fps > mode->max_fps)
+    {
+      continue;
+    }
+    error = fps * 1000 * divider > refresh_mhz ? fps * 1000 * divider - refresh_mhz : refresh_mhz - fps * 1000 * divider;
+    if (fps >= mode->min_fps && error * 1000 <= refresh_mhz * CAMERA_MODE_RATE_TOLERANCE)
+    {
+      choice->fps = fps;
+      choice->refresh_divider = divider;
+      return;
+    }
+    break;
+  }
+
+  /* No locked cadence: no point in capturing faster than the display */
+  fps = mode->max_fps;
+  if (refresh_mhz != 0 && refresh_mhz / 1000 < fps)
+  {
+    fps = refresh_mhz / 1000 >= mode->min_fps ? refresh_mhz / 1000 : mode->min_fps;
+  }
+  choice->fps = fps;
+  choice->refresh_divider = 0;
+}
+
+/* Ordering: frame rate, then locked cadence, then readout latency, then CSI
+ * bandwidth, then binned / ROI readouts */
+static int CAMERA_MODE_is_better(const CAMERA_MODE_Choice_t *a, const CAMERA_MODE_Choice_t *b)
+{
+  if (a->fps != b->fps)
+  {
+    return a->fps > b->fps;
+  }
+  if ((a->refresh_divider != 0) != (b->refresh_divider != 0))
+  {
+    return a->refresh_divider != 0;
+  }
+  if (a->readout_us != b->readout_us)
+  {
+    return a->readout_us < b->readout_us;
+  }
+  if (a->csi_mbps != b->csi_mbps)
+  {
+    return a->csi_mbps < b->csi_mbps;
+  }
+
+  return a->mode->flags > b->mode->flags;
+}
+
+/* Functions Definition ------------------------------------------------------*/
+const char *CAMERA_MODE_GetSensorName(uint32_t sensor_id)
+{
+  const CAMERA_MODE_Sensor_t *sensor = CAMERA_MODE_find(sensor_id);
+
+  return sensor ? sensor->name : "unknown";
+}
+
+/**
+  * @brief  Rank the sensor modes able to produce the output
+  * @param  sensor_id Sensor default resolution (width << 16 | height)
+  * @param  out_width Pipe output width
+  * @param  out_height Pipe output height
+  * @param  refresh_mhz Display refresh rate in mHz, 0 if unknown
+  * @param  choices Filled with the candidates, best first
+  * @param  nb_choices Number of candidates
+  * @retval CAMERA_MODE_ERROR_NONE or CAMERA_MODE_ERROR_NO_MODE
+  */
+int32_t CAMERA_MODE_Negotiate(uint32_t sensor_id, uint32_t out_width, uint32_t out_height, uint32_t refresh_mhz,
+                              CAMERA_MODE_Choice_t choices[CAMERA_MODE_MAX], uint32_t *nb_choices)
+{
+  const CAMERA_MODE_Sensor_t *sensor = CAMERA_MODE_find(sensor_id);
+  const CAMERA_MODE_Mode_t *modes = sensor ? sensor->modes : &camera_mode_default;
+  uint32_t nb_modes = sensor ? sensor->nb_modes : 1;
+  CAMERA_MODE_Choice_t choice;
+  uint32_t nb = 0;
+  uint32_t i, j;
+
+  if (sensor == NULL)
+  {
+    camera_mode_default = (CAMERA_MODE_Mode_t) { sensor_id >> 16, sensor_id & 0xffff, 30, 30, 10, 0 };
+  }
+
+  for (i = 0; i < nb_modes && nb < CAMERA_MODE_MAX; i++)
+  {
+    if (modes[i].width < out_width || modes[i].height < out_height)
+    {
+      continue;
+    }
+
+    choice.mode = &modes[i];
+    CAMERA_MODE_pick_rate(&modes[i], refresh_mhz, &choice);
+    /* Row time of the mode whatever the frame rate: its frame is read out
+     * within its shortest frame period */
+    choice.readout_us = 1000000U / modes[i].max_fps;
+    choice.csi_mbps = (uint32_t)(((uint64_t)modes[i].width * modes[i].height * modes[i].bpp * choice.fps) / 1000000U);
+
+    /* Insertion sort, best first */
+    for (j = nb; j > 0 && CAMERA_MODE_is_better(&choice, &choices[j - 1]); j--)
+    {
+      choices[j] = choices[j - 1];
+    }
+    choices[j] = choice;
+    nb++;
+  }
+
+  *nb_choices = nb;
+
+  return nb ? CAMERA_MODE_ERROR_NONE : CAMERA_MODE_ERROR_NO_MODE;
+}
@@ -0,0 +1,106 @@
+ /**
+ ******************************************************************************
+ * @file    cpu_load.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "cpu_load.h"
+#include "stm32n6xx_hal.h"
+
+/* Private define ------------------------------------------------------------*/
+#define CPU_LOAD_WINDOW_MS  1000U
+
+/* Private variables ---------------------------------------------------------*/
+static uint32_t cpu_load_window_start;
+static uint32_t cpu_load_window_tick;
+static uint32_t cpu_load_sleep_cycles;
+static volatile uint32_t cpu_load_permille;
+
+/* Private functions ---------------------------------------------------------*/
+/* Close the measurement window about once per second. Also done by the
+ * getters: with no sleep at all the load must still read 100% */
+static void CPU_LOAD_roll(void)
+{
+  uint32_t now;
+  uint32_t total;
+
+  if (HAL_GetTick() - cpu_load_window_tick < CPU_LOAD_WINDOW_MS)
+  {
+    return;
+  }
+
+  now = DWT->CYCCNT;
+  total = now - cpu_load_window_start;
+  if (total != 0)
+  {
+    cpu_load_permille = 1000U - (uint32_t)(((uint64_t)cpu_load_sleep_cycles * 1000U) / total);
+  }
+  cpu_load_window_start = now;
+  cpu_load_window_tick = HAL_GetTick();
+  cpu_load_sleep_cycles = 0;
+}
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+  * @brief  Start the DWT cycle counter used to measure idle time
+  */
+void CPU_LOAD_Init(void)
+{
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  cpu_load_window_start = DWT->CYCCNT;
+  cpu_load_window_tick = HAL_GetTick();
+  cpu_load_sleep_cycles = 0;
+  cpu_load_permille = 0;
+}
+
+/**
+  * @brief  Enter sleep until next interrupt and account the time spent in it
+  * @note   Expected to be called with interrupts masked (PRIMASK set) so that
+  *         the wake-up event cannot be lost; the pending ISR then runs once the
+  *         caller unmasks interrupts and is accounted as busy time.
+  */
+void CPU_LOAD_Sleep(void)
+{
+  uint32_t start = DWT->CYCCNT;
+
+  __DSB();
+  __WFI();
+
+  cpu_load_sleep_cycles += DWT->CYCCNT - start;
+
+  CPU_LOAD_roll();
+}
+
+/**
+  * @brief  CPU load measured over the last complete window
+  * @note   Main loop context, as CPU_LOAD_Sleep(): a window due is closed here
+  *         when the CPU no longer sleeps.
+  */
+uint32_t CPU_LOAD_GetPercent(void)
+{
+  CPU_LOAD_roll();
+
+  return (cpu_load_permille + 5U) / 10U;
+}
+
+uint32_t CPU_LOAD_GetPermille(void)
+{
+  CPU_LOAD_roll();
+
+  return cpu_load_permille;
+}
@@ -0,0 +1,129 @@
+ /**
+ ******************************************************************************
+ * @file    disp_latency.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "disp_latency.h"
+#include "hdmi.h"
+#include "scanline.h"
+#include "trace.h"
+#include "stm32_lcd.h"
+#include "stm32n6570_discovery.h"
+
+/* Private define ------------------------------------------------------------*/
+#define DISP_LATENCY_JOB_BUDGET    2U
+/* Lines before the patch top the fill must not start: it is done before
+ * the scanout reaches the patch */
+#define DISP_LATENCY_GUARD_LINES   4U
+/* Monitors switch their picture mode after an InfoFrame change */
+#define DISP_LATENCY_SETTLE_MS     3000U
+
+/* Private variables ---------------------------------------------------------*/
+static DISP_LATENCY_Conf_t disp_latency_conf;
+static uint32_t disp_latency_tick;
+static uint32_t disp_latency_flashes;
+/* Flashes since the content type changed */
+static uint32_t disp_latency_count;
+static uint8_t disp_latency_content;
+static int disp_latency_white;
+/* Patch drawn, LED toggles at the next scanout of its top line */
+static volatile int disp_latency_armed;
+
+/* Private functions ---------------------------------------------------------*/
+/* Scanline job at the patch top line */
+static void DISP_LATENCY_on_line(void *arg)
+{
+  (void) arg;
+
+  if (!disp_latency_armed)
+  {
+    return;
+  }
+  BSP_LED_Toggle(LED_GREEN);
+  TRACE_Record(TRACE_EVT_DISP_LATENCY, ((uint32_t) disp_latency_content << 16) |
+               ((uint32_t) disp_latency_white << 15) | (disp_latency_flashes & 0x7fffU));
+  disp_latency_armed = 0;
+}
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+  * @brief  Start the test, the first flashes use the Game content type
+  * @param  conf Patch and flash sequence
+  * @retval DISP_LATENCY_ERROR_NONE or DISP_LATENCY_ERROR_SCANLINE
+  */
+int32_t DISP_LATENCY_Init(const DISP_LATENCY_Conf_t *conf)
+{
+  disp_latency_conf = *conf;
+  disp_latency_flashes = 0;
+  disp_latency_count = 0;
+  disp_latency_white = 0;
+  disp_latency_armed = 0;
+  disp_latency_content = HDMI_CONTENT_GAME;
+  HDMI_SetContentType(disp_latency_content);
+  disp_latency_tick = HAL_GetTick() + DISP_LATENCY_SETTLE_MS;
+
+  BSP_LED_Init(LED_GREEN);
+  BSP_LED_Off(LED_GREEN);
+  UTIL_LCD_FillRect(conf->x, conf->y, conf->size, conf->size, UTIL_LCD_COLOR_BLACK);
+
+  if (SCANLINE_Add(conf->y, DISP_LATENCY_JOB_BUDGET, 1, DISP_LATENCY_on_line, NULL) < 0)
+  {
+    return DISP_LATENCY_ERROR_SCANLINE;
+  }
+
+  return DISP_LATENCY_ERROR_NONE;
+}
+
+/**
+  * @brief  Draw the next flash when due, from the application loop
+  * @note   The patch is only drawn while the scanout is away from it, so the
+  *         LED edge marks the first refresh showing the whole patch.
+  */
+void DISP_LATENCY_Process(void)
+{
+  uint32_t line;
+
+  if (disp_latency_armed || (int32_t)(HAL_GetTick() - disp_latency_tick) < (int32_t) disp_latency_conf.period_ms)
+  {
+    return;
+  }
+
+  line = SCANLINE_GetCurrentLine();
+  if (line + DISP_LATENCY_GUARD_LINES >= disp_latency_conf.y &&
+      line < disp_latency_conf.y + disp_latency_conf.size)
+  {
+    return;
+  }
+
+  /* Switched with the patch black */
+  if (disp_latency_count >= disp_latency_conf.flashes_per_content && !disp_latency_white)
+  {
+    disp_latency_content = disp_latency_content == HDMI_CONTENT_GAME ? HDMI_CONTENT_NONE : HDMI_CONTENT_GAME;
+    HDMI_SetContentType(disp_latency_content);
+    disp_latency_tick = HAL_GetTick() + DISP_LATENCY_SETTLE_MS;
+    disp_latency_count = 0;
+    return;
+  }
+
+  disp_latency_white = !disp_latency_white;
+  UTIL_LCD_FillRect(disp_latency_conf.x, disp_latency_conf.y, disp_latency_conf.size, disp_latency_conf.size,
+                    disp_latency_white ? UTIL_LCD_COLOR_WHITE : UTIL_LCD_COLOR_BLACK);
+  disp_latency_armed = 1;
+  disp_latency_count++;
+  disp_latency_flashes++;
+  disp_latency_tick = HAL_GetTick();
+}
@@ -0,0 +1,415 @@
+ /**
+ ******************************************************************************
+ * @file    fb_alloc.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "fb_alloc.h"
+#include "cache_ctl.h"
+#include "stm32n6xx_hal.h"
+#include <stddef.h>
+
+/* Private define ------------------------------------------------------------*/
+/* AXISRAM2..6 and PSRAM */
+#define FB_ALLOC_POOL_NB         6U
+#define FB_ALLOC_ROUND_UP(x)     (((x) + FB_ALLOC_ALIGN - 1U) & ~(FB_ALLOC_ALIGN - 1U))
+#define FB_ALLOC_ROUND_DOWN(x)   ((x) & ~(FB_ALLOC_ALIGN - 1U))
+#define FB_ALLOC_NONE            0xffffffffU
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint32_t start;
+  uint32_t end;
+  int external;
+} FB_ALLOC_Pool_t;
+
+typedef struct
+{
+  uint32_t address;
+  uint32_t size;      /*!< 0 if the entry is unused */
+  uint32_t access;
+} FB_ALLOC_Buffer_t;
+
+/* Private variables ---------------------------------------------------------*/
+/* What the linker script leaves of each memory */
+#if defined(__ICCARM__)
+#pragma section = "AXISRAM2_POOL"
+#pragma section = "AXISRAM3_POOL"
+#pragma section = "AXISRAM4_POOL"
+#pragma section = "AXISRAM5_POOL"
+#pragma section = "AXISRAM6_POOL"
+#pragma section = "PSRAM_POOL"
+#define FB_ALLOC_LINKER_POOL(block, ext) \
+  { (uint32_t) __section_begin(block), (uint32_t) __section_end(block), ext }
+#define FB_ALLOC_AXISRAM2_POOL   FB_ALLOC_LINKER_POOL("AXISRAM2_POOL", 0)
+#define FB_ALLOC_AXISRAM3_POOL   FB_ALLOC_LINKER_POOL("AXISRAM3_POOL", 0)
+#define FB_ALLOC_AXISRAM4_POOL   FB_ALLOC_LINKER_POOL("AXISRAM4_POOL", 0)
+#define FB_ALLOC_AXISRAM5_POOL   FB_ALLOC_LINKER_POOL("AXISRAM5_POOL", 0)
+#define FB_ALLOC_AXISRAM6_POOL   FB_ALLOC_LINKER_POOL("AXISRAM6_POOL", 0)
+#define FB_ALLOC_PSRAM_POOL      FB_ALLOC_LINKER_POOL("PSRAM_POOL", 1)
+#else
+extern uint8_t __axisram2_pool_start__[], __axisram2_pool_end__[];
+extern uint8_t __axisram3_pool_start__[], __axisram3_pool_end__[];
+extern uint8_t __axisram4_pool_start__[], __axisram4_pool_end__[];
+extern uint8_t __axisram5_pool_start__[], __axisram5_pool_end__[];
+extern uint8_t __axisram6_pool_start__[], __axisram6_pool_end__[];
+extern uint8_t __psram_pool_start__[], __psram_pool_end__[];
+#define FB_ALLOC_LINKER_POOL(name, ext) \
+  { (uint32_t) __##name##_pool_start__, (uint32_t) __##name##_pool_end__, ext }
+#define FB_ALLOC_AXISRAM2_POOL   FB_ALLOC_LINKER_POOL(axisram2, 0)
+#define FB_ALLOC_AXISRAM3_POOL   FB_ALLOC_LINKER_POOL(axisram3, 0)
+#define FB_ALLOC_AXISRAM4_POOL   FB_ALLOC_LINKER_POOL(axisram4, 0)
+#define FB_ALLOC_AXISRAM5_POOL   FB_ALLOC_LINKER_POOL(axisram5, 0)
+#define FB_ALLOC_AXISRAM6_POOL   FB_ALLOC_LINKER_POOL(axisram6, 0)
+#define FB_ALLOC_PSRAM_POOL      FB_ALLOC_LINKER_POOL(psram, 1)
+#endif
+
+/* Pools after merging contiguous banks, in address order */
+static FB_ALLOC_Pool_t fb_alloc_pools[FB_ALLOC_POOL_NB];
+static uint32_t fb_alloc_pool_nb;
+static FB_ALLOC_Buffer_t fb_alloc_buffers[FB_ALLOC_BUFFER_NB];
+
+/* Private functions ---------------------------------------------------------*/
+static void FB_ALLOC_power_banks(void)
+{
+  __HAL_RCC_RAMCFG_CLK_ENABLE();
+  __HAL_RCC_AXISRAM2_MEM_CLK_ENABLE();
+  __HAL_RCC_AXISRAM3_MEM_CLK_ENABLE();
+  __HAL_RCC_AXISRAM4_MEM_CLK_ENABLE();
+  __HAL_RCC_AXISRAM5_MEM_CLK_ENABLE();
+  __HAL_RCC_AXISRAM6_MEM_CLK_ENABLE();
+
+  /* AXISRAM3..6 are shut down at reset */
+  RAMCFG_SRAM2_AXI->CR &= ~RAMCFG_CR_SRAMSD;
+  RAMCFG_SRAM3_AXI->CR &= ~RAMCFG_CR_SRAMSD;
+  RAMCFG_SRAM4_AXI->CR &= ~RAMCFG_CR_SRAMSD;
+  RAMCFG_SRAM5_AXI->CR &= ~RAMCFG_CR_SRAMSD;
+  RAMCFG_SRAM6_AXI->CR &= ~RAMCFG_CR_SRAMSD;
+}
+
+static const FB_ALLOC_Pool_t *FB_ALLOC_pool_of(uint32_t address)
+{
+  uint32_t i;
+
+  for (i = 0; i < fb_alloc_pool_nb; i++)
+  {
+    if (address >= fb_alloc_pools[i].start && address < fb_alloc_pools[i].end)
+    {
+      return &fb_alloc_pools[i];
+    }
+  }
+
+  return NULL;
+}
+
+static uint32_t FB_ALLOC_find(const void *buffer)
+{
+  uint32_t i;
+
+  for (i = 0; i < FB_ALLOC_BUFFER_NB; i++)
+  {
+    if (fb_alloc_buffers[i].size != 0 && fb_alloc_buffers[i].address == (uint32_t) buffer)
+    {
+      return i;
+    }
+  }
+
+  return FB_ALLOC_NONE;
+}
+
+/* End of the free space of a pool starting at an address, one buffer ignored */
+static uint32_t FB_ALLOC_gap_end(const FB_ALLOC_Pool_t *pool, uint32_t from, uint32_t ignore)
+{
+  uint32_t end = pool->end;
+  uint32_t i;
+
+  for (i = 0; i < FB_ALLOC_BUFFER_NB; i++)
+  {
+    if (i != ignore && fb_alloc_buffers[i].size != 0 &&
+        fb_alloc_buffers[i].address >= from && fb_alloc_buffers[i].address < end)
+    {
+      end = fb_alloc_buffers[i].address;
+    }
+  }
+
+  return end;
+}
+
+/* Smallest free gap of a pool, candidates start at the pool start or right
+ * after a buffer. Returns the largest gap if size is 0. */
+static uint32_t FB_ALLOC_fit(const FB_ALLOC_Pool_t *pool, uint32_t size, uint32_t *address)
+{
+  uint32_t best = size ? FB_ALLOC_NONE : 0;
+  uint32_t from;
+  uint32_t gap;
+  uint32_t i;
+
+  for (i = 0; i <= FB_ALLOC_BUFFER_NB; i++)
+  {
+    if (i == FB_ALLOC_BUFFER_NB)
+    {
+      from = pool->start;
+    }
+    else if (fb_alloc_buffers[i].size != 0 && FB_ALLOC_pool_of(fb_alloc_buffers[i].address) == pool)
+    {
+      from = fb_alloc_buffers[i].address + fb_alloc_buffers[i].size;
+    }
+    else
+    {
+      continue;
+    }
+    if (FB_ALLOC_find((void *) from) != FB_ALLOC_NONE)
+    {
+      /* Start of another buffer */
+      continue;
+    }
+
+    gap = FB_ALLOC_gap_end(pool, from, FB_ALLOC_NONE) - from;
+    if (size ? (gap >= size && gap < best) : gap > best)
+    {
+      best = gap;
+      *address = from;
+    }
+  }
+
+  return best;
+}
+
+/* D-cache policy from the access pattern. Buffers the CPU draws and a DMA
+ * master reads are write-through; buffers a DMA master writes and the CPU
+ * reads still need CACHE_CTL_Invalidate(). */
+static uint32_t FB_ALLOC_policy(uint32_t access)
+{
+  if (!(access & FB_ALLOC_ACCESS_CPU))
+  {
+    return CACHE_CTL_POLICY_NON_CACHEABLE;
+  }
+  if (access & (FB_ALLOC_ACCESS_SCANOUT | FB_ALLOC_ACCESS_CAPTURE))
+  {
+    return CACHE_CTL_POLICY_WRITE_THROUGH;
+  }
+
+  return CACHE_CTL_POLICY_WRITE_BACK;
+}
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+  * @brief  Power the AXISRAM banks and collect the pools left by the linker
+  * @note   Allocations are made from the application context only.
+  */
+void FB_ALLOC_Init(void)
+{
+  const FB_ALLOC_Pool_t linker_pools[FB_ALLOC_POOL_NB] = {
+    FB_ALLOC_AXISRAM2_POOL,
+    FB_ALLOC_AXISRAM3_POOL,
+    FB_ALLOC_AXISRAM4_POOL,
+    FB_ALLOC_AXISRAM5_POOL,
+    FB_ALLOC_AXISRAM6_POOL,
+    FB_ALLOC_PSRAM_POOL,
+  };
+  FB_ALLOC_Pool_t *last;
+  uint32_t start, end;
+  uint32_t i;
+
+  FB_ALLOC_power_banks();
+
+  fb_alloc_pool_nb = 0;
+  for (i = 0; i < FB_ALLOC_POOL_NB; i++)
+  {
+    start = FB_ALLOC_ROUND_UP(linker_pools[i].start);
+    end = FB_ALLOC_ROUND_DOWN(linker_pools[i].end);
+    if (end <= start)
+    {
+      continue;
+    }
+    /* A bank without static buffers continues the previous one */
+    last = fb_alloc_pool_nb ? &fb_alloc_pools[fb_alloc_pool_nb - 1] : NULL;
+    if (last != NULL && last->end == start && last->external == linker_pools[i].external)
+    {
+      last->end = end;
+      continue;
+    }
+    fb_alloc_pools[fb_alloc_pool_nb].start = start;
+    fb_alloc_pools[fb_alloc_pool_nb].end = end;
+    fb_alloc_pools[fb_alloc_pool_nb].external = linker_pools[i].external;
+    fb_alloc_pool_nb++;
+  }
+
+  for (i = 0; i < FB_ALLOC_BUFFER_NB; i++)
+  {
+    fb_alloc_buffers[i].size = 0;
+  }
+}
+
+/**
+  * @brief  Allocate a buffer
+  * @param  size Bytes, rounded up to FB_ALLOC_ALIGN
+  * @param  access FB_ALLOC_ACCESS_xxx: display and camera buffers go to the
+  *         AXISRAM if they fit, CPU only buffers to the PSRAM if they fit. It
+  *         also sets the D-cache policy of the buffer (MPU region).
+  * @retval Buffer aligned on FB_ALLOC_ALIGN, NULL if no memory or no MPU region
+  */
+void *FB_ALLOC_Alloc(uint32_t size, uint32_t access)
+{
+  int internal_first = (access & (FB_ALLOC_ACCESS_SCANOUT | FB_ALLOC_ACCESS_CAPTURE)) != 0;
+  uint32_t best = FB_ALLOC_NONE;
+  uint32_t address = 0;
+  uint32_t candidate;
+  uint32_t slot;
+  uint32_t gap;
+  uint32_t pass;
+  uint32_t i;
+
+  size = FB_ALLOC_ROUND_UP(size);
+  for (slot = 0; slot < FB_ALLOC_BUFFER_NB && fb_alloc_buffers[slot].size != 0; slot++)
+  {
+  }
+  if (size == 0 || slot == FB_ALLOC_BUFFER_NB)
+  {
+    return NULL;
+  }
+
+  /* Best fit over the pools of the preferred memory, then the other one */
+  for (pass = 0; pass < 2 && best == FB_ALLOC_NONE; pass++)
+  {
+    for (i = 0; i < fb_alloc_pool_nb; i++)
+    {
+      if (fb_alloc_pools[i].external != (internal_first ? (int) pass : !pass))
+      {
+        continue;
+      }
+      gap = FB_ALLOC_fit(&fb_alloc_pools[i], size, &candidate);
+      if (gap < best)
+      {
+        best = gap;
+        address = candidate;
+      }
+    }
+  }
+  if (best == FB_ALLOC_NONE ||
+      CACHE_CTL_SetRegion((void *) address, size, FB_ALLOC_policy(access)) != CACHE_CTL_ERROR_NONE)
+  {
+    return NULL;
+  }
+
+  fb_alloc_buffers[slot].address = address;
+  fb_alloc_buffers[slot].size = size;
+  fb_alloc_buffers[slot].access = access;
+
+  return (void *) address;
+}
+
+/**
+  * @brief  Resize a buffer for a new video mode
+  * @note   The buffer is resized in place if the space after it allows.
+  *         Otherwise a new buffer is returned and the old one stays allocated
+  *         until FB_ALLOC_Free(): free it once the display no longer reads it
+  *         (see LCD_LAYER_WaitCommit()). Content is not copied.
+  * @param  buffer Buffer to resize, NULL to allocate
+  * @param  size New size in bytes
+  * @param  access FB_ALLOC_ACCESS_xxx
+  * @retval Resized or new buffer, NULL if no memory
+  */
+void *FB_ALLOC_Realloc(void *buffer, uint32_t size, uint32_t access)
+{
+  const FB_ALLOC_Pool_t *pool;
+  uint32_t index;
+
+  index = buffer != NULL ? FB_ALLOC_find(buffer) : FB_ALLOC_NONE;
+  if (index == FB_ALLOC_NONE)
+  {
+    return buffer != NULL ? NULL : FB_ALLOC_Alloc(size, access);
+  }
+
+  size = FB_ALLOC_ROUND_UP(size);
+  pool = FB_ALLOC_pool_of((uint32_t) buffer);
+  if (size != 0 && FB_ALLOC_gap_end(pool, (uint32_t) buffer, index) - (uint32_t) buffer >= size &&
+      CACHE_CTL_SetRegion(buffer, size, FB_ALLOC_policy(access)) == CACHE_CTL_ERROR_NONE)
+  {
+    fb_alloc_buffers[index].size = size;
+    fb_alloc_buffers[index].access = access;
+    return buffer;
+  }
+
+  return FB_ALLOC_Alloc(size, access);
+}
+
+int32_t FB_ALLOC_Free(void *buffer)
+{
+  uint32_t index = FB_ALLOC_find(buffer);
+
+  if (buffer == NULL || index == FB_ALLOC_NONE)
+  {
+    return FB_ALLOC_ERROR_PARAM;
+  }
+  fb_alloc_buffers[index].size = 0;
+  CACHE_CTL_ClearRegion(buffer);
+
+  return FB_ALLOC_ERROR_NONE;
+}
+
+/**
+  * @brief  Buffer in PSRAM: its display and camera traffic shares the XSPI
+  */
+int FB_ALLOC_IsExternal(const void *buffer)
+{
+  const FB_ALLOC_Pool_t *pool = FB_ALLOC_pool_of((uint32_t) buffer);
+
+  return pool != NULL && pool->external;
+}
+
+void FB_ALLOC_GetStats(FB_ALLOC_Stats_t *stats)
+{
+  const FB_ALLOC_Pool_t *pool;
+  uint32_t address;
+  uint32_t largest;
+  uint32_t i;
+
+  *stats = (FB_ALLOC_Stats_t) {0};
+  for (i = 0; i < fb_alloc_pool_nb; i++)
+  {
+    pool = &fb_alloc_pools[i];
+    if (pool->external)
+    {
+      stats->external_free += pool->end - pool->start;
+      continue;
+    }
+    stats->internal_free += pool->end - pool->start;
+    largest = FB_ALLOC_fit(pool, 0, &address);
+    if (largest > stats->internal_largest)
+    {
+      stats->internal_largest = largest;
+    }
+  }
+
+  for (i = 0; i < FB_ALLOC_BUFFER_NB; i++)
+  {
+    if (fb_alloc_buffers[i].size == 0)
+    {
+      continue;
+    }
+    stats->buffers++;
+    if (FB_ALLOC_IsExternal((void *) fb_alloc_buffers[i].address))
+    {
+      stats->external_free -= fb_alloc_buffers[i].size;
+    }
+    else
+    {
+      stats->internal_free -= fb_alloc_buffers[i].size;
+    }
+  }
+}
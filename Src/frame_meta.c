@@ -0,0 +1,313 @@
+ /**
+ ******************************************************************************
+ * @file    frame_meta.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "frame_meta.h"
+#include "scanline.h"
+#include "trace.h"
+#include <stddef.h>
+
+/* Private define ------------------------------------------------------------*/
+/* Lines allowed for the vblank job before its timestamp is considered late */
+#define FRAME_META_VBLANK_BUDGET   4U
+
+/* Private variables ---------------------------------------------------------*/
+static DCMIPP_HandleTypeDef *frame_meta_hdcmipp;
+static uint32_t frame_meta_pipe;
+static int frame_meta_has_counter;
+static uint32_t frame_meta_last_sequence;
+static int frame_meta_last_sequence_valid;
+
+static FRAME_META_Record_t frame_meta_ring[FRAME_META_NB];
+/* Records started, slot n is frame_meta_ring[n % FRAME_META_NB] */
+static uint32_t frame_meta_head;
+/* Slot being captured, slot complete and not yet shown, slot on screen */
+static uint32_t frame_meta_capturing;
+static int frame_meta_capturing_valid;
+static uint32_t frame_meta_pending;
+static int frame_meta_pending_valid;
+static uint32_t frame_meta_shown;
+static int frame_meta_shown_valid;
+
+static volatile int32_t frame_meta_exposure = -1;
+static volatile int32_t frame_meta_gain = -1;
+static FRAME_META_Stats_t frame_meta_stats;
+
+/* Private functions ---------------------------------------------------------*/
+/* Camera and LTDC interrupts update the records: mask both, from any context */
+static uint32_t FRAME_META_lock(void)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+
+  return primask;
+}
+
+static void FRAME_META_unlock(uint32_t primask)
+{
+  __set_PRIMASK(primask);
+}
+
+static FRAME_META_Record_t *FRAME_META_slot(uint32_t slot)
+{
+  return &frame_meta_ring[slot % FRAME_META_NB];
+}
+
+/* Slot still in the ring, not yet reused by a newer capture */
+static int FRAME_META_is_live(uint32_t slot)
+{
+  return frame_meta_head - slot <= FRAME_META_NB;
+}
+
+static void FRAME_META_drop(uint32_t slot)
+{
+  FRAME_META_slot(slot)->flags |= FRAME_META_FLAG_DROPPED;
+  frame_meta_stats.dropped++;
+}
+
+/* Vblank scanline job: the next scanout shows the latest complete frame */
+static void FRAME_META_on_vblank(void *arg)
+{
+  uint32_t now = DWT->CYCCNT;
+  FRAME_META_Record_t *record;
+  uint32_t primask;
+
+  (void) arg;
+
+  primask = FRAME_META_lock();
+  if (frame_meta_pending_valid)
+  {
+    record = FRAME_META_slot(frame_meta_pending);
+    record->presented = now;
+    record->flags |= FRAME_META_FLAG_PRESENTED;
+    frame_meta_stats.presented++;
+    frame_meta_shown = frame_meta_pending;
+    frame_meta_shown_valid = 1;
+    frame_meta_pending_valid = 0;
+    TRACE_Record(TRACE_EVT_FRAME_PRESENT, record->sequence);
+  }
+  else if (frame_meta_shown_valid)
+  {
+    record = FRAME_META_slot(frame_meta_shown);
+    record->flags |= FRAME_META_FLAG_REPEATED;
+    record->repeats++;
+    frame_meta_stats.repeated++;
+  }
+  FRAME_META_unlock(primask);
+}
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+  * @brief  Start tracking the frames of a DCMIPP pipe
+  * @param  hdcmipp DCMIPP handle of the camera middleware
+  * @param  pipe Pipe writing into the display buffer
+  * @param  vblank_line First vertical blanking line, see SCANLINE_VBLANK()
+  * @retval FRAME_META_ERROR_NONE or FRAME_META_ERROR_SCANLINE
+  */
+int32_t FRAME_META_Init(DCMIPP_HandleTypeDef *hdcmipp, uint32_t pipe, uint32_t vblank_line)
+{
+  frame_meta_hdcmipp = hdcmipp;
+  frame_meta_pipe = pipe;
+  frame_meta_head = 0;
+  frame_meta_capturing_valid = 0;
+  frame_meta_pending_valid = 0;
+  frame_meta_shown_valid = 0;
+  frame_meta_last_sequence_valid = 0;
+  frame_meta_stats = (FRAME_META_Stats_t) {0};
+
+  /* Without hardware counter, sequence numbers count the captures started */
+  frame_meta_has_counter = HAL_DCMIPP_PIPE_EnableFrameCounter(hdcmipp, pipe) == HAL_OK;
+
+  if (SCANLINE_Add(vblank_line, FRAME_META_VBLANK_BUDGET, 1, FRAME_META_on_vblank, NULL) < 0)
+  {
+    return FRAME_META_ERROR_SCANLINE;
+  }
+
+  return FRAME_META_ERROR_NONE;
+}
+
+/**
+  * @brief  Pipe restarted (DCMIPP initialized again), before the capture starts
+  * @note   The DCMIPP frame counter restarts: the jump of sequence numbers is
+  *         not counted as missing frames. The frame on screen stays tracked
+  *         until replaced.
+  */
+void FRAME_META_OnPipeRestart(void)
+{
+  uint32_t primask;
+
+  primask = FRAME_META_lock();
+  if (frame_meta_capturing_valid)
+  {
+    FRAME_META_drop(frame_meta_capturing);
+    frame_meta_capturing_valid = 0;
+  }
+  frame_meta_last_sequence_valid = 0;
+  FRAME_META_unlock(primask);
+
+  frame_meta_has_counter = HAL_DCMIPP_PIPE_EnableFrameCounter(frame_meta_hdcmipp, frame_meta_pipe) == HAL_OK;
+}
+
+/**
+  * @brief  Sensor settings applied to the next captures
+  * @note   Called from the application after each ISP run, sensor registers
+  *         are not read from interrupt context.
+  */
+void FRAME_META_SetSensor(int32_t exposure, int32_t gain)
+{
+  frame_meta_exposure = exposure;
+  frame_meta_gain = gain;
+}
+
+/**
+  * @brief  Camera vsync of the tracked pipe, from interrupt context
+  */
+void FRAME_META_OnCaptureStart(void)
+{
+  uint32_t now = DWT->CYCCNT;
+  FRAME_META_Record_t *record;
+  uint32_t primask;
+
+  primask = FRAME_META_lock();
+  if (frame_meta_capturing_valid)
+  {
+    /* No frame end for the previous vsync: the frame was aborted */
+    FRAME_META_drop(frame_meta_capturing);
+  }
+
+  record = FRAME_META_slot(frame_meta_head);
+  *record = (FRAME_META_Record_t) {0};
+  /* Expected value, replaced by the DCMIPP counter at frame end */
+  record->sequence = frame_meta_has_counter ? frame_meta_last_sequence + 1 : frame_meta_head;
+  record->capture_start = now;
+  record->exposure = frame_meta_exposure;
+  record->gain = frame_meta_gain;
+  frame_meta_capturing = frame_meta_head;
+  frame_meta_capturing_valid = 1;
+  frame_meta_head++;
+
+  /* The reused slot may be the one on screen */
+  if (frame_meta_shown_valid && !FRAME_META_is_live(frame_meta_shown))
+  {
+    frame_meta_shown_valid = 0;
+  }
+  FRAME_META_unlock(primask);
+}
+
+/**
+  * @brief  Camera frame end of the tracked pipe, from interrupt context
+  */
+void FRAME_META_OnCaptureEnd(void)
+{
+  uint32_t now = DWT->CYCCNT;
+  FRAME_META_Record_t *record;
+  uint32_t sequence;
+  uint32_t primask;
+
+  primask = FRAME_META_lock();
+  if (!frame_meta_capturing_valid)
+  {
+    /* Tracking started mid-frame */
+    FRAME_META_unlock(primask);
+    return;
+  }
+
+  record = FRAME_META_slot(frame_meta_capturing);
+  record->capture_end = now;
+  record->flags |= FRAME_META_FLAG_COMPLETE;
+  if (frame_meta_has_counter &&
+      HAL_DCMIPP_PIPE_ReadFrameCounter(frame_meta_hdcmipp, frame_meta_pipe, &sequence) == HAL_OK)
+  {
+    if (frame_meta_last_sequence_valid && sequence - frame_meta_last_sequence > 1)
+    {
+      record->flags |= FRAME_META_FLAG_SEQ_GAP;
+      frame_meta_stats.missing += sequence - frame_meta_last_sequence - 1;
+    }
+    frame_meta_last_sequence = sequence;
+    frame_meta_last_sequence_valid = 1;
+    record->sequence = sequence;
+  }
+  frame_meta_stats.captured++;
+
+  /* Two frame ends without vblank in between: the older was never shown */
+  if (frame_meta_pending_valid)
+  {
+    FRAME_META_drop(frame_meta_pending);
+  }
+  frame_meta_pending = frame_meta_capturing;
+  frame_meta_pending_valid = 1;
+  frame_meta_capturing_valid = 0;
+  FRAME_META_unlock(primask);
+}
+
+/**
+  * @brief  Copy the record of a frame still in the history
+  * @param  sequence Frame sequence number
+  * @param  record Copy of the record
+  * @retval FRAME_META_ERROR_NONE or FRAME_META_ERROR_NOT_FOUND
+  */
+int32_t FRAME_META_Get(uint32_t sequence, FRAME_META_Record_t *record)
+{
+  int32_t ret = FRAME_META_ERROR_NOT_FOUND;
+  uint32_t primask;
+  uint32_t i;
+
+  primask = FRAME_META_lock();
+  for (i = 1; i <= FRAME_META_NB && i <= frame_meta_head; i++)
+  {
+    if (FRAME_META_slot(frame_meta_head - i)->sequence == sequence)
+    {
+      *record = *FRAME_META_slot(frame_meta_head - i);
+      ret = FRAME_META_ERROR_NONE;
+      break;
+    }
+  }
+  FRAME_META_unlock(primask);
+
+  return ret;
+}
+
+/**
+  * @brief  Copy the record of the frame currently scanned out
+  * @param  record Copy of the record
+  * @retval FRAME_META_ERROR_NONE or FRAME_META_ERROR_NOT_FOUND
+  */
+int32_t FRAME_META_GetDisplayed(FRAME_META_Record_t *record)
+{
+  int32_t ret = FRAME_META_ERROR_NOT_FOUND;
+  uint32_t primask;
+
+  primask = FRAME_META_lock();
+  if (frame_meta_shown_valid)
+  {
+    *record = *FRAME_META_slot(frame_meta_shown);
+    ret = FRAME_META_ERROR_NONE;
+  }
+  FRAME_META_unlock(primask);
+
+  return ret;
+}
+
+void FRAME_META_GetStats(FRAME_META_Stats_t *stats)
+{
+  uint32_t primask = FRAME_META_lock();
+
+  *stats = frame_meta_stats;
+  FRAME_META_unlock(primask);
+}
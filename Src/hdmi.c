@@ -15,11 +15,14 @@
   */
 
 #include "hdmi.h"
+#include "hdmi_i2c.h"
+#include "trace.h"
+#include "nvm.h"
 
 #include <assert.h>
 #include <stdio.h>
 
-#include "stm32n6570_discovery_bus.h"
+#include "stm32n6xx_hal.h"
 
 #if defined(DEBUG)
 #define PRINTF(...)    printf(__VA_ARGS__)
@@ -28,20 +31,140 @@
 #endif /* defined(DEBUG) */
 
 #define ADV7513_I2C_ADDR 0x7a
+/* EDID read by the transmitter from the monitor: base block, then the
+ * first extension block at 0x80 */
+#define ADV7513_EDID_I2C_ADDR 0x7e
+#define HDMI_EDID_SIZE 128
+
+/* HDMI Vendor Specific Data Block: CEA-861 tag and IEEE OUI, LSB first */
+#define HDMI_CEA_TAG      0x02
+#define HDMI_CEA_VSDB     3
+#define HDMI_IEEE_OUI     0x000c03
+/* Video Capability Data Block: extended tag, QS bit (RGB range selectable) */
+#define HDMI_CEA_EXTENDED 7
+#define HDMI_CEA_VCDB     0
+#define HDMI_VCDB_QS      (1 << 6)
+
+/* AVI InfoFrame RGB quantization range: default of the format, limited, full */
+#define HDMI_QUANT_DEFAULT 0
+#define HDMI_QUANT_LIMITED 1
+#define HDMI_QUANT_FULL    2
+
+/* Bus speed tried first, lowered while the transmitter does not answer.
+ * Fast-mode Plus (HDMI_I2C_SPEED_FAST_PLUS) only on validated boards */
+#ifndef HDMI_BUS_SPEED
+#define HDMI_BUS_SPEED HDMI_I2C_SPEED_FAST
+#endif
+
+/* Bring-up polling: HPD debounce instead of a fixed delay */
+#define HDMI_POLL_MS                10U
+#define HDMI_HPD_STABLE_MS          50U
+#define HDMI_PLL_LOCK_TIMEOUT_MS   100U
+#define HDMI_EDID_TIMEOUT_MS       200U
+
+/* Link health, once configured: 2 reads (3 bytes) per check, in background */
+#define HDMI_HEALTH_PERIOD_MS      500U
+/* Checks the PLL is seen unlocked before it is reprogrammed */
+#define HDMI_HEALTH_PLL_CHECKS       2U
+/* Consecutive failed checks before the I2C bus is reset */
+#define HDMI_HEALTH_I2C_ERRORS       3U
+/* A check over this time delays the next ones as much */
+#define HDMI_HEALTH_BUDGET_US     2000U
+
+/* AVI InfoFrame: version 2, 13 data bytes, type code set by the transmitter */
+#define HDMI_AVI_VERSION  0x02
+#define HDMI_AVI_LENGTH   13
+
+/* Registers read in the background, handled by the next HDMI_Process() */
+#define HDMI_READ_NONE    0
+#define HDMI_READ_HPD     1
+#define HDMI_READ_STATUS  2
+#define HDMI_READ_EDID    3
+#define HDMI_READ_HEALTH  4
+#define HDMI_READ_EDID_EXT 5
+
+static int32_t hdmi_state = HDMI_STATE_ABSENT;
+static uint32_t hdmi_state_tick;
+static uint32_t hdmi_poll_tick;
+/* Tick HPD was first seen high (| 1), 0 while low */
+static uint32_t hdmi_hpd_tick;
+/* Resumed from a known configuration: no debounce, transmitter checked once up */
+static int hdmi_resume;
+static uint32_t hdmi_edid_hash;
+static HDMI_Video_t hdmi_video = { 0, 0, 1, 1, HDMI_CONTENT_NONE };
+/* Link in HDMI mode, AVI InfoFrame sent */
+static int hdmi_mode;
+/* AVI InfoFrame not queued or a transfer failed (the 0x4a hold may be left
+ * set), sent again by HDMI_Process() */
+static int hdmi_avi_pending;
+/* Monitor EDID has the HDMI VSDB, and the VCDB with the RGB range
+ * selectable (QS), kept while the EDID is not read */
+static int hdmi_sink_hdmi;
+static int hdmi_sink_qs;
+/* HDMI_QUANT_xxx sent in the AVI InfoFrame, limited range out of the CSC */
+static uint8_t hdmi_quant;
+static int hdmi_limited;
+static HDMI_Health_t hdmi_health;
+static uint32_t hdmi_health_tick;
+static uint32_t hdmi_pll_unlocked;
+static uint32_t hdmi_i2c_failed;
+/* Monitor sense seen low, tick of the loss (| 1) */
+static uint32_t hdmi_sense_lost_tick;
+/* Link lost: HDMI_CAUSE_xxx, 0 if none, and tick of the loss */
+static uint32_t hdmi_lost_cause;
+static uint32_t hdmi_lost_tick;
+/* Read in flight: HDMI_READ_xxx, registers, DWT->CYCCNT when queued */
+static int hdmi_read;
+static uint8_t hdmi_regs[3];
+static uint8_t hdmi_edid[2 * HDMI_EDID_SIZE];
+static uint32_t hdmi_read_start;
+/* First error queueing the current sequence, HDMI_queue_start() clears it */
+static int32_t hdmi_queue_error;
+
+/* Transfers are queued, HDMI_Process() handles their errors. A transfer that
+ * cannot be queued (queue full, bus not open) is counted and the rest of the
+ * sequence skipped: the caller queues the whole sequence again later */
+static void HDMI_queue_start(void)
+{
+  hdmi_queue_error = HDMI_I2C_ERROR_NONE;
+}
+
+static void HDMI_queued(int32_t ret)
+{
+  if (ret != HDMI_I2C_ERROR_NONE)
+  {
+    hdmi_health.i2c_errors++;
+    hdmi_queue_error = ret;
+  }
+}
 
 static void HDMI_read_modify_write(uint16_t addr, uint8_t data, uint8_t mask)
 {
-  uint8_t reg;
-  int32_t ret;
+  if (hdmi_queue_error == HDMI_I2C_ERROR_NONE)
+  {
+    HDMI_queued(HDMI_I2C_Update(ADV7513_I2C_ADDR, addr, data, mask));
+  }
+}
 
-  ret = BSP_I2C2_ReadReg(ADV7513_I2C_ADDR, addr, &reg, 1);
-  assert(ret == 0);
+static void HDMI_write_regs(uint16_t addr, const uint8_t *data, uint16_t size)
+{
+  if (hdmi_queue_error == HDMI_I2C_ERROR_NONE)
+  {
+    HDMI_queued(HDMI_I2C_Write(ADV7513_I2C_ADDR, addr, data, size));
+  }
+}
 
-  reg &= ~mask;
-  reg |= (data & mask);
+static void HDMI_write(uint16_t addr, uint8_t data)
+{
+  HDMI_write_regs(addr, &data, 1);
+}
 
-  ret = BSP_I2C2_WriteReg(ADV7513_I2C_ADDR, addr, &reg, 1);
-  assert(ret == 0);
+static void HDMI_read(uint16_t dev, uint16_t addr, uint8_t *data, uint16_t size)
+{
+  if (hdmi_queue_error == HDMI_I2C_ERROR_NONE)
+  {
+    HDMI_queued(HDMI_I2C_Read(dev, addr, data, size));
+  }
 }
 
 static void HDMI_clear_bits(uint16_t addr, uint8_t bit_to_clear)
@@ -54,80 +177,831 @@ static void HDMI_set_bits(uint16_t addr, uint8_t bit_to_set)
   HDMI_read_modify_write(addr, bit_to_set, bit_to_set);
 }
 
+/* Open the transport and read the chip revision, lowering the bus speed
+ * until the transmitter answers */
+static int HDMI_open_bus(uint8_t *revision)
+{
+  uint32_t speed = HDMI_BUS_SPEED;
+
+  while (HDMI_I2C_Init(speed) == HDMI_I2C_ERROR_NONE)
+  {
+    HDMI_queue_start();
+    HDMI_read(ADV7513_I2C_ADDR, 0x00, revision, 1);
+    if (hdmi_queue_error == HDMI_I2C_ERROR_NONE && HDMI_I2C_Sync() == HDMI_I2C_ERROR_NONE)
+    {
+      return 1;
+    }
+    if (speed <= HDMI_I2C_SPEED_STANDARD)
+    {
+      break;
+    }
+    speed = speed > HDMI_I2C_SPEED_FAST ? HDMI_I2C_SPEED_FAST : HDMI_I2C_SPEED_STANDARD;
+  }
+
+  return 0;
+}
+
 int32_t HDMI_Detect(void)
 {
-  uint8_t reg;
-  int32_t ret;
+  uint8_t reg = 0;
+  int detected;
 
-  BSP_I2C2_Init();
+  detected = HDMI_open_bus(&reg) && reg == 0x13;
+  HDMI_I2C_DeInit();
 
-  /* Read chip revision */
-  ret = BSP_I2C2_ReadReg(ADV7513_I2C_ADDR, 0x00, &reg, 1);
-  if (ret != 0)
+  TRACE_Record(TRACE_EVT_HDMI_STATE, detected ? HDMI_STATE_DETECTED : HDMI_STATE_ABSENT);
+
+  return detected;
+}
+
+/* CEA-861 extension data block collection: HDMI sink with the HDMI Vendor
+ * Specific Data Block (DVI sinks may have the extension without it), RGB
+ * range selectable with the QS bit of the Video Capability Data Block */
+static void HDMI_parse_cea(const uint8_t *ext)
+{
+  uint8_t end = ext[2];
+  uint8_t i = 4;
+  uint8_t tag;
+  uint8_t len;
+
+  hdmi_sink_hdmi = 0;
+  hdmi_sink_qs = 0;
+  if (ext[0] != HDMI_CEA_TAG || end < 4 || end > HDMI_EDID_SIZE - 1)
+  {
+    return;
+  }
+  while (i < end)
   {
-    return 0;
+    tag = ext[i] >> 5;
+    len = ext[i] & 0x1f;
+    if (i + len >= end)
+    {
+      break;
+    }
+    if (tag == HDMI_CEA_VSDB && len >= 3 &&
+        (ext[i + 1] | (ext[i + 2] << 8) | ((uint32_t) ext[i + 3] << 16)) == HDMI_IEEE_OUI)
+    {
+      hdmi_sink_hdmi = 1;
+    }
+    if (tag == HDMI_CEA_EXTENDED && len >= 2 && ext[i + 1] == HDMI_CEA_VCDB)
+    {
+      hdmi_sink_qs = (ext[i + 2] & HDMI_VCDB_QS) != 0;
+    }
+    i += 1 + len;
   }
-  BSP_I2C2_DeInit();
+}
 
-  return reg == 0x13;
+/* RGB range of the link. Monitors without QS take the default range of the
+ * format: limited for CEA formats but VIC 1 (640x480), full for the others.
+ * DVI is always full range */
+static void HDMI_select_range(int hdmi)
+{
+  if (!hdmi)
+  {
+    hdmi_quant = HDMI_QUANT_DEFAULT;
+    hdmi_limited = 0;
+  }
+  else if (hdmi_sink_qs)
+  {
+    hdmi_quant = hdmi_video.full_range ? HDMI_QUANT_FULL : HDMI_QUANT_LIMITED;
+    hdmi_limited = !hdmi_video.full_range;
+  }
+  else
+  {
+    hdmi_quant = HDMI_QUANT_DEFAULT;
+    hdmi_limited = hdmi_video.vic > 1;
+  }
 }
 
-void HDMI_Init(void)
+/* CEA-861 pixel repetition code, AVI InfoFrame: 0 none, 1 sent twice, 3 sent
+ * four times */
+static uint8_t HDMI_repeat_code(uint8_t pixel_repeat)
 {
-  uint8_t reg;
-  int32_t ret;
+  return pixel_repeat == 4 ? 3 : pixel_repeat - 1;
+}
 
-  BSP_I2C2_Init();
+/* ADV7513 0x3b clock multiplier and repetition fields: 0 x1, 1 x2, 2 x4 */
+static uint8_t HDMI_repeat_shift(uint8_t pixel_repeat)
+{
+  return pixel_repeat == 4 ? 2 : pixel_repeat - 1;
+}
 
-  /* Read chip revision */
-  ret = BSP_I2C2_ReadReg(ADV7513_I2C_ADDR, 0x00, &reg, 1);
-  assert(ret == 0);
-  assert(reg == 0x13);
+/* AVI InfoFrame header (version, length, checksum) and data bytes, RGB 4:4:4 */
+static void HDMI_build_avi_infoframe(uint8_t *frame, const HDMI_Video_t *video, uint8_t quant)
+{
+  uint8_t sum;
+  int i;
 
-  PRINTF("Plug hdmi cable to monitor\n");
-  /* Poll cable is connected (read HPD pin status) */
-  do {
-    HAL_Delay(100);
-    ret = BSP_I2C2_ReadReg(ADV7513_I2C_ADDR, 0x42, &reg, 1);
-    assert(ret == 0);
-  } while ((reg & (1 << 6)) == 0);
-  PRINTF("Cable plugged detected\n");
-  HAL_Delay(1000); // wait some time to be stable
+  for (i = 0; i < 3 + HDMI_AVI_LENGTH; i++)
+  {
+    frame[i] = 0;
+  }
+  frame[0] = HDMI_AVI_VERSION;
+  frame[1] = HDMI_AVI_LENGTH;
+  /* PB1: RGB, active format present, IT content underscanned (no crop) */
+  frame[3] = (1 << 4) | (video->content != HDMI_CONTENT_NONE ? 2 : 0);
+  /* PB2: picture aspect 4:3 (1), 16:9 (2) or none without VIC, active
+   * format same as picture */
+  if (video->vic != 0)
+  {
+    frame[4] = (video->aspect_16_9 ? 2 : 1) << 4;
+  }
+  frame[4] |= 0x8;
+  /* PB3: IT content, RGB quantization range (HDMI_QUANT_xxx) */
+  frame[5] = ((video->content != HDMI_CONTENT_NONE) << 7) | (quant << 2);
+  /* PB4: VIC */
+  frame[6] = video->vic & 0x7f;
+  /* PB5: content type (valid with IT content), pixel repetition */
+  if (video->content != HDMI_CONTENT_NONE)
+  {
+    frame[7] = (video->content - HDMI_CONTENT_GRAPHICS) << 4;
+  }
+  frame[7] |= HDMI_repeat_code(video->pixel_repeat);
 
-  /* Power up */
-  HDMI_clear_bits(0x41, 1 << 6);
+  /* Type code included in the checksum */
+  sum = 0x82;
+  for (i = 0; i < 3 + HDMI_AVI_LENGTH; i++)
+  {
+    sum += frame[i];
+  }
+  frame[2] = (uint8_t)(0x100 - sum);
+}
+
+static void HDMI_send_avi_infoframe(void)
+{
+  uint8_t frame[3 + HDMI_AVI_LENGTH];
+
+  /* Held while updated, the monitor never gets a partial InfoFrame */
+  HDMI_build_avi_infoframe(frame, &hdmi_video, hdmi_quant);
+  HDMI_set_bits(0x4a, 1 << 6);
+  HDMI_write_regs(0x52, frame, sizeof(frame));
+  HDMI_clear_bits(0x4a, 1 << 6);
+  HDMI_set_bits(0x44, 1 << 4);
+}
+
+/* Pixel repetition and VIC, programmed before the TMDS PLL locks */
+static void HDMI_configure_video(void)
+{
+  uint8_t shift = HDMI_repeat_shift(hdmi_video.pixel_repeat);
+
+  /* input : aspect ratio, used by the transmitter to identify the VIC */
+  HDMI_read_modify_write(0x17, hdmi_video.aspect_16_9 << 1, 1 << 1);
 
-  /* Fixed registers that must be set on power-up */
-  reg = 0x03;
-  BSP_I2C2_WriteReg(ADV7513_I2C_ADDR, 0x98, &reg, 1);
+  if (hdmi_video.vic == 0)
+  {
+    return;
+  }
+
+  /* Pixel repetition, manual mode: TMDS clock multiplier and value sent to
+   * the monitor, the transmitter repeats each input pixel */
+  HDMI_write(0x3b, (2 << 5) | (shift << 3) | (shift << 1));
+  /* VIC sent to the monitor */
+  HDMI_read_modify_write(0x3c, hdmi_video.vic, 0x3f);
+}
+
+/* Color space converter: full range RGB from the LTDC scaled to 16-235,
+ * coefficients 0x18-0x2f (scale +-1.0, 1.0 is 4096, offsets in 1/16) */
+static void HDMI_configure_csc(int limited)
+{
+  /* A1 A2 A3 A4, B1 B2 B3 B4, C1 C2 C3 C4: diagonal 219/255, offset 16 */
+  static const uint8_t csc_limited[24] = {
+    0x0d, 0xbe, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00,
+    0x00, 0x00, 0x0d, 0xbe, 0x00, 0x00, 0x01, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x0d, 0xbe, 0x01, 0x00,
+  };
+
+  if (!limited)
+  {
+    HDMI_clear_bits(0x18, 1 << 7);
+    return;
+  }
+
+  /* Coefficients written while disabled, then enabled */
+  HDMI_write_regs(0x18, csc_limited, 12);
+  HDMI_write_regs(0x18 + 12, &csc_limited[12], 12);
+  HDMI_set_bits(0x18, 1 << 7);
+}
+
+/* HDMI mode with AVI InfoFrame, DVI mode for monitors without HDMI support */
+static void HDMI_configure_mode(int hdmi)
+{
+  hdmi_mode = hdmi;
+  HDMI_select_range(hdmi);
+  HDMI_configure_csc(hdmi_limited);
+  if (!hdmi)
+  {
+    /* output : dvi mode */
+    HDMI_read_modify_write(0xaf, 0 << 1, 1 << 1);
+    HDMI_clear_bits(0x44, 1 << 4);
+    return;
+  }
+
+  HDMI_send_avi_infoframe();
+  /* output : hdmi mode */
+  HDMI_read_modify_write(0xaf, 1 << 1, 1 << 1);
+}
+
+/* Fixed registers that must be set on power-up, TMDS PLL included */
+static void HDMI_configure_fixed(void)
+{
+  HDMI_write(0x98, 0x03);
   HDMI_set_bits(0x9a, 7 << 5);
-  reg = 0x30;
-  BSP_I2C2_WriteReg(ADV7513_I2C_ADDR, 0x9c, &reg, 1);
+  HDMI_write(0x9c, 0x30);
   HDMI_read_modify_write(0x9d, 1, 3);
-  reg = 0xa4;
-  BSP_I2C2_WriteReg(ADV7513_I2C_ADDR, 0xa2, &reg, 1);
-  reg = 0xa4;
-  BSP_I2C2_WriteReg(ADV7513_I2C_ADDR, 0xa3, &reg, 1);
-  reg = 0xd0;
-  BSP_I2C2_WriteReg(ADV7513_I2C_ADDR, 0xe0, &reg, 1);
-  reg = 0x00;
-  BSP_I2C2_WriteReg(ADV7513_I2C_ADDR, 0xf9, &reg, 1);
+  /* 0xa2 and 0xa3 sent as one transfer */
+  HDMI_write(0xa2, 0xa4);
+  HDMI_write(0xa3, 0xa4);
+  HDMI_write(0xe0, 0xd0);
+  HDMI_write(0xf9, 0x00);
+}
+
+/* Program the transmitter once powered: fixed registers and video format,
+ * queued and sent in the background */
+static void HDMI_configure(void)
+{
+  /* Power up */
+  HDMI_clear_bits(0x41, 1 << 6);
+
+  /* EDID is read from the monitor once powered: report EDID ready */
+  HDMI_set_bits(0x94, 1 << 2);
+  HDMI_write(0x96, 1 << 2);
+
+  HDMI_configure_fixed();
 
   /* Setup input mode */
   /* input : 24 bits rgb 4:4:4 with separate syncs */
-  reg = 0x00;
-  BSP_I2C2_WriteReg(ADV7513_I2C_ADDR, 0x15, &reg, 1);
+  HDMI_write(0x15, 0x00);
   /* input : 8 bit color depth */
   HDMI_read_modify_write(0x16, 3 << 4, 3 << 4);
-  /* input : aspect ratio 4/3 */ // TODO: Enable 19/9 aspect ratio support
-  HDMI_read_modify_write(0x17, 0 << 1, 1 << 1);
 
   /* Setup output mode */
   /* output : 4:4:4 */
   HDMI_read_modify_write(0x16, 0 << 6, 3 << 6);
   /* output : disable color space converter */
   HDMI_read_modify_write(0x18, 0 << 7, 1 << 7);
-  /* output : dvi mode */
-  HDMI_read_modify_write(0xaf, 0 << 1, 1 << 1);
-  BSP_I2C2_DeInit();
+
+  HDMI_configure_video();
+}
+
+static void HDMI_set_state(int32_t state)
+{
+  hdmi_state = state;
+  hdmi_state_tick = HAL_GetTick();
+  TRACE_Record(TRACE_EVT_HDMI_STATE, state);
+}
+
+static void HDMI_link_lost(uint32_t cause)
+{
+  PRINTF("HDMI link lost, cause %lu\n", (unsigned long) cause);
+  TRACE_Record(TRACE_EVT_HDMI_LINK_LOST, cause);
+  if (hdmi_lost_cause == 0)
+  {
+    hdmi_lost_tick = HAL_GetTick();
+  }
+  hdmi_lost_cause = cause;
+}
+
+static void HDMI_link_recovered(uint32_t cause, uint32_t lost_tick)
+{
+  uint32_t ms = HAL_GetTick() - lost_tick;
+
+  hdmi_health.recoveries++;
+  hdmi_health.last_recovery_ms = ms;
+  TRACE_Record(TRACE_EVT_HDMI_RECOVERED, (cause << 20) | (ms < 0xfffffU ? ms : 0xfffffU));
+  PRINTF("HDMI link recovered in %lu ms\n", (unsigned long) ms);
+}
+
+/* Stuck bus: reset it after HDMI_HEALTH_I2C_ERRORS failed checks in a row */
+static void HDMI_bus_failed(void)
+{
+  if (++hdmi_i2c_failed >= HDMI_HEALTH_I2C_ERRORS)
+  {
+    /* Nothing else to do for a stuck bus, the next check starts afresh. If
+     * the bus cannot be opened again, checks fail and it is retried */
+    hdmi_i2c_failed = 0;
+    (void) HDMI_I2C_Init(HDMI_I2C_GetSpeed());
+  }
+}
+
+static void HDMI_start_health(void)
+{
+  hdmi_health.checks++;
+  hdmi_read_start = DWT->CYCCNT;
+
+  /* 0x41 power-down, 0x42 HPD and monitor sense, 0x9e PLL lock */
+  HDMI_queue_start();
+  HDMI_read(ADV7513_I2C_ADDR, 0x41, &hdmi_regs[0], 2);
+  HDMI_read(ADV7513_I2C_ADDR, 0x9e, &hdmi_regs[2], 1);
+  if (hdmi_queue_error != HDMI_I2C_ERROR_NONE)
+  {
+    HDMI_bus_failed();
+    return;
+  }
+  hdmi_read = HDMI_READ_HEALTH;
+}
+
+/*
+ * Health check of a configured link, once its reads are done. Only the part
+ * of the configuration that was lost is programmed again: everything after
+ * HPD loss (the transmitter resets its registers) or a transmitter reset, the
+ * fixed registers and video format after a PLL unlock, the InfoFrame once the
+ * monitor is sensed again.
+ */
+static void HDMI_check_health(int32_t ret)
+{
+  HDMI_I2C_Stats_t stats;
+  uint32_t elapsed_us;
+  uint8_t *status = &hdmi_regs[0];
+  uint8_t pll = hdmi_regs[2];
+
+  /* Reads queued to done */
+  HDMI_I2C_GetStats(&stats);
+  elapsed_us = (stats.idle_cycles - hdmi_read_start) / (SystemCoreClock / 1000000U);
+  if (elapsed_us > hdmi_health.max_check_us)
+  {
+    hdmi_health.max_check_us = elapsed_us;
+  }
+  if (elapsed_us > HDMI_HEALTH_BUDGET_US)
+  {
+    /* Slow or stretched bus: back off */
+    hdmi_health_tick += elapsed_us / 1000U;
+  }
+
+  if (ret != 0)
+  {
+    hdmi_health.i2c_errors++;
+    HDMI_bus_failed();
+    return;
+  }
+  hdmi_i2c_failed = 0;
+
+  if ((status[1] & (1 << 6)) == 0)
+  {
+    /* Monitor unplugged or power-cycled: bring-up again once HPD is back */
+    hdmi_health.hpd_losses++;
+    HDMI_link_lost(HDMI_CAUSE_HPD);
+    hdmi_resume = 0;
+    hdmi_hpd_tick = 0;
+    hdmi_sense_lost_tick = 0;
+    HDMI_set_state(HDMI_STATE_WAIT_HPD);
+    return;
+  }
+
+  if ((status[0] & (1 << 6)) != 0)
+  {
+    /* Transmitter reset (supply glitch) while the monitor stayed connected,
+     * seen again by the next check if not queued */
+    HDMI_queue_start();
+    HDMI_configure();
+    if (hdmi_queue_error != HDMI_I2C_ERROR_NONE)
+    {
+      return;
+    }
+    hdmi_health.chip_resets++;
+    HDMI_link_lost(HDMI_CAUSE_CHIP_RESET);
+    hdmi_sense_lost_tick = 0;
+    HDMI_set_state(HDMI_STATE_POWERED);
+    return;
+  }
+
+  if ((status[1] & (1 << 5)) == 0)
+  {
+    /* Monitor in standby: TMDS receiver not terminated, nothing to redo */
+    if (hdmi_sense_lost_tick == 0)
+    {
+      hdmi_health.sense_losses++;
+      TRACE_Record(TRACE_EVT_HDMI_LINK_LOST, HDMI_CAUSE_SENSE);
+      hdmi_sense_lost_tick = HAL_GetTick() | 1;
+    }
+    return;
+  }
+  if (hdmi_sense_lost_tick != 0)
+  {
+    if (hdmi_mode)
+    {
+      HDMI_queue_start();
+      HDMI_send_avi_infoframe();
+      if (hdmi_queue_error != HDMI_I2C_ERROR_NONE)
+      {
+        /* Sent again by the next check */
+        return;
+      }
+    }
+    HDMI_link_recovered(HDMI_CAUSE_SENSE, hdmi_sense_lost_tick);
+    hdmi_sense_lost_tick = 0;
+  }
+
+  if ((pll & (1 << 4)) == 0)
+  {
+    if (hdmi_pll_unlocked++ == 0)
+    {
+      hdmi_health.pll_unlocks++;
+    }
+    if (hdmi_pll_unlocked >= HDMI_HEALTH_PLL_CHECKS)
+    {
+      HDMI_queue_start();
+      HDMI_configure_fixed();
+      HDMI_configure_video();
+      if (hdmi_queue_error != HDMI_I2C_ERROR_NONE)
+      {
+        return;
+      }
+      HDMI_link_lost(HDMI_CAUSE_PLL);
+      hdmi_pll_unlocked = 0;
+      HDMI_set_state(HDMI_STATE_POWERED);
+      return;
+    }
+  }
+  else
+  {
+    hdmi_pll_unlocked = 0;
+  }
+}
+
+/**
+  * @brief  Select the output video format, applied by the next bring-up
+  * @note   With pixel repetition the LTDC produces 1/pixel_repeat of the
+  *         pixels of the CEA format, at 1/pixel_repeat of its pixel clock.
+  *         CEA-861 only allows repetition for some VICs (e.g. 14/15 and 29/30
+  *         for 1440x480p/1440x576p, 2 or 4 times).
+  *         Once the EDID is read, the RGB range follows the monitor: the
+  *         requested one if it has QS in its VCDB (quantization range sent
+  *         in the AVI InfoFrame), the default one of the format otherwise
+  *         (quantization default, the CSC scales CEA formats but VIC 1 to
+  *         limited range).
+  */
+void HDMI_SetVideo(const HDMI_Video_t *video)
+{
+  assert(video->pixel_repeat == 1 || video->pixel_repeat == 2 || video->pixel_repeat == 4);
+  assert(video->vic != 0 || video->pixel_repeat == 1);
+
+  hdmi_video = *video;
+}
+
+/**
+  * @brief  Change the AVI InfoFrame content type, also once configured
+  * @note   HDMI_CONTENT_GAME lets monitors skip their picture processing
+  *         (and its frames of latency). No effect on DVI links. The
+  *         InfoFrame is sent in the background, this never waits.
+  * @param  content HDMI_CONTENT_xxx
+  */
+void HDMI_SetContentType(uint8_t content)
+{
+  assert(content <= HDMI_CONTENT_GAME);
+
+  hdmi_video.content = content;
+  if (hdmi_state != HDMI_STATE_CONFIGURED || !hdmi_mode)
+  {
+    return;
+  }
+
+  HDMI_queue_start();
+  HDMI_send_avi_infoframe();
+  /* Sent again by HDMI_Process() */
+  hdmi_avi_pending = hdmi_queue_error != HDMI_I2C_ERROR_NONE;
+}
+
+/**
+  * @brief  Bring-up state, as returned by the last HDMI_Process()
+  * @retval HDMI_STATE_xxx
+  */
+int32_t HDMI_GetState(void)
+{
+  return hdmi_state;
+}
+
+/**
+  * @brief  Link mode, valid once HDMI_STATE_CONFIGURED
+  * @retval 1 in HDMI mode with AVI InfoFrame, 0 in DVI mode
+  */
+int HDMI_IsHdmiMode(void)
+{
+  return hdmi_mode;
+}
+
+/**
+  * @brief  Start the transmitter bring-up, completed by HDMI_Process()
+  * @note   Nothing waits for the monitor here: other initializations (e.g.
+  *         camera sensor) run while the cable and monitor settle.
+  */
+void HDMI_Start(void)
+{
+  uint8_t reg = 0;
+  int ret;
+
+  /* Read chip revision */
+  ret = HDMI_open_bus(&reg);
+  assert(ret);
+  assert(reg == 0x13);
+
+  PRINTF("Plug hdmi cable to monitor\n");
+  HDMI_set_state(HDMI_STATE_WAIT_HPD);
+  hdmi_resume = 0;
+  hdmi_mode = 0;
+  hdmi_sink_hdmi = 0;
+  hdmi_sink_qs = 0;
+  hdmi_lost_cause = 0;
+  hdmi_hpd_tick = 0;
+  hdmi_edid_hash = 0;
+  hdmi_read = HDMI_READ_NONE;
+  hdmi_avi_pending = 0;
+  hdmi_poll_tick = HAL_GetTick() - HDMI_POLL_MS;
+}
+
+/**
+  * @brief  Start the bring-up of a transmitter and monitor known from a
+  *         previous boot, completed by HDMI_Process()
+  * @note   HPD is not debounced. The chip revision read also selects the bus
+  *         speed, the EDID is read once the link is up, see HDMI_GetEdidHash().
+  */
+void HDMI_Resume(void)
+{
+  uint8_t reg = 0;
+
+  hdmi_resume = 1;
+  hdmi_mode = 0;
+  hdmi_sink_hdmi = 0;
+  hdmi_sink_qs = 0;
+  hdmi_lost_cause = 0;
+  hdmi_hpd_tick = 0;
+  hdmi_edid_hash = 0;
+  hdmi_read = HDMI_READ_NONE;
+  hdmi_avi_pending = 0;
+  hdmi_poll_tick = HAL_GetTick() - HDMI_POLL_MS;
+
+  if (!HDMI_open_bus(&reg) || reg != 0x13)
+  {
+    /* No transmitter answering (resumed configuration is stale) */
+    HDMI_I2C_DeInit();
+    HDMI_set_state(HDMI_STATE_ABSENT);
+    return;
+  }
+  HDMI_set_state(HDMI_STATE_WAIT_HPD);
+}
+
+/* Link up: HDMI or DVI mode, sent in the background. Stays powered if the
+ * mode cannot be queued, the status is polled again */
+static void HDMI_configured(void)
+{
+  /* CEA formats need HDMI mode whatever the EDID */
+  HDMI_queue_start();
+  HDMI_configure_mode(hdmi_video.vic != 0 || hdmi_sink_hdmi);
+  if (hdmi_queue_error != HDMI_I2C_ERROR_NONE)
+  {
+    return;
+  }
+  hdmi_avi_pending = 0;
+  HDMI_set_state(HDMI_STATE_CONFIGURED);
+  hdmi_health_tick = HAL_GetTick();
+  if (hdmi_lost_cause != 0)
+  {
+    HDMI_link_recovered(hdmi_lost_cause, hdmi_lost_tick);
+    hdmi_lost_cause = 0;
+  }
+}
+
+/* Reads of the previous HDMI_Process() done: next bring-up step */
+static void HDMI_read_done(int read, int32_t ret)
+{
+  uint8_t reg;
+  uint8_t irq;
+
+  switch (read)
+  {
+  case HDMI_READ_HPD:
+    if (ret != 0 && hdmi_lost_cause != 0)
+    {
+      /* Link being recovered: the transmitter answered before */
+      hdmi_health.i2c_errors++;
+      break;
+    }
+    if (ret != 0)
+    {
+      HDMI_I2C_DeInit();
+      HDMI_set_state(HDMI_STATE_ABSENT);
+      break;
+    }
+    reg = hdmi_regs[0];
+    if ((reg & (1 << 6)) == 0)
+    {
+      hdmi_hpd_tick = 0;
+      break;
+    }
+    if (hdmi_hpd_tick == 0 && !hdmi_resume)
+    {
+      hdmi_hpd_tick = HAL_GetTick() | 1;
+      break;
+    }
+    if (!hdmi_resume && HAL_GetTick() - hdmi_hpd_tick < HDMI_HPD_STABLE_MS)
+    {
+      break;
+    }
+    /* HPD read again and configuration queued again if it does not fit */
+    HDMI_queue_start();
+    HDMI_configure();
+    if (hdmi_queue_error != HDMI_I2C_ERROR_NONE)
+    {
+      break;
+    }
+    PRINTF("Cable plugged detected\n");
+    TRACE_Record(TRACE_EVT_HDMI_STATE, HDMI_STATE_PLUGGED);
+    HDMI_set_state(HDMI_STATE_POWERED);
+    break;
+  case HDMI_READ_STATUS:
+    if (ret != 0)
+    {
+      /* Configuration or status reads failed, polled again */
+      hdmi_health.i2c_errors++;
+      break;
+    }
+    reg = hdmi_regs[0];
+    irq = hdmi_regs[1];
+    if ((reg & (1 << 4)) == 0)
+    {
+      if (HAL_GetTick() - hdmi_state_tick < HDMI_PLL_LOCK_TIMEOUT_MS)
+      {
+        break;
+      }
+      /* No lock (pixel clock missing or out of range): power-up and
+       * configuration again, without HPD debounce */
+      hdmi_health.pll_unlocks++;
+      HDMI_link_lost(HDMI_CAUSE_PLL);
+      HDMI_set_state(HDMI_STATE_WAIT_HPD);
+      break;
+    }
+    if ((irq & (1 << 2)) == 0 && HAL_GetTick() - hdmi_state_tick < HDMI_EDID_TIMEOUT_MS)
+    {
+      break;
+    }
+    if ((irq & (1 << 2)) != 0)
+    {
+      HDMI_queue_start();
+      HDMI_read(ADV7513_EDID_I2C_ADDR, 0x00, hdmi_edid, HDMI_EDID_SIZE);
+      if (hdmi_queue_error == HDMI_I2C_ERROR_NONE)
+      {
+        hdmi_read = HDMI_READ_EDID;
+      }
+      break;
+    }
+    /* Monitors without EDID hash to 0 */
+    HDMI_configured();
+    break;
+  case HDMI_READ_EDID:
+    if (ret == 0)
+    {
+      hdmi_edid_hash = NVM_Crc32(0, hdmi_edid, HDMI_EDID_SIZE);
+      hdmi_sink_hdmi = 0;
+      hdmi_sink_qs = 0;
+    }
+    if (ret == 0 && hdmi_edid[126] != 0)
+    {
+      /* HDMI monitors tell it in the first CEA-861 extension block */
+      HDMI_queue_start();
+      HDMI_read(ADV7513_EDID_I2C_ADDR, HDMI_EDID_SIZE, &hdmi_edid[HDMI_EDID_SIZE], HDMI_EDID_SIZE);
+      if (hdmi_queue_error == HDMI_I2C_ERROR_NONE)
+      {
+        hdmi_read = HDMI_READ_EDID_EXT;
+        break;
+      }
+    }
+    HDMI_configured();
+    break;
+  case HDMI_READ_EDID_EXT:
+    /* DVI mode without the HDMI VSDB, default RGB range without QS */
+    if (ret == 0)
+    {
+      HDMI_parse_cea(&hdmi_edid[HDMI_EDID_SIZE]);
+    }
+    HDMI_configured();
+    break;
+  case HDMI_READ_HEALTH:
+    HDMI_check_health(ret);
+    break;
+  default:
+    break;
+  }
+}
+
+/**
+  * @brief  Advance the bring-up, never blocks
+  * @note   HPD must be seen high for HDMI_HPD_STABLE_MS, then the PLL lock
+  *         is polled instead of sleeping a fixed delay; without lock after
+  *         HDMI_PLL_LOCK_TIMEOUT_MS the transmitter is configured again. I2C
+  *         transfers run in the background: registers read are handled by the
+  *         next call once done, configuration and recovery writes are only
+  *         queued. Transfers that cannot be queued count as I2C errors and
+  *         their sequence is queued again later.
+  * @retval HDMI_STATE_xxx
+  */
+int32_t HDMI_Process(void)
+{
+  int32_t ret;
+  int read;
+
+  if (hdmi_state == HDMI_STATE_ABSENT)
+  {
+    return hdmi_state;
+  }
+
+  ret = HDMI_I2C_Poll();
+  if (ret == HDMI_I2C_ERROR_BUSY)
+  {
+    return hdmi_state;
+  }
+  if (hdmi_read != HDMI_READ_NONE)
+  {
+    read = hdmi_read;
+    hdmi_read = HDMI_READ_NONE;
+    HDMI_read_done(read, ret);
+    if (hdmi_read != HDMI_READ_NONE || hdmi_state == HDMI_STATE_ABSENT)
+    {
+      return hdmi_state;
+    }
+  }
+  else if (ret != HDMI_I2C_ERROR_NONE)
+  {
+    /* Queued writes failed: the next reads tell what is left */
+    hdmi_health.i2c_errors++;
+  }
+  if (ret != HDMI_I2C_ERROR_NONE && hdmi_mode)
+  {
+    /* The queue was flushed: the InfoFrame hold release may be lost */
+    hdmi_avi_pending = 1;
+  }
+
+  if (hdmi_state == HDMI_STATE_CONFIGURED && hdmi_mode && hdmi_avi_pending)
+  {
+    HDMI_queue_start();
+    HDMI_send_avi_infoframe();
+    hdmi_avi_pending = hdmi_queue_error != HDMI_I2C_ERROR_NONE;
+  }
+  if (hdmi_state == HDMI_STATE_CONFIGURED &&
+      (int32_t)(HAL_GetTick() - hdmi_health_tick) >= (int32_t) HDMI_HEALTH_PERIOD_MS)
+  {
+    hdmi_health_tick = HAL_GetTick();
+    HDMI_start_health();
+  }
+  if (hdmi_state == HDMI_STATE_CONFIGURED || HAL_GetTick() - hdmi_poll_tick < HDMI_POLL_MS)
+  {
+    return hdmi_state;
+  }
+  hdmi_poll_tick = HAL_GetTick();
+
+  switch (hdmi_state)
+  {
+  case HDMI_STATE_WAIT_HPD:
+    /* Poll cable is connected (read HPD pin status) */
+    HDMI_queue_start();
+    HDMI_read(ADV7513_I2C_ADDR, 0x42, &hdmi_regs[0], 1);
+    hdmi_read = HDMI_READ_HPD;
+    break;
+  case HDMI_STATE_POWERED:
+    /* TMDS PLL locked on the LTDC pixel clock, monitor EDID read */
+    HDMI_queue_start();
+    HDMI_read(ADV7513_I2C_ADDR, 0x9e, &hdmi_regs[0], 1);
+    HDMI_read(ADV7513_I2C_ADDR, 0x96, &hdmi_regs[1], 1);
+    hdmi_read = HDMI_READ_STATUS;
+    break;
+  default:
+    break;
+  }
+  /* Not queued: polled again */
+  if (hdmi_read != HDMI_READ_NONE && hdmi_queue_error != HDMI_I2C_ERROR_NONE)
+  {
+    hdmi_read = HDMI_READ_NONE;
+  }
+
+  return hdmi_state;
+}
+
+/**
+  * @brief  Identifies the monitor, valid once HDMI_STATE_CONFIGURED
+  * @retval CRC-32 of the EDID base block, 0 if the monitor has none
+  */
+uint32_t HDMI_GetEdidHash(void)
+{
+  return hdmi_edid_hash;
+}
+
+/**
+  * @brief  Link health counters since boot
+  * @note   Once configured, HDMI_Process() checks HPD, monitor sense, TMDS
+  *         PLL lock and power-down every HDMI_HEALTH_PERIOD_MS and recovers
+  *         the link. Losses and recovery times are also in the trace.
+  */
+void HDMI_GetHealth(HDMI_Health_t *health)
+{
+  *health = hdmi_health;
+}
+
+void HDMI_Init(void)
+{
+  HDMI_Start();
+  while (HDMI_Process() != HDMI_STATE_CONFIGURED)
+  {
+    /* Reads are handled as soon as done, registers polled every HDMI_POLL_MS */
+    HAL_Delay(hdmi_read != HDMI_READ_NONE ? 1 : HDMI_POLL_MS);
+  }
+  /* Mode and InfoFrame sent */
+  (void) HDMI_I2C_Sync();
 }
@@ -0,0 +1,624 @@
+ /**
+ ******************************************************************************
+ * @file    hdmi_i2c.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "hdmi_i2c.h"
+#include "cache_ctl.h"
+#include "cpu_load.h"
+#include "stm32n6xx_hal.h"
+#include "stm32n6570_discovery_bus.h"
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define HDMI_I2C_IRQ_PRIO      8
+/* Longest transfer: 128 bytes at 100 kHz take 12 ms */
+#define HDMI_I2C_TIMEOUT_MS   25U
+
+#define HDMI_I2C_OP_WRITE      0U
+#define HDMI_I2C_OP_UPDATE     1U  /*!< Read-modify-write of one register */
+#define HDMI_I2C_OP_READ       2U
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint8_t type;           /*!< HDMI_I2C_OP_xxx */
+  uint8_t dev;
+  uint8_t reg;
+  uint8_t mask;           /*!< Update: bits replaced by data[0] */
+  uint16_t size;
+  uint8_t *dest;          /*!< Read: caller buffer */
+  uint8_t data[HDMI_I2C_WRITE_MAX];
+} HDMI_I2C_Op_t;
+
+/* I2C specification minimums, per mode */
+typedef struct
+{
+  uint32_t low_ns;        /*!< SCL low */
+  uint32_t high_ns;       /*!< SCL high */
+  uint32_t setup_ns;      /*!< Data setup, SDA rise time included */
+} HDMI_I2C_Spec_t;
+
+/* Private variables ---------------------------------------------------------*/
+static const HDMI_I2C_Spec_t hdmi_i2c_spec[3] = {
+  { 4700, 4000, 1250 },   /* Standard-mode */
+  { 1300,  600,  400 },   /* Fast-mode */
+  {  500,  260,  170 },   /* Fast-mode Plus */
+};
+
+static int hdmi_i2c_ready;
+static uint32_t hdmi_i2c_speed;
+static DMA_HandleTypeDef hdmi_i2c_hdma_tx;
+static DMA_HandleTypeDef hdmi_i2c_hdma_rx;
+static HDMI_I2C_Stats_t hdmi_i2c_stats;
+
+/* Queue: ops n in [tail, head) at hdmi_i2c_ops[n % HDMI_I2C_OP_NB], the op
+ * at tail is on the bus while active */
+static HDMI_I2C_Op_t hdmi_i2c_ops[HDMI_I2C_OP_NB];
+static uint32_t hdmi_i2c_head;
+static volatile uint32_t hdmi_i2c_tail;
+static volatile int hdmi_i2c_active;
+static volatile uint32_t hdmi_i2c_active_tick;
+static volatile int32_t hdmi_i2c_error;
+
+/* Transfers are copied here: caller buffers need no alignment */
+__attribute__ ((aligned (32)))
+static uint8_t hdmi_i2c_dma[HDMI_I2C_READ_MAX];
+
+/* Private functions ---------------------------------------------------------*/
+/* Queue is updated from the I2C and DMA interrupts */
+static uint32_t HDMI_I2C_lock(void)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+
+  return primask;
+}
+
+static void HDMI_I2C_unlock(uint32_t primask)
+{
+  __set_PRIMASK(primask);
+}
+
+static HDMI_I2C_Op_t *HDMI_I2C_slot(uint32_t n)
+{
+  return &hdmi_i2c_ops[n % HDMI_I2C_OP_NB];
+}
+
+/*
+ * TIMINGR from the I2C kernel clock: SCL low and high in proportion of their
+ * minimums, no extra SDA hold. SCL synchronization and the analog filter
+ * come on top, SCL ends up slightly below the nominal frequency.
+ */
+static uint32_t HDMI_I2C_timing(uint32_t clock_hz, uint32_t speed_hz)
+{
+  const HDMI_I2C_Spec_t *spec = &hdmi_i2c_spec[speed_hz > HDMI_I2C_SPEED_FAST ? 2 :
+                                               speed_hz > HDMI_I2C_SPEED_STANDARD ? 1 : 0];
+  uint32_t presc = 0;
+  uint32_t period, low, high, setup, tick_ns;
+
+  /* SCLL and SCLH are 8-bit: keep the period within 384 prescaled clocks */
+  while (presc < 15 && clock_hz / (presc + 1) / speed_hz > 384)
+  {
+    presc++;
+  }
+  period = clock_hz / (presc + 1) / speed_hz;
+  tick_ns = (uint32_t)((1000000000ULL * (presc + 1) + clock_hz - 1) / clock_hz);
+
+  low = period * spec->low_ns / (spec->low_ns + spec->high_ns);
+  high = period - low;
+  setup = (spec->setup_ns + tick_ns - 1) / tick_ns;
+  low = low < 1 ? 1 : low;
+  high = high < 1 ? 1 : high;
+  setup = setup < 1 ? 1 : setup > 16 ? 16 : setup;
+
+  return (presc << 28) | ((setup - 1) << 20) | ((high - 1) << 8) | (low - 1);
+}
+
+static HAL_StatusTypeDef HDMI_I2C_init_dma(DMA_HandleTypeDef *hdma, DMA_Channel_TypeDef *channel,
+                                           uint32_t request, uint32_t direction)
+{
+  hdma->Instance = channel;
+  hdma->Init.Request = request;
+  hdma->Init.BlkHWRequest = DMA_BREQ_SINGLE_BURST;
+  hdma->Init.Direction = direction;
+  hdma->Init.SrcInc = direction == DMA_MEMORY_TO_PERIPH ? DMA_SINC_INCREMENTED : DMA_SINC_FIXED;
+  hdma->Init.DestInc = direction == DMA_MEMORY_TO_PERIPH ? DMA_DINC_FIXED : DMA_DINC_INCREMENTED;
+  hdma->Init.SrcDataWidth = DMA_SRC_DATAWIDTH_BYTE;
+  hdma->Init.DestDataWidth = DMA_DEST_DATAWIDTH_BYTE;
+  hdma->Init.Priority = DMA_LOW_PRIORITY_LOW_WEIGHT;
+  hdma->Init.SrcBurstLength = 1;
+  hdma->Init.DestBurstLength = 1;
+  hdma->Init.TransferAllocatedPort = DMA_SRC_ALLOCATED_PORT0 | DMA_DEST_ALLOCATED_PORT0;
+  hdma->Init.TransferEventMode = DMA_TCEM_BLOCK_TRANSFER;
+  hdma->Init.Mode = DMA_NORMAL;
+  if (HAL_DMA_Init(hdma) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  return HAL_DMA_ConfigChannelAttributes(hdma, DMA_CHANNEL_SEC | DMA_CHANNEL_PRIV |
+                                               DMA_CHANNEL_SRC_SEC | DMA_CHANNEL_DEST_SEC);
+}
+
+/* Bus timing of the BSP replaced, Fast-mode Plus drive above 400 kHz */
+static HAL_StatusTypeDef HDMI_I2C_configure(void)
+{
+  I2C_HandleTypeDef *hi2c = &hbus_i2c2;
+
+  hi2c->Init.Timing = HDMI_I2C_timing(HAL_RCCEx_GetPeriphCLKFreq(RCC_PERIPHCLK_I2C2), hdmi_i2c_speed);
+  if (HAL_I2C_Init(hi2c) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+#if defined(I2C_FASTMODEPLUS_ENABLE)
+  if (HAL_I2CEx_ConfigFastModePlus(hi2c, hdmi_i2c_speed > HDMI_I2C_SPEED_FAST ?
+                                         I2C_FASTMODEPLUS_ENABLE : I2C_FASTMODEPLUS_DISABLE) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+#endif
+
+  return HAL_OK;
+}
+
+/* Called with the queue locked or from interrupt: the rest of the queue is
+ * dropped, it usually depends on the failed transfer */
+static void HDMI_I2C_fail(void)
+{
+  hdmi_i2c_stats.errors++;
+  if (hdmi_i2c_error == HDMI_I2C_ERROR_NONE)
+  {
+    hdmi_i2c_error = HDMI_I2C_ERROR_BUS;
+  }
+  hdmi_i2c_tail = hdmi_i2c_head;
+  hdmi_i2c_active = 0;
+  hdmi_i2c_stats.idle_cycles = DWT->CYCCNT;
+}
+
+/* Called with the queue locked or from interrupt */
+static void HDMI_I2C_start(void)
+{
+  I2C_HandleTypeDef *hi2c = &hbus_i2c2;
+  HDMI_I2C_Op_t *op;
+  HAL_StatusTypeDef status;
+
+  while (!hdmi_i2c_active && hdmi_i2c_tail != hdmi_i2c_head)
+  {
+    op = HDMI_I2C_slot(hdmi_i2c_tail);
+    hdmi_i2c_active = 1;
+    hdmi_i2c_active_tick = HAL_GetTick();
+    if (op->type == HDMI_I2C_OP_WRITE)
+    {
+      memcpy(hdmi_i2c_dma, op->data, op->size);
+      CACHE_CTL_Clean(hdmi_i2c_dma, op->size);
+      status = HAL_I2C_Mem_Write_DMA(hi2c, op->dev, op->reg, I2C_MEMADD_SIZE_8BIT, hdmi_i2c_dma, op->size);
+    }
+    else
+    {
+      /* Updates read their register first */
+      status = HAL_I2C_Mem_Read_DMA(hi2c, op->dev, op->reg, I2C_MEMADD_SIZE_8BIT, hdmi_i2c_dma,
+                                    op->type == HDMI_I2C_OP_UPDATE ? 1 : op->size);
+    }
+    if (status != HAL_OK)
+    {
+      HDMI_I2C_fail();
+    }
+  }
+}
+
+/* Called from interrupt */
+static void HDMI_I2C_done(uint32_t bytes)
+{
+  hdmi_i2c_stats.transfers++;
+  hdmi_i2c_stats.bytes += bytes;
+  hdmi_i2c_tail++;
+  hdmi_i2c_active = 0;
+  if (hdmi_i2c_tail == hdmi_i2c_head)
+  {
+    hdmi_i2c_stats.idle_cycles = DWT->CYCCNT;
+  }
+  HDMI_I2C_start();
+}
+
+/* Op still waiting in the queue, that can be extended. Queue locked */
+static HDMI_I2C_Op_t *HDMI_I2C_last_waiting(void)
+{
+  if (hdmi_i2c_head == hdmi_i2c_tail || (hdmi_i2c_head - 1 == hdmi_i2c_tail && hdmi_i2c_active))
+  {
+    return NULL;
+  }
+
+  return HDMI_I2C_slot(hdmi_i2c_head - 1);
+}
+
+/* New op at head, queued by HDMI_I2C_push() once filled. Queue locked */
+static HDMI_I2C_Op_t *HDMI_I2C_new(void)
+{
+  if (hdmi_i2c_head - hdmi_i2c_tail == HDMI_I2C_OP_NB)
+  {
+    return NULL;
+  }
+
+  return HDMI_I2C_slot(hdmi_i2c_head);
+}
+
+static void HDMI_I2C_push(void)
+{
+  hdmi_i2c_head++;
+  if (hdmi_i2c_head - hdmi_i2c_tail > hdmi_i2c_stats.max_queued)
+  {
+    hdmi_i2c_stats.max_queued = hdmi_i2c_head - hdmi_i2c_tail;
+  }
+  HDMI_I2C_start();
+}
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+  * @brief  Take the I2C2 bus for the HDMI transmitter
+  * @note   The BSP sets the bus up (pins, clocks), its timing is then
+  *         replaced. 1 MHz Fast-mode Plus needs pull-ups sized for it and is
+  *         beyond the 400 kHz the ADV7513 is specified for: use it only where
+  *         the board was validated, see HDMI_BUS_SPEED in hdmi.c. Calling it
+  *         again changes the speed.
+  * @param  speed_hz HDMI_I2C_SPEED_xxx
+  * @retval HDMI_I2C_ERROR_NONE, HDMI_I2C_ERROR_PARAM or HDMI_I2C_ERROR_HAL
+  */
+int32_t HDMI_I2C_Init(uint32_t speed_hz)
+{
+  I2C_HandleTypeDef *hi2c = &hbus_i2c2;
+
+  if (speed_hz == 0)
+  {
+    return HDMI_I2C_ERROR_PARAM;
+  }
+  if (hdmi_i2c_ready)
+  {
+    HDMI_I2C_DeInit();
+  }
+
+  if (BSP_I2C2_Init() != BSP_ERROR_NONE)
+  {
+    return HDMI_I2C_ERROR_HAL;
+  }
+  hdmi_i2c_speed = speed_hz;
+  if (HDMI_I2C_configure() != HAL_OK)
+  {
+    BSP_I2C2_DeInit();
+    return HDMI_I2C_ERROR_HAL;
+  }
+
+  __HAL_RCC_GPDMA1_CLK_ENABLE();
+  if (HDMI_I2C_init_dma(&hdmi_i2c_hdma_tx, GPDMA1_Channel2, GPDMA1_REQUEST_I2C2_TX,
+                        DMA_MEMORY_TO_PERIPH) != HAL_OK ||
+      HDMI_I2C_init_dma(&hdmi_i2c_hdma_rx, GPDMA1_Channel3, GPDMA1_REQUEST_I2C2_RX,
+                        DMA_PERIPH_TO_MEMORY) != HAL_OK)
+  {
+    BSP_I2C2_DeInit();
+    return HDMI_I2C_ERROR_HAL;
+  }
+  __HAL_LINKDMA(hi2c, hdmatx, hdmi_i2c_hdma_tx);
+  __HAL_LINKDMA(hi2c, hdmarx, hdmi_i2c_hdma_rx);
+
+  hdmi_i2c_head = 0;
+  hdmi_i2c_tail = 0;
+  hdmi_i2c_active = 0;
+  hdmi_i2c_error = HDMI_I2C_ERROR_NONE;
+
+  HAL_NVIC_SetPriority(I2C2_EV_IRQn, HDMI_I2C_IRQ_PRIO, 0);
+  HAL_NVIC_SetPriority(I2C2_ER_IRQn, HDMI_I2C_IRQ_PRIO, 0);
+  HAL_NVIC_SetPriority(GPDMA1_Channel2_IRQn, HDMI_I2C_IRQ_PRIO, 0);
+  HAL_NVIC_SetPriority(GPDMA1_Channel3_IRQn, HDMI_I2C_IRQ_PRIO, 0);
+  HAL_NVIC_EnableIRQ(I2C2_EV_IRQn);
+  HAL_NVIC_EnableIRQ(I2C2_ER_IRQn);
+  HAL_NVIC_EnableIRQ(GPDMA1_Channel2_IRQn);
+  HAL_NVIC_EnableIRQ(GPDMA1_Channel3_IRQn);
+
+  hdmi_i2c_ready = 1;
+
+  return HDMI_I2C_ERROR_NONE;
+}
+
+/**
+  * @brief  Release the bus once the queued transfers are done
+  */
+void HDMI_I2C_DeInit(void)
+{
+  if (!hdmi_i2c_ready)
+  {
+    return;
+  }
+
+  (void) HDMI_I2C_Sync();
+  HAL_NVIC_DisableIRQ(I2C2_EV_IRQn);
+  HAL_NVIC_DisableIRQ(I2C2_ER_IRQn);
+  HAL_NVIC_DisableIRQ(GPDMA1_Channel2_IRQn);
+  HAL_NVIC_DisableIRQ(GPDMA1_Channel3_IRQn);
+  (void) HAL_DMA_DeInit(&hdmi_i2c_hdma_tx);
+  (void) HAL_DMA_DeInit(&hdmi_i2c_hdma_rx);
+  hbus_i2c2.hdmatx = NULL;
+  hbus_i2c2.hdmarx = NULL;
+  BSP_I2C2_DeInit();
+  hdmi_i2c_ready = 0;
+}
+
+/**
+  * @brief  Speed of the last HDMI_I2C_Init(), 0 if none
+  */
+uint32_t HDMI_I2C_GetSpeed(void)
+{
+  return hdmi_i2c_speed;
+}
+
+/**
+  * @brief  Queue a write of consecutive registers, never waits
+  * @note   Appended to the previous queued write when it ends at reg.
+  * @param  dev 8-bit I2C address
+  * @param  reg First register
+  * @param  data Register values, copied
+  * @param  size Up to HDMI_I2C_WRITE_MAX
+  * @retval HDMI_I2C_ERROR_NONE, HDMI_I2C_ERROR_FULL or HDMI_I2C_ERROR_PARAM
+  */
+int32_t HDMI_I2C_Write(uint16_t dev, uint8_t reg, const uint8_t *data, uint16_t size)
+{
+  HDMI_I2C_Op_t *op;
+  uint32_t primask;
+
+  if (!hdmi_i2c_ready || size == 0 || size > HDMI_I2C_WRITE_MAX)
+  {
+    return HDMI_I2C_ERROR_PARAM;
+  }
+
+  primask = HDMI_I2C_lock();
+  op = HDMI_I2C_last_waiting();
+  if (op != NULL && op->type == HDMI_I2C_OP_WRITE && op->dev == dev && op->reg + op->size == reg &&
+      op->size + size <= HDMI_I2C_WRITE_MAX)
+  {
+    memcpy(&op->data[op->size], data, size);
+    op->size += size;
+    hdmi_i2c_stats.merged++;
+    HDMI_I2C_unlock(primask);
+    return HDMI_I2C_ERROR_NONE;
+  }
+
+  op = HDMI_I2C_new();
+  if (op == NULL)
+  {
+    HDMI_I2C_unlock(primask);
+    return HDMI_I2C_ERROR_FULL;
+  }
+  op->type = HDMI_I2C_OP_WRITE;
+  op->dev = (uint8_t) dev;
+  op->reg = reg;
+  op->size = size;
+  memcpy(op->data, data, size);
+  HDMI_I2C_push();
+  HDMI_I2C_unlock(primask);
+
+  return HDMI_I2C_ERROR_NONE;
+}
+
+/**
+  * @brief  Queue a read-modify-write of one register, never waits
+  * @note   Folded into the previous queued update of the same register.
+  * @param  dev 8-bit I2C address
+  * @param  reg Register
+  * @param  value New value of the bits in mask
+  * @param  mask Bits changed
+  * @retval HDMI_I2C_ERROR_NONE, HDMI_I2C_ERROR_FULL or HDMI_I2C_ERROR_PARAM
+  */
+int32_t HDMI_I2C_Update(uint16_t dev, uint8_t reg, uint8_t value, uint8_t mask)
+{
+  HDMI_I2C_Op_t *op;
+  uint32_t primask;
+
+  if (!hdmi_i2c_ready)
+  {
+    return HDMI_I2C_ERROR_PARAM;
+  }
+
+  primask = HDMI_I2C_lock();
+  op = HDMI_I2C_last_waiting();
+  if (op != NULL && op->type == HDMI_I2C_OP_UPDATE && op->dev == dev && op->reg == reg)
+  {
+    op->data[0] = (op->data[0] & ~mask) | (value & mask);
+    op->mask |= mask;
+    hdmi_i2c_stats.merged++;
+    HDMI_I2C_unlock(primask);
+    return HDMI_I2C_ERROR_NONE;
+  }
+
+  op = HDMI_I2C_new();
+  if (op == NULL)
+  {
+    HDMI_I2C_unlock(primask);
+    return HDMI_I2C_ERROR_FULL;
+  }
+  op->type = HDMI_I2C_OP_UPDATE;
+  op->dev = (uint8_t) dev;
+  op->reg = reg;
+  op->size = 1;
+  op->data[0] = value & mask;
+  op->mask = mask;
+  HDMI_I2C_push();
+  HDMI_I2C_unlock(primask);
+
+  return HDMI_I2C_ERROR_NONE;
+}
+
+/**
+  * @brief  Queue a read of consecutive registers, never waits
+  * @param  dev 8-bit I2C address
+  * @param  reg First register
+  * @param  data Written from interrupt, valid once HDMI_I2C_Poll() is no
+  *         longer busy and returned no error
+  * @param  size Up to HDMI_I2C_READ_MAX
+  * @retval HDMI_I2C_ERROR_NONE, HDMI_I2C_ERROR_FULL or HDMI_I2C_ERROR_PARAM
+  */
+int32_t HDMI_I2C_Read(uint16_t dev, uint8_t reg, uint8_t *data, uint16_t size)
+{
+  HDMI_I2C_Op_t *op;
+  uint32_t primask;
+
+  if (!hdmi_i2c_ready || size == 0 || size > HDMI_I2C_READ_MAX)
+  {
+    return HDMI_I2C_ERROR_PARAM;
+  }
+
+  primask = HDMI_I2C_lock();
+  op = HDMI_I2C_new();
+  if (op == NULL)
+  {
+    HDMI_I2C_unlock(primask);
+    return HDMI_I2C_ERROR_FULL;
+  }
+  op->type = HDMI_I2C_OP_READ;
+  op->dev = (uint8_t) dev;
+  op->reg = reg;
+  op->size = size;
+  op->dest = data;
+  HDMI_I2C_push();
+  HDMI_I2C_unlock(primask);
+
+  return HDMI_I2C_ERROR_NONE;
+}
+
+/**
+  * @brief  State of the queued transfers, never waits
+  * @note   A transfer not completed within HDMI_I2C_TIMEOUT_MS (stuck bus,
+  *         lost interrupt) is aborted and the I2C peripheral reset.
+  * @retval HDMI_I2C_ERROR_BUSY while transfers are queued, then the first
+  *         error since the previous call, cleared
+  */
+int32_t HDMI_I2C_Poll(void)
+{
+  I2C_HandleTypeDef *hi2c = &hbus_i2c2;
+  uint32_t primask;
+  int32_t ret;
+
+  primask = HDMI_I2C_lock();
+  if (hdmi_i2c_tail != hdmi_i2c_head)
+  {
+    if (HAL_GetTick() - hdmi_i2c_active_tick <= HDMI_I2C_TIMEOUT_MS)
+    {
+      HDMI_I2C_unlock(primask);
+      return HDMI_I2C_ERROR_BUSY;
+    }
+    HDMI_I2C_fail();
+    (void) HAL_DMA_Abort(&hdmi_i2c_hdma_tx);
+    (void) HAL_DMA_Abort(&hdmi_i2c_hdma_rx);
+    /* Pins and DMA links are kept, the peripheral state machine restarts */
+    (void) HAL_I2C_DeInit(hi2c);
+    (void) HDMI_I2C_configure();
+  }
+  ret = hdmi_i2c_error;
+  hdmi_i2c_error = HDMI_I2C_ERROR_NONE;
+  HDMI_I2C_unlock(primask);
+
+  return ret;
+}
+
+/**
+  * @brief  Wait for the queued transfers, sleeping meanwhile
+  * @retval First error since the previous HDMI_I2C_Poll(), cleared
+  */
+int32_t HDMI_I2C_Sync(void)
+{
+  uint32_t primask;
+  int32_t ret;
+
+  while ((ret = HDMI_I2C_Poll()) == HDMI_I2C_ERROR_BUSY)
+  {
+    /* Masked: the completion interrupt cannot fire between check and sleep */
+    primask = HDMI_I2C_lock();
+    if (hdmi_i2c_tail != hdmi_i2c_head)
+    {
+      CPU_LOAD_Sleep();
+    }
+    HDMI_I2C_unlock(primask);
+  }
+
+  return ret;
+}
+
+void HDMI_I2C_GetStats(HDMI_I2C_Stats_t *stats)
+{
+  uint32_t primask = HDMI_I2C_lock();
+
+  *stats = hdmi_i2c_stats;
+  HDMI_I2C_unlock(primask);
+}
+
+/**
+  * @brief  Write transfer done: next op
+  */
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  if (hi2c != &hbus_i2c2 || !hdmi_i2c_active)
+  {
+    return;
+  }
+
+  HDMI_I2C_done(HDMI_I2C_slot(hdmi_i2c_tail)->size);
+}
+
+/**
+  * @brief  Read transfer done: data to the caller, or register of an update
+  *         written back
+  */
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  HDMI_I2C_Op_t *op = HDMI_I2C_slot(hdmi_i2c_tail);
+
+  if (hi2c != &hbus_i2c2 || !hdmi_i2c_active)
+  {
+    return;
+  }
+
+  CACHE_CTL_Invalidate(hdmi_i2c_dma, op->size);
+  if (op->type == HDMI_I2C_OP_READ)
+  {
+    memcpy(op->dest, hdmi_i2c_dma, op->size);
+    HDMI_I2C_done(op->size);
+    return;
+  }
+
+  hdmi_i2c_stats.transfers++;
+  hdmi_i2c_stats.bytes++;
+  hdmi_i2c_dma[0] = (hdmi_i2c_dma[0] & ~op->mask) | op->data[0];
+  CACHE_CTL_Clean(hdmi_i2c_dma, 1);
+  /* Timeout of the write back counted from its own start */
+  hdmi_i2c_active_tick = HAL_GetTick();
+  if (HAL_I2C_Mem_Write_DMA(hi2c, op->dev, op->reg, I2C_MEMADD_SIZE_8BIT, hdmi_i2c_dma, 1) != HAL_OK)
+  {
+    HDMI_I2C_fail();
+  }
+}
+
+/**
+  * @brief  NACK, bus or arbitration error: the queue is flushed
+  */
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+  if (hi2c != &hbus_i2c2 || !hdmi_i2c_active)
+  {
+    return;
+  }
+
+  HDMI_I2C_fail();
+}
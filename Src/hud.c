@@ -0,0 +1,212 @@
+ /**
+ ******************************************************************************
+ * @file    hud.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "hud.h"
+#include "frame_meta.h"
+#include "perf_mon.h"
+#include "cpu_load.h"
+#include "lcd_layer.h"
+#include "psram_tune.h"
+#include "scanline.h"
+#include "stm32_lcd.h"
+#include "stm32_lcd_ex.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define HUD_VBLANK_BUDGET   4U
+
+/* Private variables ---------------------------------------------------------*/
+static HUD_Conf_t hud_conf;
+static int hud_visible;
+static uint32_t hud_tick;
+static volatile uint32_t hud_vblanks;
+static uint32_t hud_last_vblanks;
+static uint32_t hud_last_underruns;
+static FRAME_META_Stats_t hud_last_frames;
+static uint32_t hud_pmu_region;
+/* Characters on screen, 0 forces a redraw */
+static char hud_shown[HUD_LINE_NB][HUD_LINE_CHARS];
+
+static const char *const hud_region_labels[PERF_MON_REGION_NB] = { "ISP", "OVL", "CAM", "LTD" };
+
+/* Private functions ---------------------------------------------------------*/
+/* Vblank scanline job: counts refreshes, lets the next underrun be reported */
+static void HUD_on_vblank(void *arg)
+{
+  (void) arg;
+
+  hud_vblanks++;
+  LCD_LAYER_RearmUnderrun();
+}
+
+/* Only characters that differ from the ones on screen are drawn */
+static void HUD_draw(uint32_t line, const char *text)
+{
+  uint32_t i;
+
+  for (i = 0; i < HUD_LINE_CHARS; i++)
+  {
+    if (hud_shown[line][i] != text[i])
+    {
+      UTIL_LCD_DisplayChar(COL(i), LINE(hud_conf.first_line + line), (uint8_t) text[i]);
+      hud_shown[line][i] = text[i];
+    }
+  }
+}
+
+static void HUD_printf(uint32_t line, const char *format, ...)
+{
+  char text[HUD_LINE_CHARS + 1];
+  va_list args;
+  int len;
+
+  va_start(args, format);
+  len = vsnprintf(text, sizeof(text), format, args);
+  va_end(args);
+
+  len = len < 0 ? 0 : len;
+  len = len < (int) HUD_LINE_CHARS ? len : (int) HUD_LINE_CHARS;
+  memset(&text[len], ' ', HUD_LINE_CHARS - len);
+  HUD_draw(line, text);
+}
+
+/* Count per period as x.y per second */
+static uint32_t HUD_rate_x10(uint32_t count, uint32_t elapsed_ms)
+{
+  return elapsed_ms ? (uint32_t)(((uint64_t)count * 10000U) / elapsed_ms) : 0;
+}
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+  * @brief  Start measuring, the HUD is hidden until HUD_SetVisible()
+  * @param  conf Layout and PSRAM traffic of the display and camera streams
+  * @retval HUD_ERROR_NONE or HUD_ERROR_SCANLINE
+  */
+int32_t HUD_Init(const HUD_Conf_t *conf)
+{
+  hud_conf = *conf;
+  hud_visible = 0;
+  hud_tick = HAL_GetTick();
+  hud_last_vblanks = hud_vblanks;
+  hud_last_underruns = LCD_LAYER_GetUnderruns();
+  FRAME_META_GetStats(&hud_last_frames);
+  hud_pmu_region = 0;
+
+  if (SCANLINE_Add(conf->vblank_line, HUD_VBLANK_BUDGET, 1, HUD_on_vblank, NULL) < 0)
+  {
+    return HUD_ERROR_SCANLINE;
+  }
+
+  return HUD_ERROR_NONE;
+}
+
+void HUD_SetVisible(int visible)
+{
+  char blank[HUD_LINE_CHARS];
+  uint32_t line;
+
+  hud_visible = visible;
+  if (visible)
+  {
+    /* Drawn at next period */
+    return;
+  }
+
+  memset(blank, ' ', sizeof(blank));
+  for (line = 0; line < HUD_LINE_NB; line++)
+  {
+    HUD_draw(line, blank);
+  }
+}
+
+/**
+  * @brief  Update the HUD once per period, from the application loop
+  * @note   Lines: display new frames / refreshes per second and camera fps;
+  *         frames dropped, repeated and LTDC underruns during the period; ISP
+  *         time per camera frame and CPU load; PSRAM traffic of the display
+  *         and camera streams; PMU counters of one code region, in turn.
+  * @param  pmu Counters of each region over the period, PERF_MON_GetStats()
+  * @retval None
+  */
+void HUD_Process(const PERF_MON_Stats_t *pmu)
+{
+  FRAME_META_Stats_t frames;
+  const PERF_MON_Stats_t *stats;
+  uint32_t elapsed_ms = HAL_GetTick() - hud_tick;
+  uint32_t vblanks, underruns, captured, presented, isp_us, psram_mbps, runs, stall_pct;
+  uint32_t vblank_count = hud_vblanks;
+
+  if (elapsed_ms == 0)
+  {
+    return;
+  }
+  hud_tick += elapsed_ms;
+
+  FRAME_META_GetStats(&frames);
+  vblanks = vblank_count - hud_last_vblanks;
+  underruns = LCD_LAYER_GetUnderruns() - hud_last_underruns;
+  captured = frames.captured - hud_last_frames.captured;
+  presented = frames.presented - hud_last_frames.presented;
+
+  if (hud_visible)
+  {
+    /* Overlay drawing cost is reported next period */
+    PERF_MON_Begin(PERF_MON_REGION_OVERLAY);
+
+    HUD_printf(0, "disp %2lu.%lu/%2lu cam %2lu.%lu",
+               (unsigned long)(HUD_rate_x10(presented, elapsed_ms) / 10),
+               (unsigned long)(HUD_rate_x10(presented, elapsed_ms) % 10),
+               (unsigned long)((HUD_rate_x10(vblanks, elapsed_ms) + 5) / 10),
+               (unsigned long)(HUD_rate_x10(captured, elapsed_ms) / 10),
+               (unsigned long)(HUD_rate_x10(captured, elapsed_ms) % 10));
+
+    HUD_printf(1, "drop %lu rep %lu ur %lu",
+               (unsigned long)(frames.dropped - hud_last_frames.dropped),
+               (unsigned long)(frames.repeated - hud_last_frames.repeated),
+               (unsigned long) underruns);
+
+    /* Skipped ISP runs included: this is the cost per camera frame */
+    isp_us = (uint32_t)((uint64_t)pmu[PERF_MON_REGION_ISP].cycles / (captured ? captured : 1) /
+                        (SystemCoreClock / 1000000U));
+    HUD_printf(2, "ISP %4luus/f cpu %2lu%%", (unsigned long) isp_us, (unsigned long) CPU_LOAD_GetPercent());
+
+    /* LTDC fetches and DCMIPP writes only, CPU accesses are not included */
+    psram_mbps = (uint32_t)((((uint64_t)hud_conf.display_bytes * vblanks +
+                              (uint64_t)hud_conf.camera_bytes * captured) * 1000U / elapsed_ms) / 1000000U);
+    HUD_printf(3, "PSRAM@%lu ~%lu MB/s", (unsigned long)(PSRAM_TUNE_GetClock() / 1000000U),
+               (unsigned long) psram_mbps);
+
+    stats = &pmu[hud_pmu_region];
+    runs = stats->runs ? stats->runs : 1;
+    stall_pct = stats->cycles ? (uint32_t)(((uint64_t)stats->stalls * 100U) / stats->cycles) : 0;
+    HUD_printf(4, "%s%5luus m%5lu s%2lu%%", hud_region_labels[hud_pmu_region],
+               (unsigned long)(stats->cycles / runs / (SystemCoreClock / 1000000U)),
+               (unsigned long)(stats->dcache_misses / runs),
+               (unsigned long)(stall_pct < 99 ? stall_pct : 99));
+    hud_pmu_region = (hud_pmu_region + 1) % PERF_MON_REGION_NB;
+
+    PERF_MON_End(PERF_MON_REGION_OVERLAY);
+  }
+
+  hud_last_vblanks = vblank_count;
+  hud_last_underruns += underruns;
+  hud_last_frames = frames;
+}
@@ -0,0 +1,296 @@
+ /**
+ ******************************************************************************
+ * @file    iq_profile.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "iq_profile.h"
+#include "cmw_camera.h"
+#include "isp_api.h"
+#include "isp_services.h"
+#include "isp_param_conf.h"
+#include "isp_sched.h"
+#include "nvm.h"
+#include <string.h>
+#include <stdio.h>
+
+#if defined(DEBUG)
+#define PRINTF(...)    printf(__VA_ARGS__)
+#else
+#define PRINTF(...)
+#endif /* defined(DEBUG) */
+
+/* Private variables ---------------------------------------------------------*/
+/* Tables handed to the ISP through ISP_IQParamCacheInit[] at camera init */
+ISP_IQParamTypeDef iq_profile_active[IQ_PROFILE_TABLE_NB];
+
+static const ISP_IQParamTypeDef *const iq_profile_builtin[IQ_PROFILE_TABLE_NB] = {
+  [IQ_PROFILE_TABLE_IMX335] = &ISP_IQParamCacheInit_IMX335,
+  [IQ_PROFILE_TABLE_VD66GY] = &ISP_IQParamCacheInit_VD66GY,
+};
+
+static ISP_IQParamTypeDef iq_profile_staged;
+/* Names of the profile in use and of the staged one, NUL terminated */
+static char iq_profile_name[IQ_PROFILE_NAME_LEN + 1] = "built-in";
+static char iq_profile_staged_name[IQ_PROFILE_NAME_LEN + 1];
+static int32_t iq_profile_current = IQ_PROFILE_BUILTIN;
+static int32_t iq_profile_staged_profile;
+static int32_t iq_profile_staged_table;
+static volatile int iq_profile_pending;
+
+/* Private functions ---------------------------------------------------------*/
+static int32_t IQ_PROFILE_read_header(int32_t profile, IQ_PROFILE_Header_t *hdr)
+{
+  if (profile < 0 || profile >= NVM_IQ_PROFILE_NB)
+  {
+    return IQ_PROFILE_ERROR_PARAM;
+  }
+  if (NVM_ReadRaw(NVM_IQ_PROFILE_OFFSET(profile), hdr, sizeof(*hdr)) != NVM_ERROR_NONE)
+  {
+    return IQ_PROFILE_ERROR_NVM;
+  }
+  if (hdr->magic != IQ_PROFILE_MAGIC || hdr->version != IQ_PROFILE_VERSION ||
+      hdr->param_size != sizeof(ISP_IQParamTypeDef) || hdr->count == 0 ||
+      sizeof(*hdr) + hdr->count * hdr->param_size > NVM_IQ_PROFILE_SIZE)
+  {
+    return IQ_PROFILE_ERROR_FORMAT;
+  }
+
+  return IQ_PROFILE_ERROR_NONE;
+}
+
+/* Check the CRC of the whole image, then extract one table */
+static int32_t IQ_PROFILE_read_table(int32_t profile, const IQ_PROFILE_Header_t *hdr, int32_t table,
+                                     ISP_IQParamTypeDef *out)
+{
+  uint32_t base = NVM_IQ_PROFILE_OFFSET(profile) + sizeof(*hdr);
+  uint32_t remaining = hdr->count * hdr->param_size;
+  uint32_t offset = base;
+  uint32_t crc = 0;
+  uint8_t chunk[64];
+
+  if (table < 0 || table >= hdr->count)
+  {
+    return IQ_PROFILE_ERROR_PARAM;
+  }
+
+  while (remaining)
+  {
+    uint32_t len = remaining < sizeof(chunk) ? remaining : sizeof(chunk);
+
+    if (NVM_ReadRaw(offset, chunk, len) != NVM_ERROR_NONE)
+    {
+      return IQ_PROFILE_ERROR_NVM;
+    }
+    crc = NVM_Crc32(crc, chunk, len);
+    offset += len;
+    remaining -= len;
+  }
+  if (crc != hdr->crc)
+  {
+    return IQ_PROFILE_ERROR_FORMAT;
+  }
+
+  if (NVM_ReadRaw(base + table * hdr->param_size, out, sizeof(*out)) != NVM_ERROR_NONE)
+  {
+    return IQ_PROFILE_ERROR_NVM;
+  }
+
+  return IQ_PROFILE_ERROR_NONE;
+}
+
+/* Header names are not NUL terminated when they fill the field */
+static void IQ_PROFILE_set_name(char dst[IQ_PROFILE_NAME_LEN + 1], const char *src)
+{
+  strncpy(dst, src, IQ_PROFILE_NAME_LEN);
+  dst[IQ_PROFILE_NAME_LEN] = '\0';
+}
+
+/*
+ * Push the static (non algorithm driven) blocks of the ISP through the ISP
+ * middleware: its IQ parameters follow, so the tuning tool and its algorithms
+ * see the profile in use. The DCMIPP registers are shadowed and latched at the
+ * next frame start.
+ */
+static void IQ_PROFILE_apply_hw(const ISP_IQParamTypeDef *iq)
+{
+  ISP_HandleTypeDef *hIsp = CMW_CAMERA_GetISPHandle();
+  ISP_IQParamTypeDef *param = ISP_SVC_IQParam_Get(hIsp);
+
+  param->badPixelStatic = iq->badPixelStatic;
+  (void) ISP_SVC_ISP_SetBadPixel(hIsp, &param->badPixelStatic);
+
+  param->blackLevelStatic = iq->blackLevelStatic;
+  (void) ISP_SVC_ISP_SetBlackLevel(hIsp, &param->blackLevelStatic);
+
+  /* Monochrome sensors have no demosaicing, leave the block alone */
+  if (iq->demosaicing.enable && iq->demosaicing.type != ISP_DEMOS_TYPE_MONO)
+  {
+    param->demosaicing = iq->demosaicing;
+    (void) ISP_SVC_ISP_SetDemosaicing(hIsp, &param->demosaicing);
+  }
+
+  /* Coefficients in percents, converted by the middleware */
+  param->contrast = iq->contrast;
+  (void) ISP_SVC_ISP_SetContrast(hIsp, &param->contrast);
+
+  param->gamma = iq->gamma;
+  (void) ISP_SVC_ISP_SetGamma(hIsp, &param->gamma);
+}
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+  * @brief  Prepare the IQ tables used by the ISP at camera init
+  * @note   Must be called before CMW_CAMERA_Init(). Falls back to the built-in
+  *         tables of isp_param_conf.h if the profile is missing or invalid.
+  * @param  profile NOR profile index or IQ_PROFILE_BUILTIN
+  * @retval IQ_PROFILE_ERROR_NONE if the requested profile is in use
+  */
+int32_t IQ_PROFILE_Init(int32_t profile)
+{
+  IQ_PROFILE_Header_t hdr;
+  int32_t ret;
+  int32_t i;
+
+  for (i = 0; i < IQ_PROFILE_TABLE_NB; i++)
+  {
+    iq_profile_active[i] = *iq_profile_builtin[i];
+  }
+  iq_profile_current = IQ_PROFILE_BUILTIN;
+  iq_profile_pending = 0;
+  IQ_PROFILE_set_name(iq_profile_name, "built-in");
+
+  if (profile == IQ_PROFILE_BUILTIN)
+  {
+    return IQ_PROFILE_ERROR_NONE;
+  }
+
+  ret = IQ_PROFILE_read_header(profile, &hdr);
+  for (i = 0; ret == IQ_PROFILE_ERROR_NONE && i < IQ_PROFILE_TABLE_NB && i < hdr.count; i++)
+  {
+    ret = IQ_PROFILE_read_table(profile, &hdr, i, &iq_profile_active[i]);
+  }
+  if (ret != IQ_PROFILE_ERROR_NONE)
+  {
+    PRINTF("IQ profile %ld rejected (%ld), using built-in\n", (long) profile, (long) ret);
+    for (i = 0; i < IQ_PROFILE_TABLE_NB; i++)
+    {
+      iq_profile_active[i] = *iq_profile_builtin[i];
+    }
+    return ret;
+  }
+  iq_profile_current = profile;
+  IQ_PROFILE_set_name(iq_profile_name, hdr.name);
+
+  return IQ_PROFILE_ERROR_NONE;
+}
+
+/**
+  * @brief  Load a profile from NOR and schedule it for the next frame
+  * @note   Static ISP blocks (bad pixel, black level, demosaicing, contrast,
+  *         gamma) and fixed exposure/gain switch live. AE/AWB tuning tables are
+  *         owned by the ISP middleware and only follow at next camera init.
+  * @param  profile NOR profile index or IQ_PROFILE_BUILTIN
+  * @param  table IQ_PROFILE_TABLE_xxx of the running sensor
+  * @retval IQ_PROFILE_ERROR_NONE if the switch is pending
+  */
+int32_t IQ_PROFILE_Select(int32_t profile, int32_t table)
+{
+  IQ_PROFILE_Header_t hdr;
+  int32_t ret;
+
+  if (table < 0 || table >= IQ_PROFILE_TABLE_NB)
+  {
+    return IQ_PROFILE_ERROR_PARAM;
+  }
+  if (iq_profile_pending)
+  {
+    return IQ_PROFILE_ERROR_BUSY;
+  }
+
+  if (profile == IQ_PROFILE_BUILTIN)
+  {
+    iq_profile_staged = *iq_profile_builtin[table];
+    IQ_PROFILE_set_name(iq_profile_staged_name, "built-in");
+  }
+  else
+  {
+    ret = IQ_PROFILE_read_header(profile, &hdr);
+    if (ret == IQ_PROFILE_ERROR_NONE)
+    {
+      ret = IQ_PROFILE_read_table(profile, &hdr, table, &iq_profile_staged);
+    }
+    if (ret != IQ_PROFILE_ERROR_NONE)
+    {
+      return ret;
+    }
+    IQ_PROFILE_set_name(iq_profile_staged_name, hdr.name);
+  }
+
+  iq_profile_staged_profile = profile;
+  iq_profile_staged_table = table;
+  iq_profile_pending = 1;
+
+  return IQ_PROFILE_ERROR_NONE;
+}
+
+/**
+  * @brief  Apply a pending profile switch
+  * @note   Call from the app loop right after the camera vsync event: the
+  *         DCMIPP shadow registers written here latch on the next frame.
+  */
+void IQ_PROFILE_OnFrameStart(void)
+{
+  ISP_IQParamTypeDef *iq = &iq_profile_staged;
+
+  if (!iq_profile_pending)
+  {
+    return;
+  }
+
+  IQ_PROFILE_apply_hw(iq);
+
+  /* Without AE/AWB the ISP middleware has nothing left to do per frame */
+  if (!iq->AECAlgo.enable && !iq->AWBAlgo.enable)
+  {
+    ISP_SCHED_Hold(1);
+    CMW_CAMERA_SetExposure(iq->sensorExposureStatic.exposure);
+    CMW_CAMERA_SetGain(iq->sensorGainStatic.gain);
+  }
+  else
+  {
+    ISP_SCHED_Hold(0);
+    ISP_SCHED_Wake();
+  }
+
+  iq_profile_active[iq_profile_staged_table] = *iq;
+  iq_profile_current = iq_profile_staged_profile;
+  memcpy(iq_profile_name, iq_profile_staged_name, sizeof(iq_profile_name));
+  iq_profile_pending = 0;
+}
+
+int32_t IQ_PROFILE_GetCurrent(void)
+{
+  return iq_profile_current;
+}
+
+/**
+  * @brief  Name of the profile in use, the staged one once its switch applied
+  */
+const char *IQ_PROFILE_GetName(void)
+{
+  return iq_profile_name;
+}
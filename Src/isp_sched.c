@@ -0,0 +1,233 @@
+ /**
+ ******************************************************************************
+ * @file    isp_sched.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "isp_sched.h"
+#include "cmw_camera.h"
+#include "trace.h"
+#include "perf_mon.h"
+#include <assert.h>
+
+/* Private define ------------------------------------------------------------*/
+/* Exponential moving average weight, as a power of two */
+#define ISP_SCHED_AVG_SHIFT  3
+
+/* Private variables ---------------------------------------------------------*/
+static ISP_SCHED_Conf_t isp_sched_conf;
+static ISP_SCHED_Stats_t isp_sched_stats;
+static uint32_t isp_sched_countdown;
+static uint32_t isp_sched_unchanged_runs;
+static int64_t isp_sched_debt_us;
+/* Tuning tool command waiting for the next ISP run */
+static int isp_sched_kicked;
+static int32_t isp_sched_exposure;
+static int32_t isp_sched_gain;
+
+/* Private functions ---------------------------------------------------------*/
+static uint32_t ISP_SCHED_cycles_to_us(uint32_t cycles)
+{
+  return (uint32_t)(((uint64_t)cycles * 1000000U) / SystemCoreClock);
+}
+
+static void ISP_SCHED_update_avg(uint32_t *avg, uint32_t sample)
+{
+  if (*avg == 0)
+  {
+    *avg = sample;
+    return;
+  }
+  *avg = *avg - (*avg >> ISP_SCHED_AVG_SHIFT) + (sample >> ISP_SCHED_AVG_SHIFT);
+}
+
+/* AE convergence shows as sensor exposure/gain updates between two runs. AWB
+ * runs in the same ISP call and converges on the same statistics. */
+static void ISP_SCHED_track_convergence(void)
+{
+  int32_t exposure = isp_sched_exposure;
+  int32_t gain = isp_sched_gain;
+
+  if (CMW_CAMERA_GetExposure(&exposure) != CMW_ERROR_NONE ||
+      CMW_CAMERA_GetGain(&gain) != CMW_ERROR_NONE)
+  {
+    /* Unknown state: stay on the fast rate */
+    isp_sched_unchanged_runs = 0;
+  }
+  else if (exposure != isp_sched_exposure || gain != isp_sched_gain)
+  {
+    isp_sched_unchanged_runs = 0;
+  }
+  else if (isp_sched_unchanged_runs < isp_sched_conf.stable_runs)
+  {
+    isp_sched_unchanged_runs++;
+  }
+
+  isp_sched_exposure = exposure;
+  isp_sched_gain = gain;
+  isp_sched_stats.exposure = exposure;
+  isp_sched_stats.gain = gain;
+  isp_sched_stats.converging = isp_sched_unchanged_runs < isp_sched_conf.stable_runs;
+}
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+  * @brief  Initialize the ISP scheduler
+  * @param  conf Scheduling policy, periods are expressed in camera frames
+  * @retval None
+  */
+void ISP_SCHED_Init(const ISP_SCHED_Conf_t *conf)
+{
+  assert(conf->period_converging > 0);
+  assert(conf->period_stable >= conf->period_converging);
+
+  isp_sched_conf = *conf;
+  isp_sched_stats = (ISP_SCHED_Stats_t) {0};
+  isp_sched_stats.converging = 1;
+  isp_sched_countdown = 0;
+  isp_sched_unchanged_runs = 0;
+  isp_sched_debt_us = 0;
+  isp_sched_kicked = 0;
+  isp_sched_exposure = -1;
+  isp_sched_gain = -1;
+  isp_sched_stats.exposure = -1;
+  isp_sched_stats.gain = -1;
+
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+  * @brief  To be called once per camera frame, runs the ISP when due
+  * @note   Frames are skipped while the scene is stable and while the CPU
+  *         time spent in previous runs exceeds the per frame budget. A skipped
+  *         frame does not call CMW_CAMERA_Run(): AE/AWB and the ISP statistics
+  *         requests pause until the next run. A tuning tool command
+  *         (ISP_SCHED_Kick()) is served on the next frame in any case.
+  * @retval CMW status of CMW_CAMERA_Run, CMW_ERROR_NONE when skipped
+  */
+int32_t ISP_SCHED_OnFrame(void)
+{
+  uint32_t start;
+  uint32_t duration_us;
+  int32_t ret;
+
+  isp_sched_stats.frames++;
+
+  /* Each frame repays one frame worth of budget, unused budget is not saved */
+  if (isp_sched_debt_us > isp_sched_conf.budget_us)
+  {
+    isp_sched_debt_us -= isp_sched_conf.budget_us;
+  }
+  else
+  {
+    isp_sched_debt_us = 0;
+  }
+
+  if (isp_sched_kicked)
+  {
+    /* The tool waits for each reply: neither the budget nor a hold delays it */
+    isp_sched_kicked = 0;
+  }
+  else if (isp_sched_stats.held)
+  {
+    return CMW_ERROR_NONE;
+  }
+  else if (isp_sched_countdown > 0)
+  {
+    isp_sched_countdown--;
+    return CMW_ERROR_NONE;
+  }
+  else if (isp_sched_conf.budget_us != 0 && isp_sched_debt_us > 0)
+  {
+    isp_sched_stats.budget_skips++;
+    return CMW_ERROR_NONE;
+  }
+
+  TRACE_Record(TRACE_EVT_ISP_RUN_START, 0);
+  start = DWT->CYCCNT;
+  PERF_MON_Begin(PERF_MON_REGION_ISP);
+  ret = CMW_CAMERA_Run();
+  PERF_MON_End(PERF_MON_REGION_ISP);
+  TRACE_Record(TRACE_EVT_ISP_RUN_END, (uint32_t) ret);
+  duration_us = ISP_SCHED_cycles_to_us(DWT->CYCCNT - start);
+
+  isp_sched_stats.runs++;
+  isp_sched_stats.last_us = duration_us;
+  if (duration_us > isp_sched_stats.max_us)
+  {
+    isp_sched_stats.max_us = duration_us;
+  }
+  if (isp_sched_stats.converging)
+  {
+    ISP_SCHED_update_avg(&isp_sched_stats.avg_converging_us, duration_us);
+  }
+  else
+  {
+    ISP_SCHED_update_avg(&isp_sched_stats.avg_stable_us, duration_us);
+  }
+
+  if (isp_sched_conf.budget_us != 0)
+  {
+    isp_sched_debt_us += duration_us;
+  }
+
+  ISP_SCHED_track_convergence();
+  if (isp_sched_stats.converging)
+  {
+    isp_sched_countdown = isp_sched_conf.period_converging - 1;
+  }
+  else
+  {
+    isp_sched_countdown = isp_sched_conf.period_stable - 1;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Go back to the converging rate, e.g. after an IQ or mode change
+  */
+void ISP_SCHED_Wake(void)
+{
+  isp_sched_unchanged_runs = 0;
+  isp_sched_countdown = 0;
+  isp_sched_stats.converging = 1;
+}
+
+/**
+  * @brief  Run the ISP on the next frame without restarting convergence, e.g.
+  *         to serve a tuning tool command. The run is not delayed by the CPU
+  *         budget nor by ISP_SCHED_Hold(), its time still counts in the budget.
+  */
+void ISP_SCHED_Kick(void)
+{
+  isp_sched_countdown = 0;
+  isp_sched_kicked = 1;
+}
+
+/**
+  * @brief  Suspend ISP runs, e.g. when an IQ profile disables both AE and AWB
+  */
+void ISP_SCHED_Hold(int hold)
+{
+  isp_sched_stats.held = hold ? 1 : 0;
+}
+
+void ISP_SCHED_GetStats(ISP_SCHED_Stats_t *stats)
+{
+  *stats = isp_sched_stats;
+}
@@ -0,0 +1,179 @@
+ /**
+ ******************************************************************************
+ * @file    isp_seed.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "isp_seed.h"
+#include "cmw_camera.h"
+#include "nvm.h"
+#include <stdio.h>
+
+#if defined(DEBUG)
+#define PRINTF(...)    printf(__VA_ARGS__)
+#else
+#define PRINTF(...)
+#endif /* defined(DEBUG) */
+
+/* Private define ------------------------------------------------------------*/
+#define ISP_SEED_VERSION       1
+/* Do not wear the NOR for small drifts: rewrite only above 1/8 change */
+#define ISP_SEED_DRIFT_SHIFT   3
+/* Let AWB settle after AE convergence before sampling the state to save */
+#define ISP_SEED_SAVE_DELAY    60
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint32_t sensor_id;
+  int32_t exposure;
+  int32_t gain;
+  uint32_t color_temp;
+} ISP_SEED_Record_t;
+
+/* Private variables ---------------------------------------------------------*/
+static ISP_SEED_Record_t isp_seed_stored;
+static ISP_SEED_Status_t isp_seed_status;
+static uint32_t isp_seed_sensor_id;
+static uint32_t isp_seed_start_tick;
+static uint32_t isp_seed_frames;
+static uint32_t isp_seed_save_countdown;
+static int isp_seed_has_record;
+
+/* Private functions ---------------------------------------------------------*/
+static int ISP_SEED_drifted(int32_t stored, int32_t current)
+{
+  int32_t delta = current > stored ? current - stored : stored - current;
+
+  return delta > (stored >> ISP_SEED_DRIFT_SHIFT);
+}
+
+static void ISP_SEED_save(void)
+{
+  ISP_SEED_Record_t rec;
+  uint8_t automatic = 0;
+  int32_t ret;
+
+  rec.sensor_id = isp_seed_sensor_id;
+  rec.color_temp = 0;
+  if (CMW_CAMERA_GetExposure(&rec.exposure) != CMW_ERROR_NONE ||
+      CMW_CAMERA_GetGain(&rec.gain) != CMW_ERROR_NONE)
+  {
+    return;
+  }
+  /* Only persist a colour temperature estimated by the AWB algorithm */
+  if (CMW_CAMERA_GetWBRefMode(&automatic, &rec.color_temp) != CMW_ERROR_NONE || !automatic)
+  {
+    rec.color_temp = isp_seed_stored.color_temp;
+  }
+  isp_seed_status.color_temp = rec.color_temp;
+
+  if (isp_seed_has_record &&
+      !ISP_SEED_drifted(isp_seed_stored.exposure, rec.exposure) &&
+      !ISP_SEED_drifted(isp_seed_stored.gain, rec.gain) &&
+      !ISP_SEED_drifted((int32_t) isp_seed_stored.color_temp, (int32_t) rec.color_temp))
+  {
+    return;
+  }
+
+  ret = NVM_Write(NVM_SLOT_ISP_STATE, ISP_SEED_VERSION, &rec, sizeof(rec));
+  if (ret == NVM_ERROR_NONE)
+  {
+    isp_seed_stored = rec;
+    isp_seed_has_record = 1;
+  }
+  PRINTF("ISP state saved (%ld)\n", (long) ret);
+}
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+  * @brief  Seed sensor exposure/gain and white balance with the last
+  *         converged state stored for this sensor
+  * @note   Must be called once the camera is started, before the first ISP
+  *         run, so that AE starts iterating from the stored point.
+  * @param  sensor_id Identifies the sensor the state was measured with
+  * @retval None
+  */
+void ISP_SEED_Apply(uint32_t sensor_id)
+{
+  isp_seed_sensor_id = sensor_id;
+  isp_seed_status = (ISP_SEED_Status_t) {0};
+  isp_seed_frames = 0;
+  isp_seed_save_countdown = 0;
+  isp_seed_start_tick = HAL_GetTick();
+
+  isp_seed_has_record = NVM_Read(NVM_SLOT_ISP_STATE, ISP_SEED_VERSION, &isp_seed_stored,
+                                 sizeof(isp_seed_stored)) == NVM_ERROR_NONE;
+  if (!isp_seed_has_record || isp_seed_stored.sensor_id != sensor_id)
+  {
+    isp_seed_has_record = 0;
+    PRINTF("No ISP state stored, AE/AWB start from defaults\n");
+    return;
+  }
+
+  CMW_CAMERA_SetExposure(isp_seed_stored.exposure);
+  CMW_CAMERA_SetGain(isp_seed_stored.gain);
+  /* AWB has no seed input: hold the stored reference until AE converged */
+  if (isp_seed_stored.color_temp != 0)
+  {
+    CMW_CAMERA_SetWBRefMode(0, isp_seed_stored.color_temp);
+  }
+  isp_seed_status.seeded = 1;
+  PRINTF("ISP seeded: exposure %ld gain %ld temp %lu\n", (long) isp_seed_stored.exposure,
+         (long) isp_seed_stored.gain, (unsigned long) isp_seed_stored.color_temp);
+}
+
+/**
+  * @brief  Track convergence, to be called once per camera frame
+  * @param  converging Non zero while AE is still moving
+  * @retval None
+  */
+void ISP_SEED_Process(int converging)
+{
+  isp_seed_frames++;
+
+  if (isp_seed_status.converged)
+  {
+    if (isp_seed_save_countdown > 0 && --isp_seed_save_countdown == 0)
+    {
+      ISP_SEED_save();
+    }
+    return;
+  }
+  if (converging)
+  {
+    return;
+  }
+
+  isp_seed_status.converged = 1;
+  isp_seed_status.convergence_ms = HAL_GetTick() - isp_seed_start_tick;
+  isp_seed_status.convergence_frames = isp_seed_frames;
+  CMW_CAMERA_GetExposure(&isp_seed_status.exposure);
+  CMW_CAMERA_GetGain(&isp_seed_status.gain);
+  PRINTF("AE converged in %lu ms (%lu frames)\n", (unsigned long) isp_seed_status.convergence_ms,
+         (unsigned long) isp_seed_status.convergence_frames);
+
+  if (isp_seed_status.seeded && isp_seed_stored.color_temp != 0)
+  {
+    CMW_CAMERA_SetWBRefMode(1, 0);
+  }
+  isp_seed_save_countdown = ISP_SEED_SAVE_DELAY;
+}
+
+void ISP_SEED_GetStatus(ISP_SEED_Status_t *status)
+{
+  *status = isp_seed_status;
+}
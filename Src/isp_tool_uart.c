@@ -0,0 +1,594 @@
+ /**
+ ******************************************************************************
+ * @file    isp_tool_uart.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "isp_tool_uart.h"
+#include "isp_tool_com.h"
+#include "cache_ctl.h"
+#include "stm32n6xx_hal.h"
+#include "stm32n6570_discovery.h"
+#include <string.h>
+
+#if (USE_COM_LOG > 0)
+#error "The BSP COM log shares COM1 with the ISP tuning tool: set USE_COM_LOG to 0"
+#endif
+
+/* Private define ------------------------------------------------------------*/
+#define ISP_TOOL_UART_COM           COM1
+#define ISP_TOOL_UART_IRQ_PRIO      7
+
+/* Sizes are powers of two, DMA buffers are multiple of the cache line size.
+ * Reception restarts on each idle line: a command fits in the DMA buffer, so
+ * its end is always reported by an idle line event */
+#define ISP_TOOL_UART_RX_DMA_SIZE   (2U * ISP_TOOL_UART_CMD_MAX)
+#define ISP_TOOL_UART_RX_RING_SIZE  4096U
+/* Command ends (idle line) received and not yet processed */
+#define ISP_TOOL_UART_RX_ENDS_NB    16U
+#define ISP_TOOL_UART_TX_RING_SIZE  4096U
+#define ISP_TOOL_UART_TX_SEG_NB     16U
+/* Larger payloads (e.g. frame dumps) are sent in place instead of copied */
+#define ISP_TOOL_UART_TX_COPY_MAX   1024U
+#define ISP_TOOL_UART_TX_CHUNK_MAX  32768U
+/* Worst case segments for one reply: 2 per copy (ring wrap), 1 in place */
+#define ISP_TOOL_UART_TX_SEG_SEND   6U
+/* Received bytes assembled per ISP_TOOL_UART_Process() call */
+#define ISP_TOOL_UART_SLICE_BYTES   256U
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  const uint8_t *data;
+  uint32_t size;
+  uint32_t ring_bytes;  /*!< TX ring space released once sent, 0 if in place */
+} ISP_TOOL_UART_Seg_t;
+
+/* Private variables ---------------------------------------------------------*/
+static int isp_tool_uart_ready;
+static DMA_HandleTypeDef isp_tool_uart_hdma_rx;
+static DMA_HandleTypeDef isp_tool_uart_hdma_tx;
+static ISP_TOOL_UART_Stats_t isp_tool_uart_stats;
+
+/* RX: DMA buffer -> ring (interrupt), ring -> command (app time slices) */
+__attribute__ ((aligned (32)))
+static uint8_t isp_tool_uart_rx_dma[ISP_TOOL_UART_RX_DMA_SIZE];
+static uint32_t isp_tool_uart_rx_dma_pos;
+static uint8_t isp_tool_uart_rx_ring[ISP_TOOL_UART_RX_RING_SIZE];
+static volatile uint32_t isp_tool_uart_rx_head;
+static uint32_t isp_tool_uart_rx_tail;
+static volatile int isp_tool_uart_rx_lost;
+static volatile uint32_t isp_tool_uart_rx_lost_at;
+static volatile int isp_tool_uart_rx_stalled;
+/* Ring positions of the idle line events, a command ends at each */
+static uint32_t isp_tool_uart_rx_ends[ISP_TOOL_UART_RX_ENDS_NB];
+static volatile uint32_t isp_tool_uart_rx_ends_head;
+static uint32_t isp_tool_uart_rx_ends_tail;
+
+/* Command in progress: dropped if oversized or if bytes were lost */
+static uint32_t isp_tool_uart_cmd_len;
+static int isp_tool_uart_cmd_drop;
+static int isp_tool_uart_cmd_ready;
+static uint8_t isp_tool_uart_cmd[ISP_TOOL_UART_CMD_MAX + 1];
+
+/* TX: replies are queued as segments, sent one DMA transfer at a time */
+__attribute__ ((aligned (32)))
+static uint8_t isp_tool_uart_tx_ring[ISP_TOOL_UART_TX_RING_SIZE];
+static uint32_t isp_tool_uart_tx_head;
+static volatile uint32_t isp_tool_uart_tx_tail;
+static ISP_TOOL_UART_Seg_t isp_tool_uart_tx_seg[ISP_TOOL_UART_TX_SEG_NB];
+static uint32_t isp_tool_uart_seg_head;
+static volatile uint32_t isp_tool_uart_seg_tail;
+static volatile int isp_tool_uart_tx_busy;
+static uint32_t isp_tool_uart_tx_chunk;
+
+/* Private functions ---------------------------------------------------------*/
+static UART_HandleTypeDef *ISP_TOOL_UART_handle(void)
+{
+  return &hcom_uart[ISP_TOOL_UART_COM];
+}
+
+/* TX completion is reported from the UART interrupt */
+static void ISP_TOOL_UART_lock(void)
+{
+  HAL_NVIC_DisableIRQ(USART1_IRQn);
+}
+
+static void ISP_TOOL_UART_unlock(void)
+{
+  HAL_NVIC_EnableIRQ(USART1_IRQn);
+}
+
+static HAL_StatusTypeDef ISP_TOOL_UART_init_dma(DMA_HandleTypeDef *hdma, DMA_Channel_TypeDef *channel,
+                                                uint32_t request, uint32_t direction)
+{
+  hdma->Instance = channel;
+  hdma->Init.Request = request;
+  hdma->Init.BlkHWRequest = DMA_BREQ_SINGLE_BURST;
+  hdma->Init.Direction = direction;
+  hdma->Init.SrcInc = direction == DMA_MEMORY_TO_PERIPH ? DMA_SINC_INCREMENTED : DMA_SINC_FIXED;
+  hdma->Init.DestInc = direction == DMA_MEMORY_TO_PERIPH ? DMA_DINC_FIXED : DMA_DINC_INCREMENTED;
+  hdma->Init.SrcDataWidth = DMA_SRC_DATAWIDTH_BYTE;
+  hdma->Init.DestDataWidth = DMA_DEST_DATAWIDTH_BYTE;
+  hdma->Init.Priority = DMA_LOW_PRIORITY_LOW_WEIGHT;
+  hdma->Init.SrcBurstLength = 1;
+  hdma->Init.DestBurstLength = 1;
+  hdma->Init.TransferAllocatedPort = DMA_SRC_ALLOCATED_PORT0 | DMA_DEST_ALLOCATED_PORT0;
+  hdma->Init.TransferEventMode = DMA_TCEM_BLOCK_TRANSFER;
+  hdma->Init.Mode = DMA_NORMAL;
+  if (HAL_DMA_Init(hdma) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  return HAL_DMA_ConfigChannelAttributes(hdma, DMA_CHANNEL_SEC | DMA_CHANNEL_PRIV |
+                                               DMA_CHANNEL_SRC_SEC | DMA_CHANNEL_DEST_SEC);
+}
+
+static void ISP_TOOL_UART_start_rx(void)
+{
+  isp_tool_uart_rx_dma_pos = 0;
+  if (HAL_UARTEx_ReceiveToIdle_DMA(ISP_TOOL_UART_handle(), isp_tool_uart_rx_dma,
+                                   ISP_TOOL_UART_RX_DMA_SIZE) != HAL_OK)
+  {
+    /* Retried from the next time slice */
+    isp_tool_uart_rx_stalled = 1;
+  }
+}
+
+/* Called with the UART interrupt masked or from the UART interrupt */
+static void ISP_TOOL_UART_start_tx(void)
+{
+  ISP_TOOL_UART_Seg_t *seg;
+
+  if (isp_tool_uart_tx_busy || isp_tool_uart_seg_tail == isp_tool_uart_seg_head)
+  {
+    return;
+  }
+
+  seg = &isp_tool_uart_tx_seg[isp_tool_uart_seg_tail % ISP_TOOL_UART_TX_SEG_NB];
+  isp_tool_uart_tx_chunk = seg->size < ISP_TOOL_UART_TX_CHUNK_MAX ? seg->size : ISP_TOOL_UART_TX_CHUNK_MAX;
+
+  CACHE_CTL_Clean(seg->data, isp_tool_uart_tx_chunk);
+
+  isp_tool_uart_tx_busy = 1;
+  if (HAL_UART_Transmit_DMA(ISP_TOOL_UART_handle(), seg->data, (uint16_t) isp_tool_uart_tx_chunk) != HAL_OK)
+  {
+    /* Retried from the next time slice */
+    isp_tool_uart_tx_busy = 0;
+  }
+}
+
+static void ISP_TOOL_UART_queue(const uint8_t *data, uint32_t size, uint32_t ring_bytes)
+{
+  ISP_TOOL_UART_Seg_t *seg = &isp_tool_uart_tx_seg[isp_tool_uart_seg_head % ISP_TOOL_UART_TX_SEG_NB];
+
+  seg->data = data;
+  seg->size = size;
+  seg->ring_bytes = ring_bytes;
+  isp_tool_uart_seg_head++;
+}
+
+static void ISP_TOOL_UART_queue_copy(const uint8_t *data, uint32_t size)
+{
+  uint32_t offset;
+  uint32_t n;
+
+  while (size)
+  {
+    offset = isp_tool_uart_tx_head % ISP_TOOL_UART_TX_RING_SIZE;
+    n = ISP_TOOL_UART_TX_RING_SIZE - offset < size ? ISP_TOOL_UART_TX_RING_SIZE - offset : size;
+    memcpy(&isp_tool_uart_tx_ring[offset], data, n);
+    ISP_TOOL_UART_queue(&isp_tool_uart_tx_ring[offset], n, n);
+    isp_tool_uart_tx_head += n;
+    data += n;
+    size -= n;
+  }
+}
+
+/* Idle line: the command in progress is complete */
+static void ISP_TOOL_UART_end_command(void)
+{
+  if (isp_tool_uart_cmd_drop || isp_tool_uart_cmd_len > ISP_TOOL_UART_CMD_MAX)
+  {
+    isp_tool_uart_stats.frame_errors++;
+    isp_tool_uart_cmd_len = 0;
+  }
+  else if (isp_tool_uart_cmd_len > 0)
+  {
+    isp_tool_uart_cmd[isp_tool_uart_cmd_len] = '\0';
+    isp_tool_uart_cmd_ready = 1;
+    isp_tool_uart_stats.commands++;
+  }
+  isp_tool_uart_cmd_drop = 0;
+}
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+  * @brief  Start the tuning tool link on the virtual COM port
+  * @note   Safe to call several times, e.g. from ISP_ToolCom_Init()
+  * @retval ISP_TOOL_UART_ERROR_NONE or ISP_TOOL_UART_ERROR_HAL
+  */
+int32_t ISP_TOOL_UART_Init(void)
+{
+  UART_HandleTypeDef *huart = ISP_TOOL_UART_handle();
+  COM_InitTypeDef com_init = {
+    .BaudRate = ISP_TOOL_UART_BAUDRATE,
+    .WordLength = COM_WORDLENGTH_8B,
+    .StopBits = COM_STOPBITS_1,
+    .Parity = COM_PARITY_NONE,
+    .HwFlowCtl = COM_HWCONTROL_NONE,
+  };
+
+  if (isp_tool_uart_ready)
+  {
+    return ISP_TOOL_UART_ERROR_NONE;
+  }
+
+  if (BSP_COM_Init(ISP_TOOL_UART_COM, &com_init) != BSP_ERROR_NONE)
+  {
+    return ISP_TOOL_UART_ERROR_HAL;
+  }
+  /* FIFO absorbs the bytes received while reception is re-armed */
+  if (HAL_UARTEx_EnableFifoMode(huart) != HAL_OK)
+  {
+    return ISP_TOOL_UART_ERROR_HAL;
+  }
+
+  __HAL_RCC_GPDMA1_CLK_ENABLE();
+  if (ISP_TOOL_UART_init_dma(&isp_tool_uart_hdma_tx, GPDMA1_Channel0, GPDMA1_REQUEST_USART1_TX,
+                             DMA_MEMORY_TO_PERIPH) != HAL_OK ||
+      ISP_TOOL_UART_init_dma(&isp_tool_uart_hdma_rx, GPDMA1_Channel1, GPDMA1_REQUEST_USART1_RX,
+                             DMA_PERIPH_TO_MEMORY) != HAL_OK)
+  {
+    return ISP_TOOL_UART_ERROR_HAL;
+  }
+  __HAL_LINKDMA(huart, hdmatx, isp_tool_uart_hdma_tx);
+  __HAL_LINKDMA(huart, hdmarx, isp_tool_uart_hdma_rx);
+
+  isp_tool_uart_stats = (ISP_TOOL_UART_Stats_t) {0};
+  isp_tool_uart_rx_head = 0;
+  isp_tool_uart_rx_tail = 0;
+  isp_tool_uart_rx_lost = 0;
+  isp_tool_uart_rx_stalled = 0;
+  isp_tool_uart_rx_ends_head = 0;
+  isp_tool_uart_rx_ends_tail = 0;
+  isp_tool_uart_cmd_len = 0;
+  isp_tool_uart_cmd_drop = 0;
+  isp_tool_uart_cmd_ready = 0;
+  isp_tool_uart_tx_head = 0;
+  isp_tool_uart_tx_tail = 0;
+  isp_tool_uart_seg_head = 0;
+  isp_tool_uart_seg_tail = 0;
+  isp_tool_uart_tx_busy = 0;
+
+  /* Same priority: RX events from DMA and UART interrupts never nest */
+  HAL_NVIC_SetPriority(GPDMA1_Channel0_IRQn, ISP_TOOL_UART_IRQ_PRIO, 0);
+  HAL_NVIC_SetPriority(GPDMA1_Channel1_IRQn, ISP_TOOL_UART_IRQ_PRIO, 0);
+  HAL_NVIC_SetPriority(USART1_IRQn, ISP_TOOL_UART_IRQ_PRIO, 0);
+  HAL_NVIC_EnableIRQ(GPDMA1_Channel0_IRQn);
+  HAL_NVIC_EnableIRQ(GPDMA1_Channel1_IRQn);
+  HAL_NVIC_EnableIRQ(USART1_IRQn);
+
+  isp_tool_uart_ready = 1;
+  ISP_TOOL_UART_start_rx();
+
+  return ISP_TOOL_UART_ERROR_NONE;
+}
+
+/**
+  * @brief  Time slice of the link, to be called from the app loop
+  * @note   Assembles at most ISP_TOOL_UART_SLICE_BYTES received bytes and
+  *         stops as soon as a command is complete. The command is then
+  *         executed by the ISP background process on the next
+  *         CMW_CAMERA_Run().
+  * @retval 1 if a command is waiting for the ISP, 0 otherwise
+  */
+int ISP_TOOL_UART_Process(void)
+{
+  uint32_t budget = ISP_TOOL_UART_SLICE_BYTES;
+  uint32_t head;
+  uint32_t ends;
+
+  if (!isp_tool_uart_ready)
+  {
+    return 0;
+  }
+
+  if (isp_tool_uart_rx_stalled)
+  {
+    isp_tool_uart_rx_stalled = 0;
+    ISP_TOOL_UART_start_rx();
+  }
+  if (!isp_tool_uart_tx_busy)
+  {
+    ISP_TOOL_UART_lock();
+    ISP_TOOL_UART_start_tx();
+    ISP_TOOL_UART_unlock();
+  }
+
+  head = isp_tool_uart_rx_head;
+  ends = isp_tool_uart_rx_ends_head;
+  __DMB();
+  while (!isp_tool_uart_cmd_ready && budget)
+  {
+    if (isp_tool_uart_rx_ends_tail != ends &&
+        isp_tool_uart_rx_tail == isp_tool_uart_rx_ends[isp_tool_uart_rx_ends_tail % ISP_TOOL_UART_RX_ENDS_NB])
+    {
+      isp_tool_uart_rx_ends_tail++;
+      ISP_TOOL_UART_end_command();
+      continue;
+    }
+    /* Bytes were lost here: the command in progress is corrupted */
+    if (isp_tool_uart_rx_lost && isp_tool_uart_rx_tail == isp_tool_uart_rx_lost_at)
+    {
+      isp_tool_uart_rx_lost = 0;
+      isp_tool_uart_cmd_drop = 1;
+    }
+    if (isp_tool_uart_rx_tail == head)
+    {
+      break;
+    }
+    if (isp_tool_uart_cmd_len < ISP_TOOL_UART_CMD_MAX)
+    {
+      isp_tool_uart_cmd[isp_tool_uart_cmd_len] =
+        isp_tool_uart_rx_ring[isp_tool_uart_rx_tail % ISP_TOOL_UART_RX_RING_SIZE];
+    }
+    /* Counted past the buffer: an oversized command is dropped at its end */
+    if (isp_tool_uart_cmd_len <= ISP_TOOL_UART_CMD_MAX)
+    {
+      isp_tool_uart_cmd_len++;
+    }
+    isp_tool_uart_rx_tail++;
+    budget--;
+  }
+
+  return isp_tool_uart_cmd_ready;
+}
+
+void ISP_TOOL_UART_GetStats(ISP_TOOL_UART_Stats_t *stats)
+{
+  *stats = isp_tool_uart_stats;
+}
+
+/**
+  * @brief  Queue raw data on the link, e.g. trace packets, never waits
+  * @param  data Data, copied
+  * @param  size Size, up to ISP_TOOL_UART_TX_COPY_MAX
+  * @retval ISP_TOOL_UART_ERROR_NONE, ISP_TOOL_UART_ERROR_FULL if the data does
+  *         not fit in the TX queue yet
+  */
+int32_t ISP_TOOL_UART_Send(const uint8_t *data, uint32_t size)
+{
+  if (!isp_tool_uart_ready || size > ISP_TOOL_UART_TX_COPY_MAX)
+  {
+    return ISP_TOOL_UART_ERROR_PARAM;
+  }
+
+  ISP_TOOL_UART_lock();
+  if (size > ISP_TOOL_UART_TX_RING_SIZE - (isp_tool_uart_tx_head - isp_tool_uart_tx_tail) ||
+      ISP_TOOL_UART_TX_SEG_NB - (isp_tool_uart_seg_head - isp_tool_uart_seg_tail) < 2)
+  {
+    ISP_TOOL_UART_unlock();
+    return ISP_TOOL_UART_ERROR_FULL;
+  }
+  ISP_TOOL_UART_queue_copy(data, size);
+  ISP_TOOL_UART_start_tx();
+  ISP_TOOL_UART_unlock();
+
+  return ISP_TOOL_UART_ERROR_NONE;
+}
+
+/**
+  * @brief  ISP tool transport: the link is started by the application
+  */
+void ISP_ToolCom_Init(void)
+{
+  (void) ISP_TOOL_UART_Init();
+}
+
+/**
+  * @brief  ISP tool transport: command ready for the ISP command parser
+  * @param  cmd Set to the command buffer when a command is available
+  * @retval Command size, 0 if none
+  */
+uint32_t ISP_ToolCom_CheckCommandReceived(uint8_t **cmd)
+{
+  if (!isp_tool_uart_cmd_ready)
+  {
+    return 0;
+  }
+
+  *cmd = isp_tool_uart_cmd;
+  return isp_tool_uart_cmd_len;
+}
+
+/**
+  * @brief  ISP tool transport: the command buffer can be reused
+  */
+void ISP_ToolCom_PrepareNextCommand(void)
+{
+  isp_tool_uart_cmd_len = 0;
+  isp_tool_uart_cmd_ready = 0;
+}
+
+/**
+  * @brief  ISP tool transport: queue a reply, never waits for the line
+  * @note   Payloads larger than ISP_TOOL_UART_TX_COPY_MAX are sent from the
+  *         caller buffer, which the ISP keeps until the next dump. The reply
+  *         is dropped as a whole if the TX queue is full.
+  * @param  buffer Payload
+  * @param  buffer_size Payload size
+  * @param  dump_start_delimiter String sent before the payload, may be NULL
+  * @param  dump_stop_delimiter String sent after the payload, may be NULL
+  * @retval None
+  */
+void ISP_ToolCom_SendData(uint8_t *buffer, uint32_t buffer_size, char *dump_start_delimiter,
+                          char *dump_stop_delimiter)
+{
+  uint32_t start_len = dump_start_delimiter ? strlen(dump_start_delimiter) : 0;
+  uint32_t stop_len = dump_stop_delimiter ? strlen(dump_stop_delimiter) : 0;
+  int in_place = buffer_size > ISP_TOOL_UART_TX_COPY_MAX;
+  uint32_t ring_bytes = start_len + stop_len + (in_place ? 0 : buffer_size);
+
+  if (!isp_tool_uart_ready)
+  {
+    return;
+  }
+
+  ISP_TOOL_UART_lock();
+  if (ring_bytes > ISP_TOOL_UART_TX_RING_SIZE - (isp_tool_uart_tx_head - isp_tool_uart_tx_tail) ||
+      ISP_TOOL_UART_TX_SEG_SEND > ISP_TOOL_UART_TX_SEG_NB - (isp_tool_uart_seg_head - isp_tool_uart_seg_tail))
+  {
+    isp_tool_uart_stats.tx_drops++;
+    ISP_TOOL_UART_unlock();
+    return;
+  }
+
+  ISP_TOOL_UART_queue_copy((uint8_t *) dump_start_delimiter, start_len);
+  if (in_place)
+  {
+    ISP_TOOL_UART_queue(buffer, buffer_size, 0);
+  }
+  else
+  {
+    ISP_TOOL_UART_queue_copy(buffer, buffer_size);
+  }
+  ISP_TOOL_UART_queue_copy((uint8_t *) dump_stop_delimiter, stop_len);
+  ISP_TOOL_UART_start_tx();
+  ISP_TOOL_UART_unlock();
+}
+
+/**
+  * @brief  Reception event: half/full DMA buffer or line idle
+  * @param  huart UART handle
+  * @param  Size Bytes written in the DMA buffer since reception start
+  * @retval None
+  */
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+  uint32_t head = isp_tool_uart_rx_head;
+  int lost = 0;
+  uint32_t i;
+
+  if (huart != ISP_TOOL_UART_handle())
+  {
+    return;
+  }
+
+  CACHE_CTL_Invalidate(isp_tool_uart_rx_dma, ISP_TOOL_UART_RX_DMA_SIZE);
+  for (i = isp_tool_uart_rx_dma_pos; i < Size; i++)
+  {
+    if (head - isp_tool_uart_rx_tail == ISP_TOOL_UART_RX_RING_SIZE)
+    {
+      isp_tool_uart_stats.rx_overruns++;
+      isp_tool_uart_rx_lost_at = head;
+      isp_tool_uart_rx_lost = 1;
+      lost = 1;
+      continue;
+    }
+    isp_tool_uart_rx_ring[head % ISP_TOOL_UART_RX_RING_SIZE] = isp_tool_uart_rx_dma[i];
+    head++;
+  }
+  isp_tool_uart_stats.rx_bytes += Size - isp_tool_uart_rx_dma_pos;
+  isp_tool_uart_rx_dma_pos = Size;
+
+  __DMB();
+  isp_tool_uart_rx_head = head;
+
+  /* The tool sends each command in one write, as one USB transfer: the line
+   * only goes idle at its end. Without its end, a command that lost bytes is
+   * dropped with the next one */
+  if (HAL_UARTEx_GetRxEventType(huart) == HAL_UART_RXEVENT_IDLE && !lost)
+  {
+    if (isp_tool_uart_rx_ends_head - isp_tool_uart_rx_ends_tail == ISP_TOOL_UART_RX_ENDS_NB)
+    {
+      /* Command boundary lost: this command is dropped with the next one */
+      isp_tool_uart_stats.rx_overruns++;
+      isp_tool_uart_rx_lost_at = head;
+      isp_tool_uart_rx_lost = 1;
+    }
+    else
+    {
+      isp_tool_uart_rx_ends[isp_tool_uart_rx_ends_head % ISP_TOOL_UART_RX_ENDS_NB] = head;
+      __DMB();
+      isp_tool_uart_rx_ends_head++;
+    }
+  }
+
+  /* Normal mode: reception ends on idle line and on full buffer */
+  if (HAL_UARTEx_GetRxEventType(huart) != HAL_UART_RXEVENT_HT)
+  {
+    ISP_TOOL_UART_start_rx();
+  }
+}
+
+/**
+  * @brief  printf output (syscalls.c): dropped, COM1 carries the tuning tool
+  *         stream and log output would corrupt it
+  */
+int __io_putchar(int ch)
+{
+  return ch;
+}
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  ISP_TOOL_UART_Seg_t *seg;
+
+  if (huart != ISP_TOOL_UART_handle())
+  {
+    return;
+  }
+
+  seg = &isp_tool_uart_tx_seg[isp_tool_uart_seg_tail % ISP_TOOL_UART_TX_SEG_NB];
+  seg->data += isp_tool_uart_tx_chunk;
+  seg->size -= isp_tool_uart_tx_chunk;
+  isp_tool_uart_stats.tx_bytes += isp_tool_uart_tx_chunk;
+  if (seg->size == 0)
+  {
+    isp_tool_uart_tx_tail += seg->ring_bytes;
+    isp_tool_uart_seg_tail++;
+  }
+
+  isp_tool_uart_tx_busy = 0;
+  ISP_TOOL_UART_start_tx();
+}
+
+/**
+  * @brief  Line error (overrun, framing, noise): HAL has aborted the transfers
+  */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+  if (huart != ISP_TOOL_UART_handle())
+  {
+    return;
+  }
+
+  isp_tool_uart_stats.rx_overruns++;
+  isp_tool_uart_rx_lost_at = isp_tool_uart_rx_head;
+  isp_tool_uart_rx_lost = 1;
+  if (huart->RxState == HAL_UART_STATE_READY)
+  {
+    ISP_TOOL_UART_start_rx();
+  }
+  if (huart->gState == HAL_UART_STATE_READY && isp_tool_uart_tx_busy)
+  {
+    /* Resend the aborted chunk */
+    isp_tool_uart_tx_busy = 0;
+    ISP_TOOL_UART_start_tx();
+  }
+}
@@ -0,0 +1,371 @@
+ /**
+ ******************************************************************************
+ * @file    lcd_layer.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "lcd_layer.h"
+#include "trace.h"
+#include <assert.h>
+
+/* Private define ------------------------------------------------------------*/
+#define LCD_LAYER_NB            2U
+
+#define LCD_LAYER_DIRTY_ADDRESS   (1U << 0)
+#define LCD_LAYER_DIRTY_SIZE      (1U << 1)
+#define LCD_LAYER_DIRTY_POSITION  (1U << 2)
+#define LCD_LAYER_DIRTY_PITCH     (1U << 3)
+#define LCD_LAYER_DIRTY_ALPHA     (1U << 4)
+#define LCD_LAYER_DIRTY_COLOR_KEY (1U << 5)
+#define LCD_LAYER_DIRTY_ENABLE    (1U << 6)
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint32_t dirty;
+  uint32_t address;
+  uint32_t pitch;
+  uint32_t x0;
+  uint32_t y0;
+  uint32_t width;
+  uint32_t height;
+  uint8_t alpha;
+  uint8_t color_key_enable;
+  uint8_t enable;
+  uint32_t color_key;
+} LCD_LAYER_State_t;
+
+/* Private variables ---------------------------------------------------------*/
+static LTDC_HandleTypeDef *lcd_layer_hltdc;
+static LCD_LAYER_State_t lcd_layer_staged[LCD_LAYER_NB];
+static volatile int lcd_layer_commit_pending;
+static volatile uint32_t lcd_layer_commit_count;
+static volatile uint32_t lcd_layer_underruns;
+
+/* Private functions ---------------------------------------------------------*/
+static LCD_LAYER_State_t *LCD_LAYER_get(uint32_t layer)
+{
+  assert(lcd_layer_hltdc != NULL);
+  assert(layer < LCD_LAYER_NB);
+
+  return &lcd_layer_staged[layer];
+}
+
+static HAL_StatusTypeDef LCD_LAYER_apply(uint32_t layer, LCD_LAYER_State_t *state)
+{
+  LTDC_HandleTypeDef *hltdc = lcd_layer_hltdc;
+  HAL_StatusTypeDef ret = HAL_OK;
+
+  /* Size first. Default pitch restored by the same call: HAL recomputes the
+   * line pitch from the window width */
+  if ((state->dirty & LCD_LAYER_DIRTY_SIZE) ||
+      ((state->dirty & LCD_LAYER_DIRTY_PITCH) && state->pitch == 0))
+  {
+    ret |= HAL_LTDC_SetWindowSize_NoReload(hltdc, state->width, state->height, layer);
+  }
+  if (state->dirty & (LCD_LAYER_DIRTY_SIZE | LCD_LAYER_DIRTY_POSITION))
+  {
+    ret |= HAL_LTDC_SetWindowPosition_NoReload(hltdc, state->x0, state->y0, layer);
+  }
+  if (state->dirty & LCD_LAYER_DIRTY_ADDRESS)
+  {
+    ret |= HAL_LTDC_SetAddress_NoReload(hltdc, state->address, layer);
+  }
+  if (state->dirty & LCD_LAYER_DIRTY_ALPHA)
+  {
+    ret |= HAL_LTDC_SetAlpha_NoReload(hltdc, state->alpha, layer);
+  }
+  if (state->dirty & LCD_LAYER_DIRTY_COLOR_KEY)
+  {
+    ret |= HAL_LTDC_ConfigColorKeying_NoReload(hltdc, state->color_key, layer);
+    if (state->color_key_enable)
+    {
+      ret |= HAL_LTDC_EnableColorKeying_NoReload(hltdc, layer);
+    }
+    else
+    {
+      ret |= HAL_LTDC_DisableColorKeying_NoReload(hltdc, layer);
+    }
+  }
+
+  /* Last: the HAL size, position, address and alpha setters all go through
+   * LTDC_SetConfig(), which rewrites the line pitch from the window width
+   * and sets LxCR.LEN. Pitch and enable state are written again over it */
+  if (state->pitch != 0)
+  {
+    ret |= HAL_LTDC_SetPitch_NoReload(hltdc, state->pitch, layer);
+  }
+  /* LxCR is shadowed too, so this only takes effect with the reload */
+  if (state->enable)
+  {
+    __HAL_LTDC_LAYER_ENABLE(hltdc, layer);
+  }
+  else
+  {
+    __HAL_LTDC_LAYER_DISABLE(hltdc, layer);
+  }
+
+  return ret == HAL_OK ? HAL_OK : HAL_ERROR;
+}
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+  * @brief  Capture the current layers configuration as the staging baseline
+  * @param  hltdc LTDC handle already configured (e.g. by BSP_LCD_ConfigLayer)
+  * @retval None
+  */
+void LCD_LAYER_Init(LTDC_HandleTypeDef *hltdc)
+{
+  uint32_t layer;
+
+  lcd_layer_hltdc = hltdc;
+  lcd_layer_commit_pending = 0;
+  lcd_layer_commit_count = 0;
+
+  for (layer = 0; layer < LCD_LAYER_NB; layer++)
+  {
+    LTDC_LayerCfgTypeDef *cfg = &hltdc->LayerCfg[layer];
+    LCD_LAYER_State_t *state = &lcd_layer_staged[layer];
+
+    state->dirty = 0;
+    state->address = cfg->FBStartAdress;
+    state->pitch = 0;
+    state->x0 = cfg->WindowX0;
+    state->y0 = cfg->WindowY0;
+    state->width = cfg->WindowX1 - cfg->WindowX0;
+    state->height = cfg->WindowY1 - cfg->WindowY0;
+    state->alpha = cfg->Alpha;
+    state->color_key_enable = 0;
+    state->color_key = 0;
+    state->enable = (LTDC_LAYER(hltdc, layer)->CR & LTDC_LxCR_LEN) != 0;
+  }
+
+  /* Reload event is reported on the LTDC global interrupt line */
+  HAL_NVIC_SetPriority(LTDC_LO_IRQn, 5, 0);
+  HAL_NVIC_EnableIRQ(LTDC_LO_IRQn);
+  /* FIFO underrun, enabled by HAL_LTDC_Init() */
+  lcd_layer_underruns = 0;
+  HAL_NVIC_SetPriority(LTDC_LO_ERR_IRQn, 5, 0);
+  HAL_NVIC_EnableIRQ(LTDC_LO_ERR_IRQn);
+}
+
+void LCD_LAYER_SetAddress(uint32_t layer, uint32_t address)
+{
+  LCD_LAYER_State_t *state = LCD_LAYER_get(layer);
+
+  state->address = address;
+  state->dirty |= LCD_LAYER_DIRTY_ADDRESS;
+}
+
+/**
+  * @brief  Stage a line pitch different from the window width
+  * @note   Allows scrolling a window inside a larger buffer through address
+  *         offsets only. 0 restores the default (pitch = window width).
+  */
+void LCD_LAYER_SetPitch(uint32_t layer, uint32_t pitch_in_pixels)
+{
+  LCD_LAYER_State_t *state = LCD_LAYER_get(layer);
+
+  state->pitch = pitch_in_pixels;
+  state->dirty |= LCD_LAYER_DIRTY_PITCH;
+}
+
+void LCD_LAYER_SetWindow(uint32_t layer, uint32_t x0, uint32_t y0, uint32_t width, uint32_t height)
+{
+  LCD_LAYER_State_t *state = LCD_LAYER_get(layer);
+
+  state->x0 = x0;
+  state->y0 = y0;
+  state->width = width;
+  state->height = height;
+  state->dirty |= LCD_LAYER_DIRTY_SIZE;
+}
+
+void LCD_LAYER_SetPosition(uint32_t layer, uint32_t x0, uint32_t y0)
+{
+  LCD_LAYER_State_t *state = LCD_LAYER_get(layer);
+
+  state->x0 = x0;
+  state->y0 = y0;
+  state->dirty |= LCD_LAYER_DIRTY_POSITION;
+}
+
+void LCD_LAYER_SetAlpha(uint32_t layer, uint8_t alpha)
+{
+  LCD_LAYER_State_t *state = LCD_LAYER_get(layer);
+
+  state->alpha = alpha;
+  state->dirty |= LCD_LAYER_DIRTY_ALPHA;
+}
+
+void LCD_LAYER_SetColorKey(uint32_t layer, int enable, uint32_t rgb888)
+{
+  LCD_LAYER_State_t *state = LCD_LAYER_get(layer);
+
+  state->color_key_enable = enable ? 1 : 0;
+  state->color_key = rgb888;
+  state->dirty |= LCD_LAYER_DIRTY_COLOR_KEY;
+}
+
+void LCD_LAYER_SetEnable(uint32_t layer, int enable)
+{
+  LCD_LAYER_State_t *state = LCD_LAYER_get(layer);
+
+  state->enable = enable ? 1 : 0;
+  state->dirty |= LCD_LAYER_DIRTY_ENABLE;
+}
+
+/**
+  * @brief  Drop all staged but not yet committed changes
+  * @note   Staged values are kept, only the pending writes are discarded.
+  */
+void LCD_LAYER_Abort(void)
+{
+  uint32_t layer;
+
+  for (layer = 0; layer < LCD_LAYER_NB; layer++)
+  {
+    lcd_layer_staged[layer].dirty = 0;
+  }
+}
+
+/**
+  * @brief  Apply all staged changes on the next vertical blanking period
+  * @retval LCD_LAYER_ERROR_NONE on success, LCD_LAYER_ERROR_BUSY if the
+  *         previous commit has not been latched yet (staged values are kept,
+  *         retry later), LCD_LAYER_ERROR_HAL otherwise.
+  */
+int32_t LCD_LAYER_Commit(void)
+{
+  HAL_StatusTypeDef ret = HAL_OK;
+  uint32_t layer;
+  int dirty = 0;
+
+  assert(lcd_layer_hltdc != NULL);
+
+  /* Shadow registers are still waiting for the reload: writing them now would
+   * mix two transactions in the same frame */
+  if (lcd_layer_commit_pending)
+  {
+    return LCD_LAYER_ERROR_BUSY;
+  }
+
+  for (layer = 0; layer < LCD_LAYER_NB; layer++)
+  {
+    LCD_LAYER_State_t *state = &lcd_layer_staged[layer];
+
+    if (state->dirty == 0)
+    {
+      continue;
+    }
+    ret |= LCD_LAYER_apply(layer, state);
+    state->dirty = 0;
+    dirty = 1;
+  }
+
+  if (!dirty)
+  {
+    return LCD_LAYER_ERROR_NONE;
+  }
+
+  lcd_layer_commit_pending = 1;
+  ret |= HAL_LTDC_Reload(lcd_layer_hltdc, LTDC_RELOAD_VERTICAL_BLANKING);
+  if (ret != HAL_OK)
+  {
+    lcd_layer_commit_pending = 0;
+    return LCD_LAYER_ERROR_HAL;
+  }
+
+  return LCD_LAYER_ERROR_NONE;
+}
+
+int LCD_LAYER_IsCommitPending(void)
+{
+  return lcd_layer_commit_pending;
+}
+
+/**
+  * @brief  Block until the last commit is visible on the scanout
+  */
+void LCD_LAYER_WaitCommit(void)
+{
+  while (lcd_layer_commit_pending)
+  {
+    __WFI();
+  }
+}
+
+uint32_t LCD_LAYER_GetCommitCount(void)
+{
+  return lcd_layer_commit_count;
+}
+
+/**
+  * @brief  Number of frames in which the LTDC FIFO underran
+  * @note   Only counted while LCD_LAYER_RearmUnderrun() is called once per
+  *         frame, see HAL_LTDC_ErrorCallback().
+  */
+uint32_t LCD_LAYER_GetUnderruns(void)
+{
+  return lcd_layer_underruns;
+}
+
+/**
+  * @brief  Report the next FIFO underrun, to be called once per frame
+  */
+void LCD_LAYER_RearmUnderrun(void)
+{
+  if ((lcd_layer_hltdc->Instance->IER & LTDC_IT_FU) == 0)
+  {
+    __HAL_LTDC_CLEAR_FLAG(lcd_layer_hltdc, LTDC_FLAG_FU);
+    __HAL_LTDC_ENABLE_IT(lcd_layer_hltdc, LTDC_IT_FU);
+  }
+}
+
+/**
+  * @brief  Error callback: account FIFO underruns
+  * @note   HAL_LTDC_IRQHandler() masks the underrun interrupt before calling
+  *         back: an underrun repeats on every line, so it is only re-enabled
+  *         by LCD_LAYER_RearmUnderrun() and counted at most once per frame.
+  * @param  hltdc LTDC handle
+  * @retval None
+  */
+void HAL_LTDC_ErrorCallback(LTDC_HandleTypeDef *hltdc)
+{
+  if (hltdc->ErrorCode & HAL_LTDC_ERROR_FU)
+  {
+    lcd_layer_underruns++;
+    TRACE_Record(TRACE_EVT_LTDC_UNDERRUN, lcd_layer_underruns);
+  }
+
+  /* Not fatal: keep the handle usable for the next transactions */
+  hltdc->ErrorCode = HAL_LTDC_ERROR_NONE;
+  hltdc->State = HAL_LTDC_STATE_READY;
+}
+
+/**
+  * @brief  Reload Event callback: shadow registers have been latched
+  * @param  hltdc LTDC handle
+  * @retval None
+  */
+void HAL_LTDC_ReloadEventCallback(LTDC_HandleTypeDef *hltdc)
+{
+  UNUSED(hltdc);
+
+  lcd_layer_commit_count++;
+  lcd_layer_commit_pending = 0;
+  TRACE_Record(TRACE_EVT_LTDC_RELOAD, lcd_layer_commit_count);
+}
@@ -23,13 +23,35 @@
 #include "stm32_lcd.h"
 #include "stm32_lcd_ex.h"
 #include "hdmi.h"
+#include "lcd_layer.h"
+#include "scanline.h"
+#include "cpu_load.h"
+#include "isp_sched.h"
+#include "isp_seed.h"
+#include "iq_profile.h"
+#include "isp_tool_uart.h"
+#include "camera_mode.h"
+#include "trace.h"
+#include "frame_meta.h"
+#include "perf_mon.h"
+#include "hud.h"
+#include "boot_prof.h"
+#include "boot_conf.h"
+#include "psram_tune.h"
+#include "fb_alloc.h"
+#include "cache_ctl.h"
+#include "tcm.h"
+#include "bus_arb.h"
+#include "disp_latency.h"
+#include "cam_recovery.h"
+#include "nvm.h"
 #include "main.h"
 #include <stdio.h>
 #include <assert.h>
 
 /* Choose resolution (select one) */
 /* HDMI 24 bits rgb 4:4:4 */
-/* IC16 input clock 600MHz */
+/* IC16 input clock PLL4: 600MHz unless the mode sets HDMI_PLL4_N */
 /* https://tomverbeure.github.io/video_timings_calculator */
 #if 0 /* 480x480 @ 50Hz 1:1 ***************************************************/
 #define LCD_BG_WIDTH  480U
@@ -63,6 +85,37 @@
 #define HDMI_VBP   20
 #define HDMI_IC16_CLKDIV  9 /* 66.67MHz */
 // #define HDMI_IC16_CLKDIV  8 /* 75MHz ~= 74.25MHz may experience pixel noise issue if using non-shielded cable */
+#elif 0 /* 480p 60Hz 4:3 CEA, sent as 1440x480p (VIC 14) with pixel repetition */
+/* Timings of 720x480p: each pixel is sent twice at 2x the LTDC pixel clock */
+#define LCD_BG_WIDTH  720U
+#define LCD_BG_HEIGHT 480U
+#define HDMI_HFP   16
+#define HDMI_HSYNC 62
+#define HDMI_HBP   60
+#define HDMI_VFP   9
+#define HDMI_VSYNC 6
+#define HDMI_VBP   30
+#define HDMI_PLL4_N       225 /* PLL4 675MHz: exact 27MHz and 25MHz dividers */
+#define HDMI_IC16_CLKDIV  25 /* 27MHz */
+#define LCD_IC16_CLKDIV   27 /* 25MHz */
+#define HDMI_VIC           14
+#define HDMI_ASPECT_16_9   0
+#define HDMI_PIXEL_REPEAT  2
+#elif 0 /* 576p 50Hz 4:3 CEA, sent as 1440x576p (VIC 29) with pixel repetition */
+#define LCD_BG_WIDTH  720U
+#define LCD_BG_HEIGHT 576U
+#define HDMI_HFP   12
+#define HDMI_HSYNC 64
+#define HDMI_HBP   68
+#define HDMI_VFP   5
+#define HDMI_VSYNC 5
+#define HDMI_VBP   39
+#define HDMI_PLL4_N       225 /* PLL4 675MHz: exact 27MHz and 25MHz dividers */
+#define HDMI_IC16_CLKDIV  25 /* 27MHz */
+#define LCD_IC16_CLKDIV   27 /* 25MHz */
+#define HDMI_VIC           29
+#define HDMI_ASPECT_16_9   0
+#define HDMI_PIXEL_REPEAT  2
 #else /* WVGA @ 50Hz 15:9 CVT (STM32N6570-DK LCD native resolution) ***********/
 #define LCD_BG_WIDTH  800U
 #define LCD_BG_HEIGHT 480U
@@ -75,9 +128,51 @@
 #define HDMI_IC16_CLKDIV  24 /* 25MHz ~= 24.5MHz */
 #endif
 
+#ifndef HDMI_VIC
+/* Not a CEA format: DVI mode */
+#define HDMI_VIC           0
+#define HDMI_ASPECT_16_9   0
+#define HDMI_PIXEL_REPEAT  1
+#endif
+
+#ifndef HDMI_PLL4_N
+#define HDMI_PLL4_N       200 /* PLL4 600MHz */
+#define LCD_IC16_CLKDIV   24 /* 25MHz */
+#endif
+
+/* ISP (AE/AWB) scheduling policy, in camera frames */
+#define ISP_PERIOD_CONVERGING      1
+#define ISP_PERIOD_STABLE          8
+#define ISP_STABLE_RUNS            4
+#define ISP_BUDGET_US           2000
+
+/* The loop goes on without camera frames: camera recovery, HDMI, trace */
+#define CAMERA_EVENT_TIMEOUT_MS  100U
+
+/* Trace records sent per loop iteration (8 bytes each) */
+#define TRACE_DRAIN_RECORDS       64
+
+/* PMU region counters traced and shown on the HUD */
+#define PERF_REPORT_PERIOD_MS   1000
+
+/* Overlay text lines: status on top, performance HUD below */
+#define OVERLAY_STATUS_LINES       2U
+#define OVERLAY_LINES             (OVERLAY_STATUS_LINES + HUD_LINE_NB)
+
+/* Display latency test instead of the HUD (see Inc/disp_latency.h), 1 to enable */
+#define DISP_LATENCY_TEST          0
+#define DISP_LATENCY_PERIOD_MS   500U
+#define DISP_LATENCY_FLASHES      40U
+
+/* IQ profile loaded from NOR at boot, built-in tables if absent */
+#define IQ_PROFILE_BOOT            0
+
 #define LCD_FG_WIDTH             320U
-#define LCD_FG_HEIGHT             50U
+#define LCD_FG_HEIGHT            140U
 #define LCD_FG_FRAMEBUFFER_SIZE  (LCD_FG_WIDTH * LCD_FG_HEIGHT * 2)
+#define LCD_BG_FRAMEBUFFER_SIZE  (LCD_BG_WIDTH * LCD_BG_HEIGHT * 2)
+
+#define CAMERA_OUTPUT_FORMAT     DCMIPP_PIXEL_PACKER_FORMAT_RGB565_1
 
 typedef struct
 {
@@ -103,22 +198,50 @@ Rectangle_TypeDef lcd_fg_area = {
   .YSize = LCD_FG_HEIGHT,
 };
 
-/* Lcd Background Buffer */
-__attribute__ ((section (".psram_bss")))
-__attribute__ ((aligned (32)))
-uint8_t lcd_bg_buffer[LCD_BG_WIDTH * LCD_BG_HEIGHT * 2];
+/* Lcd Background Buffer, written by the camera */
+static uint8_t *lcd_bg_buffer;
 
 /* Lcd Foreground Buffer */
-__attribute__ ((section (".psram_bss")))
-__attribute__ ((aligned (32)))
-uint8_t lcd_fg_buffer[LCD_FG_WIDTH * LCD_FG_HEIGHT * 2];
+static uint8_t *lcd_fg_buffer;
 
 static int is_hdmi;
+/* Full range RGB from the LTDC, limited range sent for CEA formats to monitors
+ * without RGB range selection; Game content: monitors skip their picture
+ * processing and its latency */
+static const HDMI_Video_t hdmi_video = {
+  .vic = HDMI_VIC,
+  .aspect_16_9 = HDMI_ASPECT_16_9,
+  .pixel_repeat = HDMI_PIXEL_REPEAT,
+  .full_range = 1,
+  .content = HDMI_CONTENT_GAME,
+};
+/* Sensor default resolution, identifies the sensor for persisted ISP state */
+static uint32_t camera_sensor_id;
+/* Sensor mode negotiated for the display */
+static CAMERA_MODE_Choice_t camera_mode;
+/* USER1 button requests the next IQ profile */
+static volatile int iq_profile_next_request;
+/* Configuration of the previous boot if any, configuration in use */
+static BOOT_CONF_t boot_conf_saved;
+static int boot_conf_loaded;
+static BOOT_CONF_t boot_conf;
+
+/* Set from DCMIPP interrupt, consumed by the app loop */
+static volatile uint32_t camera_vsync_pending;
+static volatile uint32_t camera_frame_count;
 
 static void SystemClock_Config(void);
 static void Hardware_init(void);
-static void Camera_Init(void);
+static int32_t Camera_Init(uint32_t refresh_mhz, const BOOT_CONF_t *known);
+static int32_t Camera_InitKnown(uint32_t refresh_mhz, const BOOT_CONF_t *known);
+static int32_t Camera_SetPipe(void);
 static void LCD_init(void);
+static int App_WaitCameraEvent(void);
+static int32_t Camera_Restart(void);
+static int32_t Camera_GetIqTable(void);
+static void App_SelectNextIqProfile(void);
+static void App_ReportPerf(void);
+static void App_TrackBoot(void);
 
 /**
   * @brief  Main program
@@ -127,39 +250,452 @@ static void LCD_init(void);
   */
 int main(void)
 {
+  int camera_event;
+  int32_t ret;
 
-  Hardware_init();
+  /* Boot phases are timed from here */
+  BOOT_PROF_Init();
 
-  Camera_Init();
+  /* Interrupt hot paths in ITCM before any interrupt is enabled */
+  TCM_Init();
 
-  is_hdmi = HDMI_Detect();
+  Hardware_init();
+  BOOT_PROF_Mark(BOOT_PROF_HARDWARE);
+
+  /* Timestamps events from here on */
+  TRACE_Init();
+  PERF_MON_Init();
+
+  /* Nothing may be placed in PSRAM before its clock is settled */
+#if PSRAM_TUNE
+  PSRAM_TUNE_Result_t psram_default;
+  PSRAM_TUNE_Result_t psram_tuned;
+  ret = PSRAM_TUNE_Run(&psram_default, &psram_tuned);
+  assert(ret == PSRAM_TUNE_ERROR_NONE);
+#else
+  PSRAM_TUNE_Apply();
+#endif
+
+  /* Scanned out buffers are kept off the XSPI when the AXISRAM holds them */
+  FB_ALLOC_Init();
+  lcd_bg_buffer = FB_ALLOC_Alloc(LCD_BG_FRAMEBUFFER_SIZE, FB_ALLOC_ACCESS_SCANOUT | FB_ALLOC_ACCESS_CAPTURE);
+  lcd_fg_buffer = FB_ALLOC_Alloc(LCD_FG_FRAMEBUFFER_SIZE, FB_ALLOC_ACCESS_SCANOUT | FB_ALLOC_ACCESS_CPU);
+  assert(lcd_bg_buffer != NULL && lcd_fg_buffer != NULL);
+
+  /* ISP tables must be in place before the camera middleware starts the ISP */
+  IQ_PROFILE_Init(IQ_PROFILE_BOOT);
+  BOOT_PROF_Mark(BOOT_PROF_NOR);
+
+  /* Tuning tool link, also started by the ISP at camera init */
+  ret = ISP_TOOL_UART_Init();
+  assert(ret == ISP_TOOL_UART_ERROR_NONE);
+
+  /* Boot into the configuration of the previous boot, it is verified once
+   * running (App_TrackBoot). Otherwise monitor detection completes in the
+   * background (HDMI_Process) while the display and camera are brought up. */
+  HDMI_SetVideo(&hdmi_video);
+  boot_conf_loaded = BOOT_CONF_Load(&boot_conf_saved) == BOOT_CONF_ERROR_NONE;
+  if (boot_conf_loaded)
+  {
+    is_hdmi = boot_conf_saved.is_hdmi;
+    if (is_hdmi)
+    {
+      HDMI_Resume();
+    }
+  }
+  else
+  {
+    is_hdmi = HDMI_Detect();
+    if (is_hdmi)
+    {
+      HDMI_Start();
+    }
+  }
   if (is_hdmi)
   {
-    HDMI_Init();
+    HDMI_Process();
   }
+  BOOT_PROF_Mark(BOOT_PROF_HDMI_DETECT);
 
   LCD_init();
+  BOOT_PROF_Mark(BOOT_PROF_LCD);
+
+  boot_conf.is_hdmi = is_hdmi;
+  boot_conf.width = LCD_BG_WIDTH;
+  boot_conf.height = LCD_BG_HEIGHT;
+  boot_conf.pixel_clock_hz = HAL_RCCEx_GetPeriphCLKFreq(RCC_PERIPHCLK_LTDC);
+  boot_conf.refresh_mhz = SCANLINE_GetRefreshMilliHz();
+  boot_conf.layer_formats = (LCD_PIXEL_FORMAT_RGB565 << 16) | LCD_PIXEL_FORMAT_ARGB4444;
 
   UTIL_LCD_SetLayer(LTDC_LAYER_2);
   UTIL_LCD_Clear(0x00000000UL);
   UTIL_LCD_SetFont(&Font20);
   UTIL_LCD_SetTextColor(UTIL_LCD_COLOR_WHITE);
 
-  UTIL_LCD_FillRect(0, 0, LCD_FG_WIDTH, LINE(2), 0x80202020UL); /* dark gray 50% opacity */
+  UTIL_LCD_FillRect(0, 0, LCD_FG_WIDTH, LINE(OVERLAY_LINES), 0x80202020UL); /* dark gray 50% opacity */
+  /* Clear and fill are DMA2D transfers: lines the CPU cached are stale */
+  CACHE_CTL_Invalidate(lcd_fg_buffer, LCD_FG_FRAMEBUFFER_SIZE);
   UTIL_LCD_SetBackColor(0x80202020UL); /* dark gray 50% opacity */
 
+  /* Sensor mode depends on the display refresh rate, the saved one only
+   * applies to the same display output */
+  ret = Camera_Init(boot_conf.refresh_mhz,
+                    boot_conf_loaded && BOOT_CONF_IsSameDisplay(&boot_conf, &boot_conf_saved) ?
+                    &boot_conf_saved : NULL);
+  if (ret != CMW_ERROR_NONE)
+  {
+    /* Camera_Init() left the reason on screen */
+    while (1)
+    {
+      __WFI();
+    }
+  }
+
+  BOOT_PROF_Mark(BOOT_PROF_CAMERA_INIT);
+
+  boot_conf.sensor_id = camera_sensor_id;
+  boot_conf.sensor_width = camera_mode.mode->width;
+  boot_conf.sensor_height = camera_mode.mode->height;
+  boot_conf.sensor_fps = camera_mode.fps;
+  boot_conf.camera_format = CAMERA_OUTPUT_FORMAT;
+
   UTIL_LCDEx_PrintfAtLine(0, "HDMI detected = %d", is_hdmi);
-  UTIL_LCDEx_PrintfAtLine(1, "%dx%d", LCD_BG_WIDTH, LCD_BG_HEIGHT);
+  UTIL_LCDEx_PrintfAtLine(1, "%dx%d<-%lux%lu@%lu", LCD_BG_WIDTH, LCD_BG_HEIGHT,
+                          (unsigned long) camera_mode.mode->width, (unsigned long) camera_mode.mode->height,
+                          (unsigned long) camera_mode.fps);
 
-  int32_t ret = CMW_CAMERA_Start(DCMIPP_PIPE1, lcd_bg_buffer, CMW_MODE_CONTINUOUS);
+  /* Per frame sequence number and timestamps, presentation at vblank */
+  ret = FRAME_META_Init(CMW_CAMERA_GetDCMIPPHandle(), DCMIPP_PIPE1, SCANLINE_VBLANK(LCD_BG_HEIGHT));
+  assert(ret == FRAME_META_ERROR_NONE);
+
+  /* Camera writes throttled as much as the display mode needs */
+  ret = BUS_ARB_Init(CMW_CAMERA_GetDCMIPPHandle(), boot_conf.pixel_clock_hz);
+  assert(ret == BUS_ARB_ERROR_NONE);
+
+  ret = CMW_CAMERA_Start(DCMIPP_PIPE1, lcd_bg_buffer, CMW_MODE_CONTINUOUS);
   assert(ret == CMW_ERROR_NONE);
+  BOOT_PROF_Mark(BOOT_PROF_CAMERA_START);
+
+  /* Start AE/AWB from the last converged state instead of sensor defaults */
+  ISP_SEED_Apply(camera_sensor_id);
+
+  /* Sensor and pipe restarted in place on persistent link errors or stalls */
+  CAM_RECOVERY_Conf_t cam_recovery_conf = {
+    .frame_period_ms = 1000U / camera_mode.fps,
+    .restart = Camera_Restart,
+  };
+  CAM_RECOVERY_Init(&cam_recovery_conf);
+
+  CPU_LOAD_Init();
+
+  /* Camera and display running: ITCM against AXISRAM interrupt latency, in the trace */
+  TCM_Latency_t latency_itcm;
+  TCM_Latency_t latency_axisram;
+  TCM_MeasureLatency(&latency_itcm, &latency_axisram);
+
+  HUD_Conf_t hud_conf = {
+    .first_line = OVERLAY_STATUS_LINES,
+    .vblank_line = SCANLINE_VBLANK(LCD_BG_HEIGHT),
+    .display_bytes = (FB_ALLOC_IsExternal(lcd_bg_buffer) ? LCD_BG_FRAMEBUFFER_SIZE : 0) +
+                     (FB_ALLOC_IsExternal(lcd_fg_buffer) ? LCD_FG_FRAMEBUFFER_SIZE : 0),
+    .camera_bytes = FB_ALLOC_IsExternal(lcd_bg_buffer) ? LCD_BG_FRAMEBUFFER_SIZE : 0,
+  };
+  ret = HUD_Init(&hud_conf);
+  assert(ret == HUD_ERROR_NONE);
+  HUD_SetVisible(1);
+
+#if DISP_LATENCY_TEST
+  /* Patch over the HUD lines, the HUD still measures and traces */
+  DISP_LATENCY_Conf_t latency_conf = {
+    .x = 0,
+    .y = LINE(OVERLAY_STATUS_LINES),
+    .size = LCD_FG_HEIGHT - LINE(OVERLAY_STATUS_LINES),
+    .period_ms = DISP_LATENCY_PERIOD_MS,
+    .flashes_per_content = DISP_LATENCY_FLASHES,
+  };
+  HUD_SetVisible(0);
+  ret = DISP_LATENCY_Init(&latency_conf);
+  assert(ret == DISP_LATENCY_ERROR_NONE);
+#endif
+
+  ISP_SCHED_Conf_t isp_sched_conf = {
+    .period_converging = ISP_PERIOD_CONVERGING,
+    .period_stable = ISP_PERIOD_STABLE,
+    .stable_runs = ISP_STABLE_RUNS,
+    .budget_us = ISP_BUDGET_US,
+  };
+  ISP_SCHED_Init(&isp_sched_conf);
+
+  BSP_PB_Init(BUTTON_USER1, BUTTON_MODE_EXTI);
 
   /*** App Loop ***************************************************************/
   while (1)
   {
-    ret = CMW_CAMERA_Run(); /* Update ISP */
-    assert(ret == CMW_ERROR_NONE);
+    /* ISP only has new statistics to process once per frame */
+    camera_event = App_WaitCameraEvent();
+
+    /* HDMI bring-up, then once configured: link health check, recovery
+     * after monitor power cycles */
+    if (is_hdmi)
+    {
+      HDMI_Process();
+    }
+
+    /* Boot time until the first frame is on screen, HDMI bring-up checked */
+    App_TrackBoot();
+
+    /* Camera errors and stalls, the display keeps the last frame meanwhile */
+    CAM_RECOVERY_Process();
+
+    /* Tuning tool commands are executed by the next ISP run */
+    if (ISP_TOOL_UART_Process())
+    {
+      ISP_SCHED_Kick();
+    }
+
+    if (camera_event)
+    {
+      if (iq_profile_next_request)
+      {
+        iq_profile_next_request = 0;
+        App_SelectNextIqProfile();
+      }
+      /* Frame boundary: pending IQ profile switch latches on next frame */
+      IQ_PROFILE_OnFrameStart();
+
+      ret = ISP_SCHED_OnFrame(); /* Update ISP when due */
+      if (ret != CMW_ERROR_NONE)
+      {
+        /* Counted with the camera errors, persistent ones restart the camera */
+        CAM_RECOVERY_OnIspError();
+      }
+
+      /* Reports convergence time and persists the state once (NOR write) */
+      ISP_SCHED_Stats_t isp_stats;
+      ISP_SCHED_GetStats(&isp_stats);
+      FRAME_META_SetSensor(isp_stats.exposure, isp_stats.gain);
+      ISP_SEED_Process(isp_stats.converging);
+    }
+
+    /* Periodic, also while the camera is stalled: HUD, arbitration, latency
+     * test */
+    App_ReportPerf();
+
+    /* LTDC underruns while the camera writes raise the arbitration preset */
+    BUS_ARB_Process();
+
+#if DISP_LATENCY_TEST
+    DISP_LATENCY_Process();
+#endif
+
+    /* Bounded: the SWO link must not delay the next frame */
+    TRACE_Drain(TRACE_DRAIN_RECORDS);
+  }
+}
+
+/**
+  * @brief  Sleep until the camera signals a new frame, or timeout
+  * @note   Interrupts are masked around the flag test so that a vsync raised
+  *         between the test and WFI still wakes the core up.
+  * @param  None
+  * @retval 1 on a camera frame event, 0 on timeout
+  */
+static int App_WaitCameraEvent(void)
+{
+  uint32_t start = HAL_GetTick();
+  int event;
+
+  __disable_irq();
+  while (camera_vsync_pending == 0 && HAL_GetTick() - start < CAMERA_EVENT_TIMEOUT_MS)
+  {
+    CPU_LOAD_Sleep();
+    __enable_irq();
+    __disable_irq();
+  }
+  event = camera_vsync_pending != 0;
+  camera_vsync_pending = 0;
+  __enable_irq();
+
+  return event;
+}
+
+/**
+  * @brief  Once per period, read and trace the PMU counters of the tagged
+  *         regions, then update the HUD with them
+  * @param  None
+  * @retval None
+  */
+static void App_ReportPerf(void)
+{
+  static uint32_t report_tick;
+  PERF_MON_Stats_t stats[PERF_MON_REGION_NB];
+  uint32_t region;
+
+  if (HAL_GetTick() - report_tick < PERF_REPORT_PERIOD_MS)
+  {
+    return;
+  }
+  report_tick = HAL_GetTick();
+
+  for (region = 0; region < PERF_MON_REGION_NB; region++)
+  {
+    PERF_MON_GetStats(region, &stats[region], 1);
+    PERF_MON_Trace(region, &stats[region]);
+  }
+
+  /* Only changed characters are drawn */
+  HUD_Process(stats);
+}
+
+/**
+  * @brief  Follow the HDMI bring-up run by the main loop, verify the
+  *         configuration of the previous boot and report the boot time once
+  *         the first camera frame is scanned out on a ready display
+  * @note   Another monitor restarts the HDMI bring-up with full detection. A
+  *         transmitter that appeared or disappeared changes the display
+  *         setup: the saved configuration is dropped and the board restarts.
+  * @param  None
+  * @retval None
+  */
+static void App_TrackBoot(void)
+{
+  static int hdmi_ready;
+  static int hdmi_checked;
+  static int boot_done;
+  FRAME_META_Stats_t frames;
+  int32_t state;
+
+  if (boot_done)
+  {
+    return;
+  }
+
+  if (boot_conf_loaded && !is_hdmi && !hdmi_checked)
+  {
+    hdmi_checked = 1;
+    if (HDMI_Detect())
+    {
+      BOOT_CONF_Invalidate();
+      NVIC_SystemReset();
+    }
+  }
+
+  if (is_hdmi && !hdmi_ready)
+  {
+    state = HDMI_GetState();
+    if (state == HDMI_STATE_ABSENT)
+    {
+      BOOT_CONF_Invalidate();
+      NVIC_SystemReset();
+    }
+    if (state != HDMI_STATE_CONFIGURED)
+    {
+      return;
+    }
+    boot_conf.edid_hash = HDMI_GetEdidHash();
+    if (boot_conf_loaded && !hdmi_checked && boot_conf.edid_hash != boot_conf_saved.edid_hash)
+    {
+      hdmi_checked = 1;
+      HDMI_Start();
+      return;
+    }
+    hdmi_checked = 1;
+    hdmi_ready = 1;
+    BOOT_PROF_Mark(BOOT_PROF_HDMI_READY);
+  }
+
+  FRAME_META_GetStats(&frames);
+  if (frames.presented == 0)
+  {
+    return;
+  }
+  boot_done = 1;
+  BOOT_PROF_Mark(BOOT_PROF_FIRST_FRAME);
+  BOOT_PROF_Trace();
+
+  UTIL_LCDEx_PrintfAtLine(0, "HDMI %d boot %lums%s", is_hdmi,
+                          (unsigned long)(BOOT_PROF_GetUs(BOOT_PROF_FIRST_FRAME) / 1000U),
+                          boot_conf_loaded ? " LKG" : "");
+
+  /* Next boot starts from this configuration */
+  BOOT_CONF_Save(&boot_conf);
+}
+
+/**
+  * @brief  Cycle through the NOR IQ profiles, back to built-in after the last
+  * @note   Empty slots, bad images and images without a table for this sensor
+  *         are skipped. A press while a switch is pending is ignored.
+  * @param  None
+  * @retval None
+  */
+static void App_SelectNextIqProfile(void)
+{
+  int32_t table = Camera_GetIqTable();
+  int32_t profile = IQ_PROFILE_GetCurrent();
+  int32_t ret;
+
+  if (table == IQ_PROFILE_TABLE_NONE)
+  {
+    return;
+  }
+
+  do {
+    profile = profile + 1 < NVM_IQ_PROFILE_NB ? profile + 1 : IQ_PROFILE_BUILTIN;
+    ret = IQ_PROFILE_Select(profile, table);
+  } while (ret != IQ_PROFILE_ERROR_NONE && ret != IQ_PROFILE_ERROR_BUSY && profile != IQ_PROFILE_BUILTIN);
+}
+
+/**
+  * @brief  IQ table used by the ISP middleware for the detected sensor
+  * @param  None
+  * @retval IQ_PROFILE_TABLE_xxx
+  */
+static int32_t Camera_GetIqTable(void)
+{
+  switch (camera_sensor_id)
+  {
+  case (2592 << 16) | 1944:
+    return IQ_PROFILE_TABLE_IMX335;
+  case (1120 << 16) | 720:
+    return IQ_PROFILE_TABLE_VD66GY;
+  default:
+    /* VD55G1 is monochrome and has no IQ table */
+    return IQ_PROFILE_TABLE_NONE;
+  }
+}
+
+void BSP_PB_Callback(Button_TypeDef Button)
+{
+  if (Button == BUTTON_USER1)
+  {
+    iq_profile_next_request = 1;
+  }
+}
+
+TCM_CODE int CMW_CAMERA_PIPE_VsyncEventCallback(uint32_t pipe)
+{
+  TRACE_Record(TRACE_EVT_CAM_VSYNC, pipe);
+
+  if (pipe == DCMIPP_PIPE1)
+  {
+    FRAME_META_OnCaptureStart();
+    camera_vsync_pending = 1;
   }
+
+  return HAL_OK;
+}
+
+TCM_CODE int CMW_CAMERA_PIPE_FrameEventCallback(uint32_t pipe)
+{
+  TRACE_Record(TRACE_EVT_CAM_FRAME, pipe);
+
+  if (pipe == DCMIPP_PIPE1)
+  {
+    FRAME_META_OnCaptureEnd();
+    camera_frame_count++;
+  }
+
+  return HAL_OK;
 }
 
 static void Hardware_init(void)
@@ -173,6 +709,9 @@ static void Hardware_init(void)
 
   HAL_Init();
 
+  /* Buffer regions are added by FB_ALLOC */
+  CACHE_CTL_Init();
+
   SCB_EnableICache();
   /* Power on DCACHE */
   MEMSYSCTL->MSCR |= MEMSYSCTL_MSCR_DCACTIVE_Msk;
@@ -200,13 +739,40 @@ static void Hardware_init(void)
   HAL_RIF_RISC_SetSlaveSecureAttributes(RIF_RISC_PERIPH_INDEX_LTDCL2 , RIF_ATTRIBUTE_SEC | RIF_ATTRIBUTE_PRIV);
 }
 
-static void Camera_Init(void)
+/**
+  * @brief  Start the camera in the sensor mode best suited to the display
+  * @note   The sensor mode of a previous boot is tried first. Otherwise, or
+  *         if another sensor is found (boot record invalidated), the sensor
+  *         is probed with its driver defaults to identify it, then
+  *         re-initialized in the negotiated mode. On failure the reason is
+  *         printed on the overlay layer.
+  * @param  refresh_mhz Display refresh rate in mHz
+  * @param  known Configuration of a previous boot on this display, NULL if none
+  * @retval CMW_ERROR_NONE or error
+  */
+static int32_t Camera_Init(uint32_t refresh_mhz, const BOOT_CONF_t *known)
 {
+  CAMERA_MODE_Choice_t choices[CAMERA_MODE_MAX];
   CMW_CameraInit_t cam_conf;
-  CMW_DCMIPP_Conf_t dcmipp_conf;
-  uint32_t pitch;
+  const char *name;
+  uint32_t nb_choices;
+  uint32_t i;
   int32_t ret;
 
+  if (known != NULL)
+  {
+    ret = Camera_InitKnown(refresh_mhz, known);
+    if (ret == CMW_ERROR_NONE)
+    {
+      return Camera_SetPipe();
+    }
+    if (ret == CMW_ERROR_UNKNOWN_COMPONENT)
+    {
+      /* Sensor replaced: the saved configuration is not for this one */
+      BOOT_CONF_Invalidate();
+    }
+  }
+
   cam_conf.width = 0; /* Leave the driver use the default resolution */
   cam_conf.height = 0; /* Leave the driver use the default resolution */
   cam_conf.fps = 30;
@@ -214,22 +780,194 @@ static void Camera_Init(void)
   cam_conf.anti_flicker = 0;
   cam_conf.mirror_flip = CMW_MIRRORFLIP_NONE;
   ret = CMW_CAMERA_Init(&cam_conf);
-  assert(ret == CMW_ERROR_NONE);
+  if (ret != CMW_ERROR_NONE)
+  {
+    UTIL_LCDEx_PrintfAtLine(0, "No camera detected");
+    UTIL_LCDEx_PrintfAtLine(1, "CMW error %ld", (long) ret);
+    return ret;
+  }
+  camera_sensor_id = (cam_conf.width << 16) | cam_conf.height;
+  name = CAMERA_MODE_GetSensorName(camera_sensor_id);
+
+  ret = CAMERA_MODE_Negotiate(camera_sensor_id, LCD_BG_WIDTH, LCD_BG_HEIGHT, refresh_mhz, choices, &nb_choices);
+  if (ret != CAMERA_MODE_ERROR_NONE)
+  {
+    UTIL_LCDEx_PrintfAtLine(0, "%s max %lux%lu", name, (unsigned long) cam_conf.width,
+                            (unsigned long) cam_conf.height);
+    UTIL_LCDEx_PrintfAtLine(1, "cannot output %ux%u", LCD_BG_WIDTH, LCD_BG_HEIGHT);
+    CMW_CAMERA_DeInit();
+    return ret;
+  }
 
-  /* Check output resolution is supported with current camera */
-  ret = cam_conf.width >= LCD_BG_WIDTH && cam_conf.height >= LCD_BG_HEIGHT;
-  assert(ret == 1); /* Camera not supported */
+  /* Best first, skip the modes the driver does not accept */
+  for (i = 0; i < nb_choices; i++)
+  {
+    if (i == 0 && choices[0].mode->width == cam_conf.width && choices[0].mode->height == cam_conf.height &&
+        choices[0].fps == (uint32_t) cam_conf.fps)
+    {
+      /* Probe configuration is the one wanted */
+      break;
+    }
+    CMW_CAMERA_DeInit();
+    cam_conf.width = choices[i].mode->width;
+    cam_conf.height = choices[i].mode->height;
+    cam_conf.fps = choices[i].fps;
+    ret = CMW_CAMERA_Init(&cam_conf);
+    if (ret == CMW_ERROR_NONE)
+    {
+      break;
+    }
+  }
+  if (i == nb_choices)
+  {
+    UTIL_LCDEx_PrintfAtLine(0, "%s: no usable mode", name);
+    UTIL_LCDEx_PrintfAtLine(1, "CMW error %ld", (long) ret);
+    return ret;
+  }
+  camera_mode = choices[i];
+
+  return Camera_SetPipe();
+}
+
+/**
+  * @brief  Start the sensor in the mode saved by a previous boot
+  * @note   The saved mode must still be one negotiated for the display, and
+  *         the sensor started the one saved: a sensor with another ID is
+  *         stopped again.
+  * @param  refresh_mhz Display refresh rate in mHz
+  * @param  known Configuration of a previous boot on this display
+  * @retval CMW_ERROR_NONE or error, CMW_ERROR_UNKNOWN_COMPONENT for another
+  *         sensor
+  */
+static int32_t Camera_InitKnown(uint32_t refresh_mhz, const BOOT_CONF_t *known)
+{
+  CAMERA_MODE_Choice_t choices[CAMERA_MODE_MAX];
+  ISP_SensorInfoTypeDef info;
+  CMW_CameraInit_t cam_conf;
+  uint32_t nb_choices;
+  uint32_t i;
+  int32_t ret;
+
+  if (known->camera_format != CAMERA_OUTPUT_FORMAT)
+  {
+    return CAMERA_MODE_ERROR_NO_MODE;
+  }
+  ret = CAMERA_MODE_Negotiate(known->sensor_id, LCD_BG_WIDTH, LCD_BG_HEIGHT, refresh_mhz, choices, &nb_choices);
+  if (ret != CAMERA_MODE_ERROR_NONE)
+  {
+    return ret;
+  }
+  for (i = 0; i < nb_choices; i++)
+  {
+    if (choices[i].mode->width == known->sensor_width && choices[i].mode->height == known->sensor_height &&
+        choices[i].fps == known->sensor_fps)
+    {
+      break;
+    }
+  }
+  if (i == nb_choices)
+  {
+    return CAMERA_MODE_ERROR_NO_MODE;
+  }
+
+  cam_conf.width = known->sensor_width;
+  cam_conf.height = known->sensor_height;
+  cam_conf.fps = known->sensor_fps;
+  cam_conf.pixel_format = 0; /* Default; Not implemented yet */
+  cam_conf.anti_flicker = 0;
+  cam_conf.mirror_flip = CMW_MIRRORFLIP_NONE;
+  ret = CMW_CAMERA_Init(&cam_conf);
+  if (ret != CMW_ERROR_NONE)
+  {
+    return ret;
+  }
+  /* Identified as by the probe: full resolution of the sensor */
+  ret = CMW_CAMERA_GetSensorInfo(&info);
+  if (ret == CMW_ERROR_NONE && ((info.width << 16) | info.height) != known->sensor_id)
+  {
+    ret = CMW_ERROR_UNKNOWN_COMPONENT;
+  }
+  if (ret != CMW_ERROR_NONE)
+  {
+    CMW_CAMERA_DeInit();
+    return ret;
+  }
+  camera_sensor_id = known->sensor_id;
+  camera_mode = choices[i];
+
+  return CMW_ERROR_NONE;
+}
+
+/**
+  * @brief  Restart sensor and pipe in the mode in use, for CAM_RECOVERY
+  * @note   LTDC, HDMI and the display buffer are left as they are: the last
+  *         frame stays on screen until the first new one is written.
+  * @param  None
+  * @retval CMW_ERROR_NONE or error
+  */
+static int32_t Camera_Restart(void)
+{
+  BUS_ARB_Stats_t bus_arb;
+  int32_t ret;
+
+  CMW_CAMERA_DeInit();
+  ret = Camera_InitKnown(boot_conf.refresh_mhz, &boot_conf);
+  if (ret != CMW_ERROR_NONE)
+  {
+    return ret;
+  }
+  ret = Camera_SetPipe();
+  if (ret != CMW_ERROR_NONE)
+  {
+    return ret;
+  }
+
+  /* DCMIPP settings lost with its re-initialization */
+  FRAME_META_OnPipeRestart();
+  BUS_ARB_GetStats(&bus_arb);
+  BUS_ARB_SetPreset(bus_arb.preset);
+
+  ret = CMW_CAMERA_Start(DCMIPP_PIPE1, lcd_bg_buffer, CMW_MODE_CONTINUOUS);
+  if (ret != CMW_ERROR_NONE)
+  {
+    return ret;
+  }
+  /* Seeded once started, as on boot */
+  ISP_SEED_Apply(camera_sensor_id);
+
+  return CMW_ERROR_NONE;
+}
+
+/**
+  * @brief  Camera output into the display background buffer
+  * @param  None
+  * @retval CMW_ERROR_NONE or error, CMW_ERROR_WRONG_PARAM if the pipe pitch
+  *         does not match the display buffer
+  */
+static int32_t Camera_SetPipe(void)
+{
+  CMW_DCMIPP_Conf_t dcmipp_conf;
+  uint32_t pitch;
+  int32_t ret;
 
   dcmipp_conf.output_width = LCD_BG_WIDTH;
   dcmipp_conf.output_height = LCD_BG_HEIGHT;
-  dcmipp_conf.output_format = DCMIPP_PIXEL_PACKER_FORMAT_RGB565_1;
+  dcmipp_conf.output_format = CAMERA_OUTPUT_FORMAT;
   dcmipp_conf.output_bpp = 2;
   dcmipp_conf.mode = CMW_Aspect_ratio_crop;
   dcmipp_conf.enable_swap = 0;
   dcmipp_conf.enable_gamma_conversion = 0;
   ret = CMW_CAMERA_SetPipeConfig(DCMIPP_PIPE1, &dcmipp_conf, &pitch);
-  assert(ret == HAL_OK);
-  assert(dcmipp_conf.output_width * dcmipp_conf.output_bpp == pitch);
+  if (ret != CMW_ERROR_NONE)
+  {
+    return ret;
+  }
+  if (dcmipp_conf.output_width * dcmipp_conf.output_bpp != pitch)
+  {
+    return CMW_ERROR_WRONG_PARAM;
+  }
+
+  return CMW_ERROR_NONE;
 }
 
 static void LCD_init(void)
@@ -267,6 +1005,11 @@ static void LCD_init(void)
   LayerConfig.Address = (uint32_t) lcd_fg_buffer;
   BSP_LCD_ConfigLayer(0, LTDC_LAYER_2, &LayerConfig);
 
+  /* Further layer updates go through vblank committed transactions */
+  LCD_LAYER_Init(&hlcd_ltdc);
+  /* Work placed at a given beam position (see SCANLINE_Add) */
+  SCANLINE_Init(&hlcd_ltdc);
+
   UTIL_LCD_SetFuncDriver(&LCD_Driver);
 }
 
@@ -310,12 +1053,12 @@ static void SystemClock_Config(void)
   RCC_OscInitStruct.PLL3.PLLP1 = 1;
   RCC_OscInitStruct.PLL3.PLLP2 = 2;
 
-  /* PLL4 = 48 x 200 / 8 / 2 = 600MHz */
+  /* PLL4 = 48 x HDMI_PLL4_N / 8 / 2 = 600MHz (675MHz for the CEA 480p/576p modes) */
   RCC_OscInitStruct.PLL4.PLLState = RCC_PLL_ON;
   RCC_OscInitStruct.PLL4.PLLSource = RCC_PLLSOURCE_HSE;
   RCC_OscInitStruct.PLL4.PLLM = 8;
   RCC_OscInitStruct.PLL4.PLLFractional = 0;
-  RCC_OscInitStruct.PLL4.PLLN = 200;
+  RCC_OscInitStruct.PLL4.PLLN = HDMI_PLL4_N;
   RCC_OscInitStruct.PLL4.PLLP1 = 2;
   RCC_OscInitStruct.PLL4.PLLP2 = 1;
 
@@ -411,7 +1154,7 @@ HAL_StatusTypeDef MX_LTDC_ClockConfig(LTDC_HandleTypeDef *hltdc)
 
   if (is_hdmi)
   {
-    /* Configure LTDC clock to IC16 with PLL4 (600MHz) */
+    /* Configure LTDC clock to IC16 with PLL4 */
     RCC_PeriphCLKInitStruct.PeriphClockSelection |= RCC_PERIPHCLK_LTDC;
     RCC_PeriphCLKInitStruct.LtdcClockSelection = RCC_LTDCCLKSOURCE_IC16;
     RCC_PeriphCLKInitStruct.ICSelection[RCC_IC16].ClockSelection = RCC_ICCLKSOURCE_PLL4;
@@ -419,11 +1162,11 @@ HAL_StatusTypeDef MX_LTDC_ClockConfig(LTDC_HandleTypeDef *hltdc)
   }
   else
   {
-    /* LTDC clock frequency = PLLLCDCLK = 25 Mhz (600 / 24) */
+    /* LTDC clock frequency = PLLLCDCLK = 25 Mhz (600 / 24 or 675 / 27) */
     RCC_PeriphCLKInitStruct.PeriphClockSelection = RCC_PERIPHCLK_LTDC;
     RCC_PeriphCLKInitStruct.LtdcClockSelection = RCC_LTDCCLKSOURCE_IC16;
     RCC_PeriphCLKInitStruct.ICSelection[RCC_IC16].ClockSelection = RCC_ICCLKSOURCE_PLL4;
-    RCC_PeriphCLKInitStruct.ICSelection[RCC_IC16].ClockDivider = 24;
+    RCC_PeriphCLKInitStruct.ICSelection[RCC_IC16].ClockDivider = LCD_IC16_CLKDIV;
   }
 
   if (HAL_RCCEx_PeriphCLKConfig(&RCC_PeriphCLKInitStruct) != HAL_OK)
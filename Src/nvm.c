@@ -0,0 +1,224 @@
+ /**
+ ******************************************************************************
+ * @file    nvm.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "nvm.h"
+#include "stm32n6570_discovery_xspi.h"
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define NVM_NOR_INSTANCE   0
+#define NVM_BASE           0x07F00000U  /* Last MB of the 128MB NOR */
+#define NVM_SECTOR_SIZE    0x1000U
+#define NVM_MAGIC          0x314D564EU  /* "NVM1" */
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint32_t magic;
+  uint32_t slot;
+  uint32_t version;
+  uint32_t size;
+  uint32_t crc;
+} NVM_Header_t;
+
+/* Private variables ---------------------------------------------------------*/
+/* One 4KB sector per slot */
+static const uint32_t nvm_slot_offset[NVM_SLOT_NB] = {
+  [NVM_SLOT_ISP_STATE] = NVM_BASE + 0 * NVM_SECTOR_SIZE,
+  [NVM_SLOT_BOOT_CONF] = NVM_BASE + 1 * NVM_SECTOR_SIZE,
+  [NVM_SLOT_PSRAM_CLOCK] = NVM_BASE + 2 * NVM_SECTOR_SIZE,
+};
+
+static int nvm_is_init;
+
+/* Private functions ---------------------------------------------------------*/
+static int32_t NVM_wait_ready(void)
+{
+  int32_t ret;
+
+  do {
+    ret = BSP_XSPI_NOR_GetStatus(NVM_NOR_INSTANCE);
+  } while (ret == BSP_ERROR_BUSY);
+
+  return ret == BSP_ERROR_NONE ? NVM_ERROR_NONE : NVM_ERROR_BSP;
+}
+
+/* Functions Definition ------------------------------------------------------*/
+int32_t NVM_Init(void)
+{
+  BSP_XSPI_NOR_Init_t init;
+
+  if (nvm_is_init)
+  {
+    return NVM_ERROR_NONE;
+  }
+
+  init.InterfaceMode = BSP_XSPI_NOR_OPI_MODE;
+  init.TransferRate = BSP_XSPI_NOR_DTR_TRANSFER;
+  if (BSP_XSPI_NOR_Init(NVM_NOR_INSTANCE, &init) != BSP_ERROR_NONE)
+  {
+    return NVM_ERROR_BSP;
+  }
+  nvm_is_init = 1;
+
+  return NVM_ERROR_NONE;
+}
+
+/**
+  * @brief  Read a record
+  * @param  slot NVM_SLOT_xxx
+  * @param  version Layout version expected by the caller
+  * @param  data Destination buffer
+  * @param  size Expected record size
+  * @retval NVM_ERROR_NONE, NVM_ERROR_EMPTY if no matching valid record
+  */
+int32_t NVM_Read(uint32_t slot, uint32_t version, void *data, uint32_t size)
+{
+  NVM_Header_t hdr;
+  uint32_t addr;
+
+  if (slot >= NVM_SLOT_NB || size > NVM_SECTOR_SIZE - sizeof(hdr))
+  {
+    return NVM_ERROR_PARAM;
+  }
+  if (NVM_Init() != NVM_ERROR_NONE)
+  {
+    return NVM_ERROR_BSP;
+  }
+
+  addr = nvm_slot_offset[slot];
+  if (BSP_XSPI_NOR_Read(NVM_NOR_INSTANCE, (uint8_t *) &hdr, addr, sizeof(hdr)) != BSP_ERROR_NONE)
+  {
+    return NVM_ERROR_BSP;
+  }
+  if (hdr.magic != NVM_MAGIC || hdr.slot != slot || hdr.version != version || hdr.size != size)
+  {
+    return NVM_ERROR_EMPTY;
+  }
+  if (BSP_XSPI_NOR_Read(NVM_NOR_INSTANCE, data, addr + sizeof(hdr), size) != BSP_ERROR_NONE)
+  {
+    return NVM_ERROR_BSP;
+  }
+  if (NVM_Crc32(0, data, size) != hdr.crc)
+  {
+    return NVM_ERROR_EMPTY;
+  }
+
+  return NVM_ERROR_NONE;
+}
+
+/**
+  * @brief  Replace a record
+  * @note   Blocking: sector erase takes tens of milliseconds. A power loss in
+  *         the middle leaves an invalid record, read back as NVM_ERROR_EMPTY.
+  */
+int32_t NVM_Write(uint32_t slot, uint32_t version, const void *data, uint32_t size)
+{
+  NVM_Header_t hdr;
+  uint32_t addr;
+  int32_t ret;
+
+  if (slot >= NVM_SLOT_NB || size > NVM_SECTOR_SIZE - sizeof(hdr))
+  {
+    return NVM_ERROR_PARAM;
+  }
+
+  ret = NVM_Erase(slot);
+  if (ret != NVM_ERROR_NONE)
+  {
+    return ret;
+  }
+
+  addr = nvm_slot_offset[slot];
+  hdr.magic = NVM_MAGIC;
+  hdr.slot = slot;
+  hdr.version = version;
+  hdr.size = size;
+  hdr.crc = NVM_Crc32(0, data, size);
+
+  /* Payload first so that a valid header always describes a complete record */
+  if (BSP_XSPI_NOR_Write(NVM_NOR_INSTANCE, data, addr + sizeof(hdr), size) != BSP_ERROR_NONE)
+  {
+    return NVM_ERROR_BSP;
+  }
+  if (BSP_XSPI_NOR_Write(NVM_NOR_INSTANCE, (const uint8_t *) &hdr, addr, sizeof(hdr)) != BSP_ERROR_NONE)
+  {
+    return NVM_ERROR_BSP;
+  }
+
+  return NVM_wait_ready();
+}
+
+int32_t NVM_Erase(uint32_t slot)
+{
+  if (slot >= NVM_SLOT_NB)
+  {
+    return NVM_ERROR_PARAM;
+  }
+  if (NVM_Init() != NVM_ERROR_NONE)
+  {
+    return NVM_ERROR_BSP;
+  }
+
+  if (BSP_XSPI_NOR_Erase_Block(NVM_NOR_INSTANCE, nvm_slot_offset[slot], BSP_XSPI_NOR_ERASE_4K) != BSP_ERROR_NONE)
+  {
+    return NVM_ERROR_BSP;
+  }
+
+  return NVM_wait_ready();
+}
+
+/**
+  * @brief  Read NOR content outside of the record slots
+  * @param  offset Offset from the start of the NOR
+  */
+int32_t NVM_ReadRaw(uint32_t offset, void *data, uint32_t size)
+{
+  if (NVM_Init() != NVM_ERROR_NONE)
+  {
+    return NVM_ERROR_BSP;
+  }
+  if (BSP_XSPI_NOR_Read(NVM_NOR_INSTANCE, data, offset, size) != BSP_ERROR_NONE)
+  {
+    return NVM_ERROR_BSP;
+  }
+
+  return NVM_ERROR_NONE;
+}
+
+/**
+  * @brief  CRC-32 (IEEE 802.3, reflected), chainable: pass 0 for first chunk
+  */
+uint32_t NVM_Crc32(uint32_t crc, const void *data, uint32_t size)
+{
+  const uint8_t *p = data;
+  int i;
+
+  crc = ~crc;
+  while (size--)
+  {
+    crc ^= *p++;
+    for (i = 0; i < 8; i++)
+    {
+      crc = (crc >> 1) ^ (0xEDB88320U & -(crc & 1U));
+    }
+  }
+
+  return ~crc;
+}
@@ -0,0 +1,175 @@
+ /**
+ ******************************************************************************
+ * @file    perf_mon.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "perf_mon.h"
+#include "trace.h"
+#include "stm32n6xx_hal.h"
+#include <assert.h>
+
+/* Private define ------------------------------------------------------------*/
+/* PMU event counters are 16-bit: each event uses a pair, the odd counter
+ * counts the overflows of the even one (CHAIN event) */
+#define PERF_MON_CNT_DCACHE_MISS    0U
+#define PERF_MON_CNT_STALL          2U
+#define PERF_MON_CNT_INSTR          4U
+#define PERF_MON_CNT_BUS            6U
+#define PERF_MON_CNT_MASK           0xffU
+
+#define PERF_MON_TRACE_MAX          0xffffffU
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint32_t cycles;
+  uint32_t instructions;
+  uint32_t dcache_misses;
+  uint32_t stalls;
+  uint32_t bus_accesses;
+} PERF_MON_Sample_t;
+
+/* Private variables ---------------------------------------------------------*/
+static PERF_MON_Sample_t perf_mon_start[PERF_MON_REGION_NB];
+static PERF_MON_Stats_t perf_mon_stats[PERF_MON_REGION_NB];
+
+/* Private functions ---------------------------------------------------------*/
+static uint32_t PERF_MON_read_pair(uint32_t counter)
+{
+  uint32_t hi;
+  uint32_t lo;
+
+  /* The low half may wrap between the two reads */
+  do {
+    hi = ARM_PMU_Get_EVCNTR(counter + 1);
+    lo = ARM_PMU_Get_EVCNTR(counter);
+  } while (hi != ARM_PMU_Get_EVCNTR(counter + 1));
+
+  return (hi << 16) | (lo & 0xffffU);
+}
+
+static void PERF_MON_sample(PERF_MON_Sample_t *sample)
+{
+  sample->cycles = DWT->CYCCNT;
+  sample->instructions = PERF_MON_read_pair(PERF_MON_CNT_INSTR);
+  sample->dcache_misses = PERF_MON_read_pair(PERF_MON_CNT_DCACHE_MISS);
+  sample->stalls = PERF_MON_read_pair(PERF_MON_CNT_STALL);
+  sample->bus_accesses = PERF_MON_read_pair(PERF_MON_CNT_BUS);
+}
+
+static uint32_t PERF_MON_per_run(uint32_t total, uint32_t runs)
+{
+  uint32_t avg = runs ? total / runs : 0;
+
+  return avg < PERF_MON_TRACE_MAX ? avg : PERF_MON_TRACE_MAX;
+}
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+  * @brief  Configure and start the PMU event counters
+  * @note   Events of the Secure state are only counted when secure
+  *         non-invasive debug is allowed, which is requested here.
+  */
+void PERF_MON_Init(void)
+{
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DCB->DAUTHCTRL |= DCB_DAUTHCTRL_SPNIDENSEL_Msk | DCB_DAUTHCTRL_INTSPNIDEN_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  ARM_PMU_Set_EVTYPER(PERF_MON_CNT_DCACHE_MISS, ARM_PMU_L1D_CACHE_REFILL);
+  ARM_PMU_Set_EVTYPER(PERF_MON_CNT_DCACHE_MISS + 1, ARM_PMU_CHAIN);
+  ARM_PMU_Set_EVTYPER(PERF_MON_CNT_STALL, ARM_PMU_STALL_BACKEND);
+  ARM_PMU_Set_EVTYPER(PERF_MON_CNT_STALL + 1, ARM_PMU_CHAIN);
+  ARM_PMU_Set_EVTYPER(PERF_MON_CNT_INSTR, ARM_PMU_INST_RETIRED);
+  ARM_PMU_Set_EVTYPER(PERF_MON_CNT_INSTR + 1, ARM_PMU_CHAIN);
+  ARM_PMU_Set_EVTYPER(PERF_MON_CNT_BUS, ARM_PMU_BUS_ACCESS);
+  ARM_PMU_Set_EVTYPER(PERF_MON_CNT_BUS + 1, ARM_PMU_CHAIN);
+
+  ARM_PMU_EVCNTR_ALL_Reset();
+  ARM_PMU_CNTR_Enable(PERF_MON_CNT_MASK);
+  ARM_PMU_Enable();
+}
+
+void PERF_MON_Begin(uint32_t region)
+{
+  assert(region < PERF_MON_REGION_NB);
+
+  PERF_MON_sample(&perf_mon_start[region]);
+}
+
+void PERF_MON_End(uint32_t region)
+{
+  PERF_MON_Sample_t *start = &perf_mon_start[region];
+  PERF_MON_Stats_t *stats = &perf_mon_stats[region];
+  PERF_MON_Sample_t now;
+  uint32_t cycles;
+
+  PERF_MON_sample(&now);
+
+  /* Interrupt regions update their own entry, the application only reads
+   * them with interrupts masked */
+  cycles = now.cycles - start->cycles;
+  stats->runs++;
+  stats->cycles += cycles;
+  if (cycles > stats->max_cycles)
+  {
+    stats->max_cycles = cycles;
+  }
+  stats->instructions += now.instructions - start->instructions;
+  stats->dcache_misses += now.dcache_misses - start->dcache_misses;
+  stats->stalls += now.stalls - start->stalls;
+  stats->bus_accesses += now.bus_accesses - start->bus_accesses;
+}
+
+/**
+  * @brief  Read the counters accumulated by a region
+  * @param  region PERF_MON_REGION_xxx
+  * @param  stats Accumulated counters
+  * @param  reset Restart accumulation, e.g. once per reporting period
+  * @retval None
+  */
+void PERF_MON_GetStats(uint32_t region, PERF_MON_Stats_t *stats, int reset)
+{
+  uint32_t primask;
+
+  assert(region < PERF_MON_REGION_NB);
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  *stats = perf_mon_stats[region];
+  if (reset)
+  {
+    perf_mon_stats[region] = (PERF_MON_Stats_t) {0};
+  }
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  Report region counters in the trace, as averages per run
+  * @param  region PERF_MON_REGION_xxx
+  * @param  stats Counters read with PERF_MON_GetStats()
+  * @retval None
+  */
+void PERF_MON_Trace(uint32_t region, const PERF_MON_Stats_t *stats)
+{
+  TRACE_Record(TRACE_EVT_PMU_REGION, (region << 16) | (stats->runs < 0xffffU ? stats->runs : 0xffffU));
+  TRACE_Record(TRACE_EVT_PMU_CYCLES, PERF_MON_per_run(stats->cycles, stats->runs));
+  TRACE_Record(TRACE_EVT_PMU_INSTR, PERF_MON_per_run(stats->instructions, stats->runs));
+  TRACE_Record(TRACE_EVT_PMU_DCACHE_MISS, PERF_MON_per_run(stats->dcache_misses, stats->runs));
+  TRACE_Record(TRACE_EVT_PMU_STALL, PERF_MON_per_run(stats->stalls, stats->runs));
+  TRACE_Record(TRACE_EVT_PMU_BUS, PERF_MON_per_run(stats->bus_accesses, stats->runs));
+}
@@ -0,0 +1,445 @@
+ /**
+ ******************************************************************************
+ * @file    psram_tune.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "psram_tune.h"
+#include "nvm.h"
+#include "trace.h"
+#include "cache_ctl.h"
+#include "stm32n6xx_hal.h"
+#include "stm32n6570_discovery_xspi.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(DEBUG)
+#define PRINTF(...)    printf(__VA_ARGS__)
+#else
+#define PRINTF(...)
+#endif /* defined(DEBUG) */
+
+/* Private define ------------------------------------------------------------*/
+#define PSRAM_TUNE_VERSION       1
+#define PSRAM_TUNE_RAM_INSTANCE  0
+#define PSRAM_TUNE_LINE          32U
+
+/* Benchmark on the first half of the area, DMA2D copies within the second */
+#define PSRAM_TUNE_WINDOW_SIZE   (PSRAM_TUNE_AREA_SIZE / 2U)
+#define PSRAM_TUNE_CHUNK_SIZE    0x10000U
+#define PSRAM_TUNE_DMA_SRC       (PSRAM_TUNE_AREA + PSRAM_TUNE_WINDOW_SIZE)
+#define PSRAM_TUNE_DMA_DST       (PSRAM_TUNE_DMA_SRC + PSRAM_TUNE_WINDOW_SIZE / 2U)
+/* ARGB8888 lines of 4KB, half a window */
+#define PSRAM_TUNE_DMA_WIDTH     1024U
+#define PSRAM_TUNE_DMA_HEIGHT    (PSRAM_TUNE_WINDOW_SIZE / 2U / (PSRAM_TUNE_DMA_WIDTH * 4U))
+
+/* Latency: cache lines visited in a pseudo random order (full period LCG
+ * modulo the power of two number of lines), out of reach of the prefetcher */
+#define PSRAM_TUNE_CHASE_MUL     4101U
+#define PSRAM_TUNE_CHASE_ADD     4099U
+#define PSRAM_TUNE_CHASE_HOPS    4096U
+
+#define PSRAM_TUNE_TRACE_MAX     0xfffU
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint32_t source;     /*!< RCC_XSPI1CLKSOURCE_xxx */
+  uint32_t pll;        /*!< IC3 input, RCC_ICCLKSOURCE_xxx */
+  uint32_t divider;    /*!< IC3 divider */
+  uint32_t hz;
+} PSRAM_TUNE_Clock_t;
+
+typedef struct
+{
+  uint32_t hz;
+} PSRAM_TUNE_Record_t;
+
+/* Private variables ---------------------------------------------------------*/
+/* Slowest first. The first one is the SystemClock_Config() setting, at the
+ * 200 MHz rating; the others are overclocks, see PSRAM_TUNE_OVERCLOCK. */
+static const PSRAM_TUNE_Clock_t psram_tune_clocks[] = {
+  { RCC_XSPI1CLKSOURCE_HCLK, 0, 0, 200000000U },
+#if PSRAM_TUNE_OVERCLOCK
+  { RCC_XSPI1CLKSOURCE_IC3, RCC_ICCLKSOURCE_PLL3, 4, 225000000U },
+  { RCC_XSPI1CLKSOURCE_IC3, RCC_ICCLKSOURCE_PLL2, 4, 250000000U },
+  { RCC_XSPI1CLKSOURCE_IC3, RCC_ICCLKSOURCE_PLL1, 3, 266666666U },
+#endif
+};
+#define PSRAM_TUNE_CLOCK_NB   (sizeof(psram_tune_clocks) / sizeof(psram_tune_clocks[0]))
+
+static uint32_t psram_tune_clock;
+static DMA2D_HandleTypeDef psram_tune_dma2d;
+static volatile uint32_t psram_tune_sink;
+
+/* Private functions ---------------------------------------------------------*/
+static int32_t PSRAM_TUNE_set_clock(uint32_t index)
+{
+  const PSRAM_TUNE_Clock_t *clock = &psram_tune_clocks[index];
+  RCC_PeriphCLKInitTypeDef rcc = {0};
+
+  if (BSP_XSPI_RAM_DeInit(PSRAM_TUNE_RAM_INSTANCE) != BSP_ERROR_NONE)
+  {
+    return PSRAM_TUNE_ERROR_BSP;
+  }
+
+  rcc.PeriphClockSelection = RCC_PERIPHCLK_XSPI1;
+  rcc.Xspi1ClockSelection = clock->source;
+  if (clock->source == RCC_XSPI1CLKSOURCE_IC3)
+  {
+    rcc.ICSelection[RCC_IC3].ClockSelection = clock->pll;
+    rcc.ICSelection[RCC_IC3].ClockDivider = clock->divider;
+  }
+  if (HAL_RCCEx_PeriphCLKConfig(&rcc) != HAL_OK)
+  {
+    return PSRAM_TUNE_ERROR_BSP;
+  }
+
+  if (BSP_XSPI_RAM_Init(PSRAM_TUNE_RAM_INSTANCE) != BSP_ERROR_NONE ||
+      BSP_XSPI_RAM_EnableMemoryMappedMode(PSRAM_TUNE_RAM_INSTANCE) != BSP_ERROR_NONE)
+  {
+    return PSRAM_TUNE_ERROR_BSP;
+  }
+  psram_tune_clock = clock->hz;
+
+  return PSRAM_TUNE_ERROR_NONE;
+}
+
+static int PSRAM_TUNE_find_clock(uint32_t hz)
+{
+  uint32_t i;
+
+  for (i = 0; i < PSRAM_TUNE_CLOCK_NB; i++)
+  {
+    if (psram_tune_clocks[i].hz == hz)
+    {
+      return (int) i;
+    }
+  }
+
+  return -1;
+}
+
+/* Address dependent pattern then its complement, through the D-cache */
+static int32_t PSRAM_TUNE_check(uint32_t addr, uint32_t size)
+{
+  volatile uint32_t *p = (volatile uint32_t *) addr;
+  uint32_t words = size / 4U;
+  uint32_t pass;
+  uint32_t i;
+
+  for (pass = 0; pass < 2; pass++)
+  {
+    uint32_t flip = pass ? 0xffffffffU : 0;
+
+    for (i = 0; i < words; i++)
+    {
+      p[i] = (addr + i * 4U) ^ (i << 16) ^ flip;
+    }
+    CACHE_CTL_CleanInvalidate((void *) addr, size);
+    for (i = 0; i < words; i++)
+    {
+      if (p[i] != ((addr + i * 4U) ^ (i << 16) ^ flip))
+      {
+        return PSRAM_TUNE_ERROR_PATTERN;
+      }
+    }
+  }
+
+  return PSRAM_TUNE_ERROR_NONE;
+}
+
+/* DMA2D memory to memory copy, restarted until PSRAM_TUNE_load_stop() */
+static int32_t PSRAM_TUNE_load_start(void)
+{
+  DMA2D_HandleTypeDef *hdma2d = &psram_tune_dma2d;
+
+  __HAL_RCC_DMA2D_CLK_ENABLE();
+  hdma2d->Instance = DMA2D;
+  hdma2d->Init.Mode = DMA2D_M2M;
+  hdma2d->Init.ColorMode = DMA2D_OUTPUT_ARGB8888;
+  hdma2d->Init.OutputOffset = 0;
+  hdma2d->LayerCfg[1].InputColorMode = DMA2D_INPUT_ARGB8888;
+  hdma2d->LayerCfg[1].InputOffset = 0;
+  hdma2d->LayerCfg[1].AlphaMode = DMA2D_NO_MODIF_ALPHA;
+  hdma2d->LayerCfg[1].InputAlpha = 0xff;
+  if (HAL_DMA2D_Init(hdma2d) != HAL_OK || HAL_DMA2D_ConfigLayer(hdma2d, 1) != HAL_OK ||
+      HAL_DMA2D_Start(hdma2d, PSRAM_TUNE_DMA_SRC, PSRAM_TUNE_DMA_DST, PSRAM_TUNE_DMA_WIDTH,
+                      PSRAM_TUNE_DMA_HEIGHT) != HAL_OK)
+  {
+    return PSRAM_TUNE_ERROR_BSP;
+  }
+
+  return PSRAM_TUNE_ERROR_NONE;
+}
+
+static void PSRAM_TUNE_load_kick(int dma_load)
+{
+  DMA2D_HandleTypeDef *hdma2d = &psram_tune_dma2d;
+
+  if (dma_load && __HAL_DMA2D_GET_FLAG(hdma2d, DMA2D_FLAG_TC))
+  {
+    /* Same transfer again, registers are kept */
+    __HAL_DMA2D_CLEAR_FLAG(hdma2d, DMA2D_FLAG_TC);
+    __HAL_DMA2D_ENABLE(hdma2d);
+  }
+}
+
+/* Copy complete and correct: the DMA path works at this clock too */
+static int32_t PSRAM_TUNE_load_stop(void)
+{
+  DMA2D_HandleTypeDef *hdma2d = &psram_tune_dma2d;
+  int32_t ret = PSRAM_TUNE_ERROR_NONE;
+
+  if (HAL_DMA2D_PollForTransfer(hdma2d, 100) != HAL_OK)
+  {
+    ret = PSRAM_TUNE_ERROR_PATTERN;
+  }
+  HAL_DMA2D_DeInit(hdma2d);
+
+  CACHE_CTL_Invalidate((void *) PSRAM_TUNE_DMA_SRC, PSRAM_TUNE_WINDOW_SIZE);
+  if (ret == PSRAM_TUNE_ERROR_NONE &&
+      memcmp((void *) PSRAM_TUNE_DMA_SRC, (void *) PSRAM_TUNE_DMA_DST, PSRAM_TUNE_WINDOW_SIZE / 2U) != 0)
+  {
+    ret = PSRAM_TUNE_ERROR_PATTERN;
+  }
+
+  return ret;
+}
+
+static uint32_t PSRAM_TUNE_mbps(uint32_t bytes, uint32_t cycles)
+{
+  return cycles ? (uint32_t)(((uint64_t)bytes * (SystemCoreClock / 1000000U)) / cycles) : 0;
+}
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+  * @brief  Measure PSRAM bandwidth and latency as seen by the CPU
+  * @param  dma_load Keep the DMA2D copying within the PSRAM meanwhile, it
+  *         stands for the display and camera DMA masters
+  * @param  bench Measured values
+  * @retval PSRAM_TUNE_ERROR_NONE or error
+  */
+int32_t PSRAM_TUNE_Bench(int dma_load, PSRAM_TUNE_Bench_t *bench)
+{
+  volatile uint32_t *p = (volatile uint32_t *) PSRAM_TUNE_AREA;
+  uint32_t lines = PSRAM_TUNE_WINDOW_SIZE / PSRAM_TUNE_LINE;
+  uint32_t words = PSRAM_TUNE_CHUNK_SIZE / 4U;
+  uint32_t start, chunk, i, next;
+  uint32_t acc = 0;
+
+  if (dma_load && PSRAM_TUNE_load_start() != PSRAM_TUNE_ERROR_NONE)
+  {
+    return PSRAM_TUNE_ERROR_BSP;
+  }
+
+  /* Sequential */
+  CACHE_CTL_CleanInvalidate((void *) PSRAM_TUNE_AREA, PSRAM_TUNE_WINDOW_SIZE);
+  start = DWT->CYCCNT;
+  for (chunk = 0; chunk < PSRAM_TUNE_WINDOW_SIZE / PSRAM_TUNE_CHUNK_SIZE; chunk++)
+  {
+    for (i = 0; i < words; i++)
+    {
+      acc += p[chunk * words + i];
+    }
+    PSRAM_TUNE_load_kick(dma_load);
+  }
+  bench->seq_read_mbps = PSRAM_TUNE_mbps(PSRAM_TUNE_WINDOW_SIZE, DWT->CYCCNT - start);
+
+  start = DWT->CYCCNT;
+  for (chunk = 0; chunk < PSRAM_TUNE_WINDOW_SIZE / PSRAM_TUNE_CHUNK_SIZE; chunk++)
+  {
+    for (i = 0; i < words; i++)
+    {
+      p[chunk * words + i] = i;
+    }
+    PSRAM_TUNE_load_kick(dma_load);
+  }
+  CACHE_CTL_Clean((void *) PSRAM_TUNE_AREA, PSRAM_TUNE_WINDOW_SIZE);
+  bench->seq_write_mbps = PSRAM_TUNE_mbps(PSRAM_TUNE_WINDOW_SIZE, DWT->CYCCNT - start);
+
+  /* Strided */
+  CACHE_CTL_Invalidate((void *) PSRAM_TUNE_AREA, PSRAM_TUNE_WINDOW_SIZE);
+  start = DWT->CYCCNT;
+  for (i = 0; i < PSRAM_TUNE_WINDOW_SIZE / 4U; i += PSRAM_TUNE_STRIDE / 4U)
+  {
+    acc += p[i];
+  }
+  PSRAM_TUNE_load_kick(dma_load);
+  bench->stride_read_mbps = PSRAM_TUNE_mbps(PSRAM_TUNE_WINDOW_SIZE / PSRAM_TUNE_STRIDE * PSRAM_TUNE_LINE,
+                                            DWT->CYCCNT - start);
+
+  start = DWT->CYCCNT;
+  for (i = 0; i < PSRAM_TUNE_WINDOW_SIZE / 4U; i += PSRAM_TUNE_STRIDE / 4U)
+  {
+    p[i] = i;
+  }
+  CACHE_CTL_Clean((void *) PSRAM_TUNE_AREA, PSRAM_TUNE_WINDOW_SIZE);
+  PSRAM_TUNE_load_kick(dma_load);
+  bench->stride_write_mbps = PSRAM_TUNE_mbps(PSRAM_TUNE_WINDOW_SIZE / PSRAM_TUNE_STRIDE * PSRAM_TUNE_LINE,
+                                             DWT->CYCCNT - start);
+
+  /* Latency: each line holds the index of the next one to visit */
+  for (i = 0; i < lines; i++)
+  {
+    p[i * PSRAM_TUNE_LINE / 4U] = (i * PSRAM_TUNE_CHASE_MUL + PSRAM_TUNE_CHASE_ADD) & (lines - 1U);
+  }
+  CACHE_CTL_CleanInvalidate((void *) PSRAM_TUNE_AREA, PSRAM_TUNE_WINDOW_SIZE);
+  next = 0;
+  start = DWT->CYCCNT;
+  for (i = 0; i < PSRAM_TUNE_CHASE_HOPS; i++)
+  {
+    next = p[next * PSRAM_TUNE_LINE / 4U];
+  }
+  bench->latency_ns = (uint32_t)(((uint64_t)(DWT->CYCCNT - start) * 1000U) /
+                                 PSRAM_TUNE_CHASE_HOPS / (SystemCoreClock / 1000000U));
+  psram_tune_sink = acc + next;
+
+  return dma_load ? PSRAM_TUNE_load_stop() : PSRAM_TUNE_ERROR_NONE;
+}
+
+/**
+  * @brief  Find the fastest stable XSPI1 kernel clock and save it in NOR
+  * @note   Must run before anything is placed in PSRAM. Clocks are tried
+  *         slowest first until one fails the pattern check or the benchmark
+  *         copy; one step below the fastest passing clock is kept as margin.
+  *         Without PSRAM_TUNE_OVERCLOCK only the rated clock is benchmarked
+  *         and no record is kept. The NOR record is only written when the
+  *         clock kept changes.
+  * @param  baseline Results at the SystemClock_Config() clock
+  * @param  best Results at the clock kept
+  * @retval PSRAM_TUNE_ERROR_NONE or error
+  */
+int32_t PSRAM_TUNE_Run(PSRAM_TUNE_Result_t *baseline, PSRAM_TUNE_Result_t *best)
+{
+  PSRAM_TUNE_Result_t results[PSRAM_TUNE_CLOCK_NB];
+  PSRAM_TUNE_Record_t record;
+  uint32_t passed = 0;
+  uint32_t kept;
+  uint32_t i;
+  int32_t ret;
+
+  for (i = 0; i < PSRAM_TUNE_CLOCK_NB; i++)
+  {
+    ret = PSRAM_TUNE_set_clock(i);
+    if (ret == PSRAM_TUNE_ERROR_NONE)
+    {
+      ret = PSRAM_TUNE_check(PSRAM_TUNE_AREA, PSRAM_TUNE_AREA_SIZE);
+    }
+    if (ret == PSRAM_TUNE_ERROR_NONE)
+    {
+      results[i].clock_hz = psram_tune_clocks[i].hz;
+      ret = PSRAM_TUNE_Bench(0, &results[i].idle);
+    }
+    if (ret == PSRAM_TUNE_ERROR_NONE)
+    {
+      ret = PSRAM_TUNE_Bench(1, &results[i].loaded);
+    }
+    PRINTF("PSRAM %lu MHz: %s\n", (unsigned long)(psram_tune_clocks[i].hz / 1000000U),
+           ret == PSRAM_TUNE_ERROR_NONE ? "pass" : "FAIL");
+    if (ret != PSRAM_TUNE_ERROR_NONE)
+    {
+      if (i == 0)
+      {
+        return ret;
+      }
+      break;
+    }
+    TRACE_Record(TRACE_EVT_PSRAM_BENCH, ((psram_tune_clocks[i].hz / 1000000U) << 12) |
+                 (results[i].loaded.seq_read_mbps < PSRAM_TUNE_TRACE_MAX ?
+                  results[i].loaded.seq_read_mbps : PSRAM_TUNE_TRACE_MAX));
+    passed = i;
+  }
+  kept = passed > 0 ? passed - 1 : 0;
+
+  *baseline = results[0];
+  *best = results[kept];
+  PRINTF("PSRAM framebuffer reads under DMA load: %lu MB/s at %lu MHz, %lu MB/s at %lu MHz (%+ld%%)\n",
+         (unsigned long) baseline->loaded.seq_read_mbps, (unsigned long)(baseline->clock_hz / 1000000U),
+         (unsigned long) best->loaded.seq_read_mbps, (unsigned long)(best->clock_hz / 1000000U),
+         (long)(baseline->loaded.seq_read_mbps ?
+                ((int32_t) best->loaded.seq_read_mbps - (int32_t) baseline->loaded.seq_read_mbps) * 100 /
+                (int32_t) baseline->loaded.seq_read_mbps : 0));
+
+  ret = PSRAM_TUNE_set_clock(kept);
+  if (ret != PSRAM_TUNE_ERROR_NONE)
+  {
+    return ret;
+  }
+
+  /* Rated clock: nothing to apply at boot */
+  if (NVM_Read(NVM_SLOT_PSRAM_CLOCK, PSRAM_TUNE_VERSION, &record, sizeof(record)) != NVM_ERROR_NONE)
+  {
+    record.hz = psram_tune_clocks[0].hz;
+  }
+  if (record.hz == psram_tune_clocks[kept].hz)
+  {
+    return PSRAM_TUNE_ERROR_NONE;
+  }
+  if (kept == 0)
+  {
+    return NVM_Erase(NVM_SLOT_PSRAM_CLOCK) == NVM_ERROR_NONE ? PSRAM_TUNE_ERROR_NONE : PSRAM_TUNE_ERROR_BSP;
+  }
+  record.hz = psram_tune_clocks[kept].hz;
+
+  return NVM_Write(NVM_SLOT_PSRAM_CLOCK, PSRAM_TUNE_VERSION, &record, sizeof(record)) == NVM_ERROR_NONE ?
+         PSRAM_TUNE_ERROR_NONE : PSRAM_TUNE_ERROR_BSP;
+}
+
+/**
+  * @brief  Apply the clock saved by PSRAM_TUNE_Run(), before the PSRAM is used
+  * @note   Only in builds with PSRAM_TUNE_OVERCLOCK, others keep the rated
+  *         clock whatever the NOR holds. The whole scratch area is checked
+  *         at the saved clock, a failure drops it and restores the
+  *         SystemClock_Config() one.
+  * @retval PSRAM_TUNE_ERROR_NONE, PSRAM_TUNE_ERROR_EMPTY if nothing to apply
+  */
+int32_t PSRAM_TUNE_Apply(void)
+{
+  PSRAM_TUNE_Record_t record;
+  int index;
+  int32_t ret;
+
+  psram_tune_clock = psram_tune_clocks[0].hz;
+  if (NVM_Read(NVM_SLOT_PSRAM_CLOCK, PSRAM_TUNE_VERSION, &record, sizeof(record)) != NVM_ERROR_NONE)
+  {
+    return PSRAM_TUNE_ERROR_EMPTY;
+  }
+  index = PSRAM_TUNE_find_clock(record.hz);
+  if (index <= 0)
+  {
+    return PSRAM_TUNE_ERROR_EMPTY;
+  }
+
+  ret = PSRAM_TUNE_set_clock((uint32_t) index);
+  if (ret == PSRAM_TUNE_ERROR_NONE)
+  {
+    ret = PSRAM_TUNE_check(PSRAM_TUNE_AREA, PSRAM_TUNE_AREA_SIZE);
+  }
+  if (ret != PSRAM_TUNE_ERROR_NONE)
+  {
+    PRINTF("PSRAM %lu MHz failed, back to default\n", (unsigned long)(record.hz / 1000000U));
+    NVM_Erase(NVM_SLOT_PSRAM_CLOCK);
+    PSRAM_TUNE_set_clock(0);
+  }
+
+  return ret;
+}
+
+uint32_t PSRAM_TUNE_GetClock(void)
+{
+  return psram_tune_clock;
+}
@@ -0,0 +1,338 @@
+ /**
+ ******************************************************************************
+ * @file    scanline.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "scanline.h"
+#include "trace.h"
+#include <assert.h>
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  int used;
+  int periodic;
+  uint32_t target;       /*!< LTDC line counter value (CPSR.CYPOS) */
+  uint32_t budget;
+  SCANLINE_Callback_t cb;
+  void *arg;
+  SCANLINE_Stats_t stats;
+} SCANLINE_Job_t;
+
+/* Private variables ---------------------------------------------------------*/
+static LTDC_HandleTypeDef *scanline_hltdc;
+static uint32_t scanline_total;
+static uint32_t scanline_first_active;
+static SCANLINE_Job_t scanline_jobs[SCANLINE_MAX_JOBS];
+static uint8_t scanline_order[SCANLINE_MAX_JOBS];
+static uint32_t scanline_nb_ordered;
+static uint32_t scanline_next;
+static volatile uint32_t scanline_misses;
+
+/* Private functions ---------------------------------------------------------*/
+static uint32_t SCANLINE_read_counter(void)
+{
+  return (scanline_hltdc->Instance->CPSR & LTDC_CPSR_CYPOS) >> LTDC_CPSR_CYPOS_Pos;
+}
+
+static uint32_t SCANLINE_distance(uint32_t from, uint32_t to)
+{
+  return (to + scanline_total - from) % scanline_total;
+}
+
+/* Called from the LTDC interrupt: avoid HAL_LTDC_ProgramLineEvent() which
+ * takes the handle lock possibly owned by the interrupted thread */
+static void SCANLINE_program(uint32_t counter)
+{
+  __HAL_LTDC_DISABLE_IT(scanline_hltdc, LTDC_IT_LI);
+  scanline_hltdc->Instance->LIPCR = counter;
+  __HAL_LTDC_ENABLE_IT(scanline_hltdc, LTDC_IT_LI);
+}
+
+static void SCANLINE_rebuild(void)
+{
+  uint32_t cur = SCANLINE_read_counter();
+  uint32_t i, j;
+
+  scanline_nb_ordered = 0;
+  for (i = 0; i < SCANLINE_MAX_JOBS; i++)
+  {
+    if (!scanline_jobs[i].used)
+    {
+      continue;
+    }
+    /* Insertion sort on target line, table is tiny */
+    for (j = scanline_nb_ordered; j > 0; j--)
+    {
+      if (scanline_jobs[scanline_order[j - 1]].target <= scanline_jobs[i].target)
+      {
+        break;
+      }
+      scanline_order[j] = scanline_order[j - 1];
+    }
+    scanline_order[j] = i;
+    scanline_nb_ordered++;
+  }
+
+  if (scanline_nb_ordered == 0)
+  {
+    __HAL_LTDC_DISABLE_IT(scanline_hltdc, LTDC_IT_LI);
+    return;
+  }
+
+  /* Resume with the first job still ahead of the beam in this frame */
+  for (scanline_next = 0; scanline_next < scanline_nb_ordered; scanline_next++)
+  {
+    if (scanline_jobs[scanline_order[scanline_next]].target > cur)
+    {
+      break;
+    }
+  }
+  if (scanline_next == scanline_nb_ordered)
+  {
+    scanline_next = 0;
+  }
+  SCANLINE_program(scanline_jobs[scanline_order[scanline_next]].target);
+}
+
+static int SCANLINE_run(SCANLINE_Job_t *job)
+{
+  uint32_t start = SCANLINE_read_counter();
+  uint32_t late = SCANLINE_distance(job->target, start);
+  uint32_t duration;
+
+  job->cb(job->arg);
+
+  duration = SCANLINE_distance(start, SCANLINE_read_counter());
+  job->stats.runs++;
+  if (duration > job->stats.max_lines)
+  {
+    job->stats.max_lines = duration;
+  }
+  if (job->budget)
+  {
+    if (late > job->budget)
+    {
+      job->stats.late_starts++;
+    }
+    if (late + duration > job->budget)
+    {
+      job->stats.misses++;
+      scanline_misses++;
+    }
+  }
+
+  if (!job->periodic)
+  {
+    job->used = 0;
+    return 1;
+  }
+
+  return 0;
+}
+
+static void SCANLINE_lock(void)
+{
+  HAL_NVIC_DisableIRQ(LTDC_LO_IRQn);
+}
+
+static void SCANLINE_unlock(void)
+{
+  HAL_NVIC_EnableIRQ(LTDC_LO_IRQn);
+}
+
+/* Functions Definition ------------------------------------------------------*/
+/**
+  * @brief  Initialize the scanline scheduler from the current LTDC timings
+  * @param  hltdc LTDC handle already initialized
+  * @retval SCANLINE_ERROR_NONE
+  */
+int32_t SCANLINE_Init(LTDC_HandleTypeDef *hltdc)
+{
+  uint32_t i;
+
+  scanline_hltdc = hltdc;
+  scanline_total = hltdc->Init.TotalHeigh + 1;
+  scanline_first_active = hltdc->Init.AccumulatedVBP + 1;
+  scanline_nb_ordered = 0;
+  scanline_next = 0;
+  scanline_misses = 0;
+  for (i = 0; i < SCANLINE_MAX_JOBS; i++)
+  {
+    scanline_jobs[i].used = 0;
+  }
+
+  HAL_NVIC_SetPriority(LTDC_LO_IRQn, 5, 0);
+  HAL_NVIC_EnableIRQ(LTDC_LO_IRQn);
+
+  return SCANLINE_ERROR_NONE;
+}
+
+/**
+  * @brief  Schedule a callback at a given scanline
+  * @param  line Active area line (see scanline.h for blanking lines)
+  * @param  budget_lines Lines allowed between line and callback completion,
+  *         0 disables deadline accounting
+  * @param  periodic Run every frame if non zero, once otherwise
+  * @param  cb Callback, executed in LTDC interrupt context
+  * @param  arg Callback argument
+  * @retval Job handle (>= 0) or negative error
+  */
+int32_t SCANLINE_Add(uint32_t line, uint32_t budget_lines, int periodic, SCANLINE_Callback_t cb, void *arg)
+{
+  int32_t i;
+
+  assert(scanline_hltdc != NULL);
+  if (cb == NULL || line >= scanline_total)
+  {
+    return SCANLINE_ERROR_PARAM;
+  }
+
+  SCANLINE_lock();
+  for (i = 0; i < SCANLINE_MAX_JOBS; i++)
+  {
+    if (!scanline_jobs[i].used)
+    {
+      break;
+    }
+  }
+  if (i == SCANLINE_MAX_JOBS)
+  {
+    SCANLINE_unlock();
+    return SCANLINE_ERROR_FULL;
+  }
+
+  scanline_jobs[i].used = 1;
+  scanline_jobs[i].periodic = periodic;
+  scanline_jobs[i].target = (scanline_first_active + line) % scanline_total;
+  scanline_jobs[i].budget = budget_lines;
+  scanline_jobs[i].cb = cb;
+  scanline_jobs[i].arg = arg;
+  scanline_jobs[i].stats = (SCANLINE_Stats_t) {0};
+  SCANLINE_rebuild();
+  SCANLINE_unlock();
+
+  return i;
+}
+
+int32_t SCANLINE_Remove(int32_t job)
+{
+  if (job < 0 || job >= SCANLINE_MAX_JOBS)
+  {
+    return SCANLINE_ERROR_PARAM;
+  }
+
+  SCANLINE_lock();
+  scanline_jobs[job].used = 0;
+  SCANLINE_rebuild();
+  SCANLINE_unlock();
+
+  return SCANLINE_ERROR_NONE;
+}
+
+int32_t SCANLINE_GetStats(int32_t job, SCANLINE_Stats_t *stats)
+{
+  if (job < 0 || job >= SCANLINE_MAX_JOBS)
+  {
+    return SCANLINE_ERROR_PARAM;
+  }
+
+  SCANLINE_lock();
+  *stats = scanline_jobs[job].stats;
+  SCANLINE_unlock();
+
+  return SCANLINE_ERROR_NONE;
+}
+
+/**
+  * @brief  Total number of deadline misses since init, all jobs included
+  */
+uint32_t SCANLINE_GetMisses(void)
+{
+  return scanline_misses;
+}
+
+/**
+  * @brief  Current beam position, in active area line coordinates
+  */
+uint32_t SCANLINE_GetCurrentLine(void)
+{
+  return SCANLINE_distance(scanline_first_active, SCANLINE_read_counter());
+}
+
+uint32_t SCANLINE_GetTotalLines(void)
+{
+  return scanline_total;
+}
+
+/**
+  * @brief  Display refresh rate from the LTDC timings and pixel clock
+  * @retval Refresh rate in mHz
+  */
+uint32_t SCANLINE_GetRefreshMilliHz(void)
+{
+  uint64_t pclk = HAL_RCCEx_GetPeriphCLKFreq(RCC_PERIPHCLK_LTDC);
+  uint32_t total_pixels = (scanline_hltdc->Init.TotalWidth + 1) * scanline_total;
+
+  return (uint32_t)((pclk * 1000U) / total_pixels);
+}
+
+/**
+  * @brief  Line Event callback: run every job due at or before the beam
+  * @param  hltdc LTDC handle
+  * @retval None
+  */
+void HAL_LTDC_LineEventCallback(LTDC_HandleTypeDef *hltdc)
+{
+  int removed = 0;
+  uint32_t cur;
+
+  UNUSED(hltdc);
+
+  TRACE_Record(TRACE_EVT_LTDC_LINE, SCANLINE_read_counter());
+
+  if (scanline_nb_ordered == 0)
+  {
+    return;
+  }
+
+  /* The programmed job always runs, even if the interrupt was serviced after
+   * the counter wrapped: it is then accounted as a late start */
+  removed |= SCANLINE_run(&scanline_jobs[scanline_order[scanline_next]]);
+  scanline_next++;
+
+  cur = SCANLINE_read_counter();
+  while (scanline_next < scanline_nb_ordered &&
+         scanline_jobs[scanline_order[scanline_next]].target <= cur)
+  {
+    removed |= SCANLINE_run(&scanline_jobs[scanline_order[scanline_next]]);
+    scanline_next++;
+    cur = SCANLINE_read_counter();
+  }
+
+  if (removed)
+  {
+    SCANLINE_rebuild();
+    return;
+  }
+
+  if (scanline_next == scanline_nb_ordered)
+  {
+    scanline_next = 0;
+  }
+  SCANLINE_program(scanline_jobs[scanline_order[scanline_next]].target);
+}
@@ -21,6 +21,13 @@
 #include "stm32n6xx_it.h"
 
 #include "cmw_camera.h"
+#include "stm32n6570_discovery.h"
+#include "stm32n6570_discovery_bus.h"
+#include "stm32n6570_discovery_lcd.h"
+#include "trace.h"
+#include "perf_mon.h"
+#include "tcm.h"
+#include "cam_recovery.h"
 
 /**
   * @brief   This function handles NMI exception.
@@ -134,25 +141,100 @@ void PendSV_Handler(void)
   * @param  None
   * @retval None
   */
-void SysTick_Handler(void)
+TCM_CODE void SysTick_Handler(void)
 {
   HAL_IncTick();
 }
 
 /******************************************************************************/
 /*                 STM32N6xx Peripherals Interrupt Handlers                   */
+/*  Camera and display handlers run from ITCM (tcm.h): their latency sets the */
+/*  pipeline jitter.                                                          */
 /*  Add here the Interrupt Handler for the used peripheral(s) (PPP), for the  */
 /*  available peripheral interrupt handler's name please refer to the startup */
 /*  file (startup_stm32n6xx.s).                                               */
 /******************************************************************************/
-void CSI_IRQHandler(void)
+TCM_CODE void CSI_IRQHandler(void)
 {
   DCMIPP_HandleTypeDef *hcamera_dcmipp = CMW_CAMERA_GetDCMIPPHandle();
+  uint32_t errors = CSI->SR1 & CSI->IER1;
+
+  if (errors)
+  {
+    TRACE_Record(TRACE_EVT_CSI_ERROR, errors);
+    /* Counted and cleared here, the application decides on a restart */
+    CAM_RECOVERY_OnCsiErrors(errors);
+    CSI->FCR1 = errors;
+  }
   HAL_DCMIPP_CSI_IRQHandler(hcamera_dcmipp);
 }
 
-void DCMIPP_IRQHandler(void)
+TCM_CODE void DCMIPP_IRQHandler(void)
 {
   DCMIPP_HandleTypeDef *hcamera_dcmipp = CMW_CAMERA_GetDCMIPPHandle();
+  uint32_t errors = DCMIPP->CMSR2 & DCMIPP->CMIER & CAM_RECOVERY_DCMIPP_ERRORS;
+
+  PERF_MON_Begin(PERF_MON_REGION_ISR_DCMIPP);
+  if (errors)
+  {
+    /* Overruns lose a frame, the capture goes on: never reach the HAL error path */
+    CAM_RECOVERY_OnDcmippErrors(errors);
+    DCMIPP->CMFCR = errors;
+  }
   HAL_DCMIPP_IRQHandler(hcamera_dcmipp);
-}
\ No newline at end of file
+  PERF_MON_End(PERF_MON_REGION_ISR_DCMIPP);
+}
+
+TCM_CODE void LTDC_LO_IRQHandler(void)
+{
+  PERF_MON_Begin(PERF_MON_REGION_ISR_LTDC);
+  HAL_LTDC_IRQHandler(&hlcd_ltdc);
+  PERF_MON_End(PERF_MON_REGION_ISR_LTDC);
+}
+
+TCM_CODE void LTDC_LO_ERR_IRQHandler(void)
+{
+  HAL_LTDC_IRQHandler(&hlcd_ltdc);
+}
+
+void EXTI13_IRQHandler(void)
+{
+  BSP_PB_IRQHandler(BUTTON_USER1);
+}
+
+/* ISP tuning tool link (isp_tool_uart.c) */
+void USART1_IRQHandler(void)
+{
+  HAL_UART_IRQHandler(&hcom_uart[COM1]);
+}
+
+void GPDMA1_Channel0_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(hcom_uart[COM1].hdmatx);
+}
+
+void GPDMA1_Channel1_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(hcom_uart[COM1].hdmarx);
+}
+
+/* HDMI transmitter I2C (hdmi_i2c.c) */
+void I2C2_EV_IRQHandler(void)
+{
+  HAL_I2C_EV_IRQHandler(&hbus_i2c2);
+}
+
+void I2C2_ER_IRQHandler(void)
+{
+  HAL_I2C_ER_IRQHandler(&hbus_i2c2);
+}
+
+void GPDMA1_Channel2_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(hbus_i2c2.hdmatx);
+}
+
+void GPDMA1_Channel3_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(hbus_i2c2.hdmarx);
+}
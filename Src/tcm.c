@@ -0,0 +1,140 @@
+ /**
+ ******************************************************************************
+ * @file    tcm.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "tcm.h"
+#include "trace.h"
+#include "cache_ctl.h"
+#include "stm32n6xx_hal.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(DEBUG)
+#define PRINTF(...)    printf(__VA_ARGS__)
+#else
+#define PRINTF(...)
+#endif /* defined(DEBUG) */
+
+/* Private define ------------------------------------------------------------*/
+#define TCM_TRACE_MAX          0x7ffU
+#define TCM_PLACEMENT_ITCM     0U
+#define TCM_PLACEMENT_AXISRAM  1U
+
+/* Private variables ---------------------------------------------------------*/
+#if !defined(__ICCARM__)
+/* IAR copies the ITCM code at startup (initialize by copy) */
+extern uint32_t _siitcm;
+extern uint32_t _sitcm;
+extern uint32_t _eitcm;
+#endif
+
+static volatile uint32_t tcm_entry;
+
+/* Private functions ---------------------------------------------------------*/
+/* Same handler in both memories, only the code fetch differs */
+TCM_CODE static void TCM_handler_itcm(void)
+{
+  tcm_entry = DWT->CYCCNT;
+}
+
+__attribute__ ((noinline)) static void TCM_handler_axisram(void)
+{
+  tcm_entry = DWT->CYCCNT;
+}
+
+static void TCM_set_pendsv(uint32_t handler)
+{
+  volatile uint32_t *vector = &((volatile uint32_t *) SCB->VTOR)[NVIC_USER_IRQ_OFFSET + PendSV_IRQn];
+
+  *vector = handler;
+  /* Vector table is in cacheable AXISRAM */
+  CACHE_CTL_Clean((const void *) vector, sizeof(*vector));
+  __DSB();
+}
+
+/* Cycles from the PendSV request to the first handler instruction, with a cold
+ * I-cache as after an ISP run. Other interrupts keep running: the maximum
+ * includes the time they delay PendSV. */
+static void TCM_measure(void (*handler)(void), TCM_Latency_t *latency)
+{
+  uint64_t total = 0;
+  uint32_t cycles;
+  uint32_t start;
+  uint32_t i;
+
+  TCM_set_pendsv((uint32_t) handler);
+  latency->min_cycles = UINT32_MAX;
+  latency->max_cycles = 0;
+  for (i = 0; i < TCM_LATENCY_RUNS; i++)
+  {
+    SCB_InvalidateICache();
+    start = DWT->CYCCNT;
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+    __DSB();
+    __ISB();
+    cycles = tcm_entry - start;
+    total += cycles;
+    latency->min_cycles = cycles < latency->min_cycles ? cycles : latency->min_cycles;
+    latency->max_cycles = cycles > latency->max_cycles ? cycles : latency->max_cycles;
+  }
+  latency->avg_cycles = (uint32_t)(total / TCM_LATENCY_RUNS);
+}
+
+static void TCM_trace(uint32_t placement, const TCM_Latency_t *latency)
+{
+  uint32_t max = latency->max_cycles < TCM_TRACE_MAX ? latency->max_cycles : TCM_TRACE_MAX;
+  uint32_t avg = latency->avg_cycles < TCM_TRACE_MAX ? latency->avg_cycles : TCM_TRACE_MAX;
+
+  TRACE_Record(TRACE_EVT_IRQ_LATENCY, (placement << 22) | (max << 11) | avg);
+}
+
+/* Functions Definition ------------------------------------------------------*/
+void TCM_Init(void)
+{
+#if !defined(__ICCARM__)
+  memcpy(&_sitcm, &_siitcm, (uint32_t) &_eitcm - (uint32_t) &_sitcm);
+  __DSB();
+  __ISB();
+#endif
+}
+
+/**
+  * @brief  Measure the interrupt latency with the handler in ITCM, then in
+  *         AXISRAM, and report both in the trace
+  * @note   Run with the camera and display started: their DMA traffic is the
+  *         load the ITCM placement protects the interrupts from. PendSV is
+  *         borrowed meanwhile, it is not used by the application.
+  * @param  itcm Handler in ITCM
+  * @param  axisram Same handler in AXISRAM1
+  * @retval None
+  */
+void TCM_MeasureLatency(TCM_Latency_t *itcm, TCM_Latency_t *axisram)
+{
+  uint32_t vector = NVIC_GetVector(PendSV_IRQn);
+
+  TCM_measure(TCM_handler_itcm, itcm);
+  TCM_measure(TCM_handler_axisram, axisram);
+  TCM_set_pendsv(vector);
+
+  TCM_trace(TCM_PLACEMENT_ITCM, itcm);
+  TCM_trace(TCM_PLACEMENT_AXISRAM, axisram);
+  PRINTF("IRQ latency ITCM %lu/%lu/%lu AXISRAM %lu/%lu/%lu cycles (min/avg/max)\n",
+         (unsigned long) itcm->min_cycles, (unsigned long) itcm->avg_cycles, (unsigned long) itcm->max_cycles,
+         (unsigned long) axisram->min_cycles, (unsigned long) axisram->avg_cycles,
+         (unsigned long) axisram->max_cycles);
+}
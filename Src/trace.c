@@ -0,0 +1,189 @@
+ /**
+ ******************************************************************************
+ * @file    trace.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "trace.h"
+#include "stm32n6xx_hal.h"
+#if TRACE_SINK == TRACE_SINK_UART
+#include "isp_tool_uart.h"
+#endif
+#include <stddef.h>
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint32_t magic;
+  uint16_t count;
+  uint16_t lost;
+  uint32_t first;
+  TRACE_Record_t records[TRACE_PACKET_MAX];
+} TRACE_Packet_t;
+
+/* Private variables ---------------------------------------------------------*/
+static TRACE_Record_t trace_ring[TRACE_RECORD_NB];
+static volatile uint32_t trace_head;
+static uint32_t trace_tail;
+static uint32_t trace_lost_pending;
+static TRACE_Stats_t trace_stats;
+static TRACE_Packet_t trace_packet;
+
+/* Private functions ---------------------------------------------------------*/
+#if TRACE_SINK == TRACE_SINK_SWO
+/* Waits for the ITM FIFO, never for a host: disabled port fails at once */
+static int TRACE_sink_send(const void *data, uint32_t size)
+{
+  const uint32_t *word = data;
+  uint32_t i;
+
+  if ((ITM->TCR & ITM_TCR_ITMENA_Msk) == 0 || (ITM->TER & (1UL << TRACE_ITM_PORT)) == 0)
+  {
+    return -1;
+  }
+
+  for (i = 0; i < size / 4; i++)
+  {
+    while (ITM->PORT[TRACE_ITM_PORT].u32 == 0)
+    {
+      __NOP();
+    }
+    ITM->PORT[TRACE_ITM_PORT].u32 = word[i];
+  }
+
+  return 0;
+}
+#elif TRACE_SINK == TRACE_SINK_UART
+static int TRACE_sink_send(const void *data, uint32_t size)
+{
+  return ISP_TOOL_UART_Send(data, size) == ISP_TOOL_UART_ERROR_NONE ? 0 : -1;
+}
+#else
+static int TRACE_sink_send(const void *data, uint32_t size)
+{
+  (void) data;
+  (void) size;
+
+  return -1;
+}
+#endif
+
+/* Forget records overwritten by producers, up to the given head */
+static void TRACE_skip_lost(uint32_t head)
+{
+  if (head - trace_tail > TRACE_RECORD_NB)
+  {
+    trace_lost_pending += head - TRACE_RECORD_NB - trace_tail;
+    trace_stats.lost += head - TRACE_RECORD_NB - trace_tail;
+    trace_tail = head - TRACE_RECORD_NB;
+  }
+}
+
+/* Functions Definition ------------------------------------------------------*/
+void TRACE_Init(void)
+{
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  trace_head = 0;
+  trace_tail = 0;
+  trace_lost_pending = 0;
+  trace_stats = (TRACE_Stats_t) {0};
+}
+
+/**
+  * @brief  Record an event with the current cycle count
+  * @param  event TRACE_EVT_xxx
+  * @param  arg Event argument, 24 least significant bits are kept
+  * @retval None
+  */
+void TRACE_Record(uint32_t event, uint32_t arg)
+{
+  uint32_t timestamp = DWT->CYCCNT;
+  uint32_t index;
+
+  /* Reserve a slot: an interrupt recording in between retries the reservation */
+  do {
+    index = __LDREXW(&trace_head);
+  } while (__STREXW(index + 1, &trace_head) != 0);
+
+  trace_ring[index % TRACE_RECORD_NB].timestamp = timestamp;
+  trace_ring[index % TRACE_RECORD_NB].event = (event << 24) | (arg & 0xffffffU);
+}
+
+/**
+  * @brief  Send pending records to the sink, from the application loop only
+  * @param  max_records Upper bound of records sent by this call
+  * @retval Number of records sent
+  */
+uint32_t TRACE_Drain(uint32_t max_records)
+{
+  uint32_t drained = 0;
+  uint32_t head;
+  uint32_t count;
+  uint32_t i;
+
+  if (TRACE_SINK == TRACE_SINK_NONE)
+  {
+    return 0;
+  }
+
+  head = trace_head;
+  __DMB();
+  while (drained < max_records && trace_tail != head)
+  {
+    TRACE_skip_lost(head);
+
+    count = head - trace_tail;
+    count = count < TRACE_PACKET_MAX ? count : TRACE_PACKET_MAX;
+    count = count < max_records - drained ? count : max_records - drained;
+    for (i = 0; i < count; i++)
+    {
+      trace_packet.records[i] = trace_ring[(trace_tail + i) % TRACE_RECORD_NB];
+    }
+
+    /* Producers may have wrapped over the records while they were copied */
+    head = trace_head;
+    __DMB();
+    if (head - trace_tail > TRACE_RECORD_NB)
+    {
+      continue;
+    }
+
+    trace_packet.magic = TRACE_PACKET_MAGIC;
+    trace_packet.count = count;
+    trace_packet.lost = trace_lost_pending < 0xffffU ? trace_lost_pending : 0xffffU;
+    trace_packet.first = trace_tail;
+    if (TRACE_sink_send(&trace_packet, offsetof(TRACE_Packet_t, records) + count * sizeof(TRACE_Record_t)) != 0)
+    {
+      /* Sink not ready: records stay in the ring, oldest are overwritten */
+      break;
+    }
+
+    trace_lost_pending = 0;
+    trace_tail += count;
+    trace_stats.drained += count;
+    drained += count;
+  }
+
+  return drained;
+}
+
+void TRACE_GetStats(TRACE_Stats_t *stats)
+{
+  *stats = trace_stats;
+  stats->recorded = trace_head;
+}
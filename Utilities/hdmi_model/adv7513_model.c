@@ -0,0 +1,554 @@
+ /**
+ ******************************************************************************
+ * @file    adv7513_model.c
+ * @author  GPM Application Team
+ * @brief   Host model of the ADV7513 HDMI transmitter I2C register file.
+ *          Main map at 0x7a, EDID memory at 0x7e. Models the chip revision,
+ *          HPD and monitor sense, power-down, TMDS PLL lock and EDID read
+ *          delays, read-only and write-1-to-clear bits, and the I2C2 DMA
+ *          transfers: bus time at the SCL frequency set in TIMINGR,
+ *          completion callbacks once that time has elapsed.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include <string.h>
+
+#include "stm32n6xx_hal.h"
+#include "stm32n6570_discovery_bus.h"
+#include "cache_ctl.h"
+#include "cpu_load.h"
+#include "nvm.h"
+#include "trace.h"
+#include "adv7513_model.h"
+
+#define ADV7513_I2C_ADDR       0x7a
+#define ADV7513_EDID_I2C_ADDR  0x7e
+#define ADV7513_REVISION       0x13
+
+/* Power-up to TMDS PLL lock, and to EDID read over DDC (128 bytes at 100 kHz) */
+#define MODEL_PLL_LOCK_NS      (2ULL * 1000000ULL)
+#define MODEL_EDID_READ_NS     (15ULL * 1000000ULL)
+
+/* SCL clocks per transfer: START, address, register, STOP; reads add a
+ * repeated START and address. 9 clocks per byte with its ACK */
+#define MODEL_WRITE_CLOCKS(n)  (1 + 9 + 9 + 9 * (n) + 1)
+#define MODEL_READ_CLOCKS(n)   (1 + 9 + 9 + 1 + 9 + 9 * (n) + 1)
+/* Address NACKed: START, address, STOP */
+#define MODEL_NACK_CLOCKS      (1 + 9 + 1)
+
+/* I2C kernel clock */
+#define MODEL_I2C_CLOCK_HZ     64000000U
+
+DWT_Type host_dwt;
+uint32_t SystemCoreClock = 800000000U;
+I2C_HandleTypeDef hbus_i2c2;
+static DMA_Channel_TypeDef channel2, channel3;
+DMA_Channel_TypeDef *GPDMA1_Channel2 = &channel2;
+DMA_Channel_TypeDef *GPDMA1_Channel3 = &channel3;
+
+/* DMA transfer on the bus, completed once the model time reaches end_ns */
+typedef struct
+{
+  int active;
+  int read;
+  int ok;
+  uint16_t dev;
+  uint8_t reg;
+  uint8_t *data;
+  uint16_t size;
+  uint64_t end_ns;
+} Model_Transfer_t;
+
+static uint8_t model_regs[256];
+static uint8_t model_edid[256];
+/* Bits software cannot change, bits cleared by writing 1 */
+static uint8_t model_ro[256];
+static uint8_t model_w1c[256];
+
+static uint64_t model_now_ns;
+/* Fastest SCL the board (pull-ups, wiring) allows */
+static uint32_t model_max_hz = 400000;
+static uint32_t model_scl_hz = 100000;
+static int model_bus_init;
+static Model_Transfer_t model_xfer;
+static int model_present = 1;
+static int model_hpd = 1;
+static int model_sense = 1;
+/* Next write starting at this register NACKed, -1 if none */
+static int model_nack_reg = -1;
+/* Monitor EDID with the HDMI VSDB, DVI monitor with a CEA extension if not */
+static int model_hdmi_sink = 1;
+/* RGB quantization range selectable (VCDB QS bit) */
+static int model_qs = 1;
+/* Powered up (HPD high and power-down cleared) since this time */
+static int model_powered;
+static uint64_t model_powered_ns;
+static int model_edid_done;
+static ADV7513_MODEL_Stats_t model_stats;
+
+static void model_set_time(uint64_t ns)
+{
+  model_now_ns = ns;
+  host_dwt.CYCCNT = (uint32_t)(ns * (SystemCoreClock / 1000000U) / 1000U);
+}
+
+static void model_build_edid(void)
+{
+  static const uint8_t header[8] = { 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00 };
+  uint8_t sum = 0;
+  int i;
+  int d;
+
+  memset(model_edid, 0, sizeof(model_edid));
+  memcpy(model_edid, header, sizeof(header));
+  /* Manufacturer "STM", product 0x6570, EDID 1.3, one CEA-861 extension */
+  model_edid[8] = 0x4e;
+  model_edid[9] = 0x8d;
+  model_edid[10] = 0x70;
+  model_edid[11] = 0x65;
+  model_edid[18] = 1;
+  model_edid[19] = 3;
+  model_edid[126] = 1;
+  for (i = 0; i < 127; i++)
+  {
+    sum += model_edid[i];
+  }
+  model_edid[127] = (uint8_t)(0x100 - sum);
+  /* Extension block: CEA tag, revision 3, data blocks from byte 4 */
+  model_edid[128] = 0x02;
+  model_edid[129] = 0x03;
+  /* Video data block: VIC 14 and 29 */
+  model_edid[132] = (2 << 5) | 2;
+  model_edid[133] = 14;
+  model_edid[134] = 29;
+  d = 135;
+  if (model_hdmi_sink)
+  {
+    /* HDMI VSDB: IEEE OUI 0x000c03, physical address 1.0.0.0 */
+    model_edid[d++] = (3 << 5) | 5;
+    model_edid[d++] = 0x03;
+    model_edid[d++] = 0x0c;
+    model_edid[d++] = 0x00;
+    model_edid[d++] = 0x10;
+    model_edid[d++] = 0x00;
+  }
+  /* Video capability data block: extended tag 0, QS bit 6 */
+  model_edid[d++] = (7 << 5) | 2;
+  model_edid[d++] = 0x00;
+  model_edid[d++] = model_qs ? (1 << 6) : 0;
+  /* Detailed timing descriptors (none) after the data blocks */
+  model_edid[130] = (uint8_t)(d - 128);
+  sum = 0;
+  for (i = 128; i < 255; i++)
+  {
+    sum += model_edid[i];
+  }
+  model_edid[255] = (uint8_t)(0x100 - sum);
+}
+
+/* Hardware state at the current time: power, PLL, EDID ready interrupt */
+static void model_update(void)
+{
+  int powered = model_present && model_hpd && (model_regs[0x41] & (1 << 6)) == 0;
+
+  if (powered && !model_powered)
+  {
+    model_powered_ns = model_now_ns;
+    model_edid_done = 0;
+  }
+  model_powered = powered;
+
+  model_regs[0x42] = (model_hpd ? 1 << 6 : 0) | (model_hpd && model_sense ? 1 << 5 : 0);
+  if (powered && model_now_ns - model_powered_ns >= MODEL_PLL_LOCK_NS)
+  {
+    model_regs[0x9e] |= 1 << 4;
+  }
+  else
+  {
+    model_regs[0x9e] &= ~(1 << 4);
+  }
+  if (powered && !model_edid_done && model_now_ns - model_powered_ns >= MODEL_EDID_READ_NS)
+  {
+    model_edid_done = 1;
+    if (model_regs[0x94] & (1 << 2))
+    {
+      model_regs[0x96] |= 1 << 2;
+    }
+  }
+}
+
+static void model_defaults(void)
+{
+  memset(model_regs, 0, sizeof(model_regs));
+  memset(model_ro, 0, sizeof(model_ro));
+  memset(model_w1c, 0, sizeof(model_w1c));
+
+  model_regs[0x00] = ADV7513_REVISION;
+  /* Powered down out of reset */
+  model_regs[0x41] = 1 << 6;
+  model_ro[0x00] = 0xff;
+  model_ro[0x42] = 0xff;
+  model_ro[0x9e] = 1 << 4;
+  /* Detected VIC, VIC sent to the monitor */
+  model_ro[0x3d] = 0xff;
+  model_ro[0x3e] = 0xff;
+  /* Interrupt status */
+  model_w1c[0x96] = 0xff;
+  model_w1c[0x97] = 0xff;
+  model_powered = 0;
+  model_edid_done = 0;
+}
+
+/* SCL frequency programmed in TIMINGR: PRESC, SCLH and SCLL */
+static uint32_t model_scl(uint32_t timing)
+{
+  uint32_t presc = (timing >> 28) + 1;
+  uint32_t ticks = ((timing >> 8) & 0xff) + 1 + (timing & 0xff) + 1;
+
+  return MODEL_I2C_CLOCK_HZ / (presc * ticks);
+}
+
+static void model_read(uint16_t dev, uint8_t reg, uint8_t *data, uint16_t size)
+{
+  const uint8_t *map = dev == ADV7513_EDID_I2C_ADDR ? model_edid : model_regs;
+  uint16_t i;
+
+  model_update();
+  for (i = 0; i < size; i++)
+  {
+    data[i] = map[(reg + i) & 0xff];
+  }
+}
+
+static void model_write(uint8_t reg, const uint8_t *data, uint16_t size)
+{
+  uint16_t i;
+  uint8_t r;
+  uint8_t keep;
+
+  model_update();
+  for (i = 0; i < size; i++)
+  {
+    r = (uint8_t)(reg + i);
+    keep = model_ro[r] | model_w1c[r];
+    if ((data[i] ^ model_regs[r]) & model_ro[r])
+    {
+      model_stats.ro_writes++;
+    }
+    model_regs[r] = (model_regs[r] & keep) | (data[i] & ~keep);
+    model_regs[r] &= ~(data[i] & model_w1c[r]);
+  }
+  model_update();
+}
+
+/* Transfer start: bus time, NACK if nobody answers at this speed */
+static HAL_StatusTypeDef model_start(I2C_HandleTypeDef *hi2c, int read, uint16_t dev, uint16_t reg,
+                                     uint8_t *data, uint16_t size)
+{
+  uint32_t clocks = read ? MODEL_READ_CLOCKS(size) : MODEL_WRITE_CLOCKS(size);
+
+  if (hi2c->State != HAL_I2C_STATE_READY || model_xfer.active)
+  {
+    return HAL_BUSY;
+  }
+
+  model_xfer.ok = model_bus_init && model_present && model_scl_hz <= model_max_hz &&
+                  (dev == ADV7513_I2C_ADDR || (read && dev == ADV7513_EDID_I2C_ADDR));
+  if (!read && dev == ADV7513_I2C_ADDR && reg == model_nack_reg)
+  {
+    model_xfer.ok = 0;
+    model_nack_reg = -1;
+  }
+  if (!model_xfer.ok)
+  {
+    clocks = MODEL_NACK_CLOCKS;
+    size = 0;
+  }
+  model_xfer.active = 1;
+  model_xfer.read = read;
+  model_xfer.dev = dev;
+  model_xfer.reg = (uint8_t) reg;
+  model_xfer.data = data;
+  model_xfer.size = size;
+  model_xfer.end_ns = model_now_ns + (uint64_t) clocks * 1000000000ULL / model_scl_hz;
+  hi2c->State = HAL_I2C_STATE_BUSY;
+
+  model_stats.transactions++;
+  model_stats.bytes += size;
+  model_stats.bus_ns += model_xfer.end_ns - model_now_ns;
+
+  return HAL_OK;
+}
+
+/* End of the transfer on the bus: registers, then completion interrupt */
+static void model_complete(void)
+{
+  model_set_time(model_xfer.end_ns);
+  model_xfer.active = 0;
+  hbus_i2c2.State = HAL_I2C_STATE_READY;
+
+  if (!model_xfer.ok)
+  {
+    model_stats.errors++;
+    HAL_I2C_ErrorCallback(&hbus_i2c2);
+    return;
+  }
+  if (model_xfer.read)
+  {
+    model_read(model_xfer.dev, model_xfer.reg, model_xfer.data, model_xfer.size);
+    HAL_I2C_MemRxCpltCallback(&hbus_i2c2);
+  }
+  else
+  {
+    model_write(model_xfer.reg, model_xfer.data, model_xfer.size);
+    HAL_I2C_MemTxCpltCallback(&hbus_i2c2);
+  }
+}
+
+/**
+  * @brief  Power-on reset of the model, monitor connected, statistics cleared
+  * @param  max_hz Fastest SCL the board allows, faster transfers are NACKed
+  */
+void ADV7513_MODEL_Reset(uint32_t max_hz)
+{
+  model_max_hz = max_hz;
+  model_present = 1;
+  model_hpd = 1;
+  model_sense = 1;
+  model_hdmi_sink = 1;
+  model_qs = 1;
+  model_nack_reg = -1;
+  model_defaults();
+  model_build_edid();
+  ADV7513_MODEL_ClearStats();
+}
+
+/* Supply glitch: registers back to their reset values, monitor unchanged */
+void ADV7513_MODEL_ChipReset(void)
+{
+  model_defaults();
+}
+
+void ADV7513_MODEL_SetMonitor(int hpd, int sense)
+{
+  if (model_hpd && !hpd)
+  {
+    /* The transmitter is held powered down while HPD is low */
+    model_regs[0x41] |= 1 << 6;
+    model_regs[0x96] |= 1 << 7;
+  }
+  model_hpd = hpd;
+  model_sense = sense;
+  model_update();
+}
+
+/* HDMI or DVI monitor, both with a CEA-861 extension block */
+void ADV7513_MODEL_SetHdmiSink(int hdmi)
+{
+  model_hdmi_sink = hdmi;
+  model_build_edid();
+}
+
+/* Monitor with or without the RGB quantization range selectable */
+void ADV7513_MODEL_SetQuantSelect(int qs)
+{
+  model_qs = qs;
+  model_build_edid();
+}
+
+/* Write glitch: the next write starting at reg is NACKed */
+void ADV7513_MODEL_NackWrite(uint8_t reg)
+{
+  model_nack_reg = reg;
+}
+
+/* Transmitter not answering (board without adapter) */
+void ADV7513_MODEL_SetPresent(int present)
+{
+  model_present = present;
+}
+
+uint8_t ADV7513_MODEL_Peek(uint8_t reg)
+{
+  model_update();
+
+  return model_regs[reg];
+}
+
+/**
+  * @brief  Let time pass, transfers completing meanwhile
+  */
+void ADV7513_MODEL_Advance(uint64_t ns)
+{
+  uint64_t end = model_now_ns + ns;
+
+  while (model_xfer.active && model_xfer.end_ns <= end)
+  {
+    model_complete();
+  }
+  model_set_time(end);
+}
+
+uint64_t ADV7513_MODEL_GetTimeNs(void)
+{
+  return model_now_ns;
+}
+
+/* SCL of the transfers */
+uint32_t ADV7513_MODEL_GetSpeed(void)
+{
+  return model_scl_hz;
+}
+
+void ADV7513_MODEL_GetStats(ADV7513_MODEL_Stats_t *stats)
+{
+  *stats = model_stats;
+}
+
+void ADV7513_MODEL_ClearStats(void)
+{
+  memset(&model_stats, 0, sizeof(model_stats));
+}
+
+/* HAL and BSP stand-ins ---------------------------------------------------- */
+uint32_t HAL_GetTick(void)
+{
+  return (uint32_t)(model_now_ns / 1000000ULL);
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+  ADV7513_MODEL_Advance((uint64_t) Delay * 1000000ULL);
+}
+
+/* Sleep until the next interrupt: transfer completion or SysTick */
+void CPU_LOAD_Sleep(void)
+{
+  uint64_t tick_end = (model_now_ns / 1000000ULL + 1) * 1000000ULL;
+
+  if (model_xfer.active && model_xfer.end_ns <= tick_end)
+  {
+    model_complete();
+    return;
+  }
+  model_set_time(tick_end);
+}
+
+uint32_t HAL_RCCEx_GetPeriphCLKFreq(uint64_t PeriphClk)
+{
+  (void) PeriphClk;
+
+  return MODEL_I2C_CLOCK_HZ;
+}
+
+int32_t BSP_I2C2_Init(void)
+{
+  model_stats.bus_inits++;
+  model_bus_init = 1;
+  hbus_i2c2.State = HAL_I2C_STATE_READY;
+
+  return BSP_ERROR_NONE;
+}
+
+int32_t BSP_I2C2_DeInit(void)
+{
+  model_bus_init = 0;
+
+  return BSP_ERROR_NONE;
+}
+
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c)
+{
+  model_scl_hz = model_scl(hi2c->Init.Timing);
+  hi2c->State = HAL_I2C_STATE_READY;
+
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c)
+{
+  model_xfer.active = 0;
+  hi2c->State = 0;
+
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2CEx_ConfigFastModePlus(I2C_HandleTypeDef *hi2c, uint32_t FastModePlus)
+{
+  (void) hi2c;
+  (void) FastModePlus;
+
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                        uint16_t MemAddSize, uint8_t *pData, uint16_t Size)
+{
+  (void) MemAddSize;
+
+  return model_start(hi2c, 0, DevAddress, MemAddress, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                       uint16_t MemAddSize, uint8_t *pData, uint16_t Size)
+{
+  (void) MemAddSize;
+
+  return model_start(hi2c, 1, DevAddress, MemAddress, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma) { (void) hdma; return HAL_OK; }
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef *hdma) { (void) hdma; return HAL_OK; }
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma) { (void) hdma; return HAL_OK; }
+HAL_StatusTypeDef HAL_DMA_ConfigChannelAttributes(DMA_HandleTypeDef *hdma, uint32_t attributes)
+{
+  (void) hdma;
+  (void) attributes;
+  return HAL_OK;
+}
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+  (void) IRQn;
+  (void) PreemptPriority;
+  (void) SubPriority;
+}
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn) { (void) IRQn; }
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn) { (void) IRQn; }
+void CACHE_CTL_Clean(const void *address, uint32_t size) { (void) address; (void) size; }
+void CACHE_CTL_Invalidate(void *address, uint32_t size) { (void) address; (void) size; }
+
+/* Firmware modules linked by hdmi.c and hdmi_i2c.c ---------------------------------------- */
+void TRACE_Record(uint32_t event, uint32_t arg)
+{
+  (void) event;
+  (void) arg;
+}
+
+/* Same as Src/nvm.c: CRC-32 (IEEE 802.3, reflected) */
+uint32_t NVM_Crc32(uint32_t crc, const void *data, uint32_t size)
+{
+  const uint8_t *p = data;
+  int i;
+
+  crc = ~crc;
+  while (size--)
+  {
+    crc ^= *p++;
+    for (i = 0; i < 8; i++)
+    {
+      crc = (crc >> 1) ^ (0xEDB88320U & -(crc & 1U));
+    }
+  }
+
+  return ~crc;
+}
@@ -0,0 +1,35 @@
+/*
+ * ADV7513 I2C register model, host side. Serves the I2C2 DMA transfers of
+ * host/stm32n6xx_hal.h and host/stm32n6570_discovery_bus.h, and the
+ * simulated time.
+ */
+#ifndef ADV7513_MODEL_H
+#define ADV7513_MODEL_H
+
+#include <stdint.h>
+
+typedef struct
+{
+  uint32_t transactions;   /* I2C transfers (one address phase each) */
+  uint32_t bytes;          /* Register bytes read or written */
+  uint64_t bus_ns;         /* Modelled bus time of the transfers */
+  uint32_t bus_inits;      /* BSP_I2C2_Init() calls */
+  uint32_t errors;         /* Transfers NACKed: bus not initialized, SCL too fast */
+  uint32_t ro_writes;      /* Writes trying to change read-only bits */
+} ADV7513_MODEL_Stats_t;
+
+void ADV7513_MODEL_Reset(uint32_t max_hz);
+void ADV7513_MODEL_ChipReset(void);
+void ADV7513_MODEL_SetMonitor(int hpd, int sense);
+void ADV7513_MODEL_SetHdmiSink(int hdmi);
+void ADV7513_MODEL_SetQuantSelect(int qs);
+void ADV7513_MODEL_SetPresent(int present);
+void ADV7513_MODEL_NackWrite(uint8_t reg);
+uint8_t ADV7513_MODEL_Peek(uint8_t reg);
+void ADV7513_MODEL_Advance(uint64_t ns);
+uint64_t ADV7513_MODEL_GetTimeNs(void);
+uint32_t ADV7513_MODEL_GetSpeed(void);
+void ADV7513_MODEL_GetStats(ADV7513_MODEL_Stats_t *stats);
+void ADV7513_MODEL_ClearStats(void);
+
+#endif /* ADV7513_MODEL_H */
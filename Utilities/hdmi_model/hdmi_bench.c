@@ -0,0 +1,385 @@
+ /**
+ ******************************************************************************
+ * @file    hdmi_bench.c
+ * @author  GPM Application Team
+ * @brief   Host benchmark of the ADV7513 bring-up and link recovery.
+ *          Runs Src/hdmi.c and Src/hdmi_i2c.c unchanged against the register
+ *          model and reports the I2C traffic and modelled time of
+ *          HDMI_Detect() + HDMI_Init() for each output mode and board bus
+ *          speed, then of the link recoveries and mode switches.
+ *          Programmed registers are checked: exits with 1 on a mismatch.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "stm32n6xx_hal.h"
+#include "adv7513_model.h"
+#include "hdmi.h"
+#include "hdmi_i2c.h"
+
+#define NS_PER_MS        1000000ULL
+#define RECOVERY_MAX_MS  5000U
+
+typedef struct
+{
+  const char *name;
+  HDMI_Video_t video;
+} Mode_t;
+
+/* Same formats as main.c */
+static const Mode_t modes[] = {
+  { "480x480",     { 0, 0, 1, 1, HDMI_CONTENT_GAME } },
+  { "640x480",     { 0, 0, 1, 1, HDMI_CONTENT_GAME } },
+  { "800x480",     { 0, 0, 1, 1, HDMI_CONTENT_GAME } },
+  { "1280x720",    { 0, 1, 1, 1, HDMI_CONTENT_GAME } },
+  { "480p VIC14",  { 14, 0, 2, 1, HDMI_CONTENT_GAME } },
+  { "576p VIC29",  { 29, 0, 2, 1, HDMI_CONTENT_GAME } },
+};
+
+/* Fastest SCL the board allows: hdmi.c starts at HDMI_BUS_SPEED and lowers it */
+static const uint32_t speeds[] = { 100000, 400000, 1000000 };
+
+static int failures;
+/* Longest HDMI_Process() call, the main loop is blocked meanwhile */
+static uint64_t max_blocked_ns;
+
+static void check(int cond, const char *what, const char *mode, uint32_t hz)
+{
+  if (!cond)
+  {
+    printf("FAIL %s: %s at %lu kHz\n", mode, what, (unsigned long)(hz / 1000));
+    failures++;
+  }
+}
+
+/* Registers expected once the link is configured */
+static void check_registers(const Mode_t *mode, uint32_t hz, uint32_t nacks)
+{
+  const HDMI_Video_t *video = &mode->video;
+  /* CEA-861 code in the InfoFrame, power of two in 0x3b */
+  uint8_t code = video->pixel_repeat == 4 ? 3 : video->pixel_repeat - 1;
+  uint8_t shift = video->pixel_repeat == 4 ? 2 : video->pixel_repeat - 1;
+  uint8_t sum = 0x82;
+  ADV7513_MODEL_Stats_t stats;
+  uint8_t reg;
+
+  ADV7513_MODEL_GetStats(&stats);
+  check(stats.errors == nacks, "I2C errors", mode->name, hz);
+  check(stats.ro_writes == 0, "read-only bits written", mode->name, hz);
+  check((ADV7513_MODEL_Peek(0x41) & (1 << 6)) == 0, "powered down", mode->name, hz);
+  check((ADV7513_MODEL_Peek(0x9e) & (1 << 4)) != 0, "PLL not locked", mode->name, hz);
+  check(((ADV7513_MODEL_Peek(0x17) >> 1) & 1) == video->aspect_16_9, "aspect", mode->name, hz);
+  /* The model monitor has the HDMI VSDB: always HDMI mode */
+  check((ADV7513_MODEL_Peek(0xaf) & (1 << 1)) != 0, "DVI mode", mode->name, hz);
+  check((ADV7513_MODEL_Peek(0x44) & (1 << 4)) != 0, "AVI InfoFrame disabled", mode->name, hz);
+  check((ADV7513_MODEL_Peek(0x4a) & (1 << 6)) == 0, "AVI InfoFrame held", mode->name, hz);
+  for (reg = 0x52; reg < 0x52 + 3 + 13; reg++)
+  {
+    sum += ADV7513_MODEL_Peek(reg);
+  }
+  check(sum == 0, "AVI InfoFrame checksum", mode->name, hz);
+  check((ADV7513_MODEL_Peek(0x58) & 0x7f) == video->vic, "AVI InfoFrame VIC", mode->name, hz);
+  check((ADV7513_MODEL_Peek(0x59) >> 4) == video->content - HDMI_CONTENT_GRAPHICS,
+        "AVI InfoFrame content type", mode->name, hz);
+  check((ADV7513_MODEL_Peek(0x59) & 0x0f) == code, "AVI InfoFrame pixel repetition", mode->name, hz);
+  /* The model monitor has the RGB range selectable: full range, no CSC */
+  check(((ADV7513_MODEL_Peek(0x57) >> 2) & 3) == 2, "AVI InfoFrame quantization", mode->name, hz);
+  check((ADV7513_MODEL_Peek(0x18) & (1 << 7)) == 0, "CSC enabled", mode->name, hz);
+  if (video->vic != 0)
+  {
+    check(ADV7513_MODEL_Peek(0x3b) == ((2 << 5) | (shift << 3) | (shift << 1)), "pixel repetition",
+          mode->name, hz);
+    check((ADV7513_MODEL_Peek(0x3c) & 0x3f) == video->vic, "VIC", mode->name, hz);
+  }
+  check(HDMI_GetEdidHash() != 0, "EDID not read", mode->name, hz);
+}
+
+static void bench_bring_up(void)
+{
+  ADV7513_MODEL_Stats_t stats;
+  HDMI_I2C_Stats_t i2c;
+  HDMI_I2C_Stats_t i2c_start;
+  uint64_t start;
+  uint32_t i, j;
+
+  printf("HDMI_Detect() + HDMI_Init(), monitor plugged\n");
+  printf("%-12s %5s %5s %6s %6s %6s %9s %9s\n", "mode", "board", "SCL", "xfers", "bytes", "merged",
+         "bus ms", "total ms");
+  for (i = 0; i < sizeof(modes) / sizeof(modes[0]); i++)
+  {
+    for (j = 0; j < sizeof(speeds) / sizeof(speeds[0]); j++)
+    {
+      ADV7513_MODEL_Reset(speeds[j]);
+      HDMI_SetVideo(&modes[i].video);
+      HDMI_I2C_GetStats(&i2c_start);
+      start = ADV7513_MODEL_GetTimeNs();
+
+      check(HDMI_Detect(), "not detected", modes[i].name, speeds[j]);
+      HDMI_Init();
+
+      ADV7513_MODEL_GetStats(&stats);
+      HDMI_I2C_GetStats(&i2c);
+      printf("%-12s %5lu %5lu %6lu %6lu %6lu %9.3f %9.3f\n", modes[i].name,
+             (unsigned long)(speeds[j] / 1000), (unsigned long)(ADV7513_MODEL_GetSpeed() / 1000),
+             (unsigned long) stats.transactions, (unsigned long) stats.bytes,
+             (unsigned long)(i2c.merged - i2c_start.merged), (double) stats.bus_ns / NS_PER_MS,
+             (double)(ADV7513_MODEL_GetTimeNs() - start) / NS_PER_MS);
+      /* Detect and Start probe from HDMI_BUS_SPEED down */
+      check(ADV7513_MODEL_GetSpeed() <= speeds[j], "SCL above the board limit", modes[i].name, speeds[j]);
+      check_registers(&modes[i], speeds[j], 2 * ((speeds[j] < 1000000) + (speeds[j] < 400000)));
+    }
+  }
+}
+
+/* Main loop calling HDMI_Process() every millisecond */
+static void run_ms(uint32_t ms)
+{
+  uint64_t start;
+
+  while (ms--)
+  {
+    start = ADV7513_MODEL_GetTimeNs();
+    HDMI_Process();
+    if (ADV7513_MODEL_GetTimeNs() - start > max_blocked_ns)
+    {
+      max_blocked_ns = ADV7513_MODEL_GetTimeNs() - start;
+    }
+    ADV7513_MODEL_Advance(NS_PER_MS);
+  }
+}
+
+/* Link configured at the board speed, right after a health check: the worst
+ * case to notice a loss */
+static void bring_up(uint32_t hz, const HDMI_Video_t *video, HDMI_Health_t *health)
+{
+  HDMI_Health_t now;
+
+  ADV7513_MODEL_Reset(hz);
+  HDMI_SetVideo(video);
+  HDMI_Init();
+  run_ms(1000);
+  HDMI_GetHealth(health);
+  do
+  {
+    run_ms(1);
+    HDMI_GetHealth(&now);
+  } while (now.checks == health->checks);
+  *health = now;
+  ADV7513_MODEL_ClearStats();
+  max_blocked_ns = 0;
+}
+
+static void print_row(const char *name, uint32_t hz, uint32_t ms)
+{
+  ADV7513_MODEL_Stats_t stats;
+
+  ADV7513_MODEL_GetStats(&stats);
+  printf("%-12s %5lu %6lu %6lu %9.3f %9lu %9.3f\n", name, (unsigned long)(hz / 1000),
+         (unsigned long) stats.transactions, (unsigned long) stats.bytes,
+         (double) stats.bus_ns / NS_PER_MS, (unsigned long) ms, (double) max_blocked_ns / NS_PER_MS);
+  check(max_blocked_ns == 0, "main loop blocked", name, hz);
+}
+
+static void bench_recovery(const char *name, uint32_t hz, int hpd, int sense, int chip_reset,
+                           uint32_t outage_ms)
+{
+  HDMI_Health_t before, after;
+  /* Time from the monitor back to the link up again */
+  uint32_t ms = 0;
+
+  bring_up(hz, &modes[2].video, &before);
+  if (chip_reset)
+  {
+    ADV7513_MODEL_ChipReset();
+  }
+  ADV7513_MODEL_SetMonitor(hpd, sense);
+  run_ms(outage_ms);
+  ADV7513_MODEL_SetMonitor(1, 1);
+  HDMI_GetHealth(&after);
+  while (after.recoveries == before.recoveries && ms < RECOVERY_MAX_MS)
+  {
+    run_ms(1);
+    ms++;
+    HDMI_GetHealth(&after);
+  }
+  /* Mode and InfoFrame writes complete */
+  run_ms(10);
+
+  check(after.recoveries == before.recoveries + 1, "not recovered", name, hz);
+  print_row(name, hz, ms);
+  check_registers(&modes[2], hz, 0);
+}
+
+/* AVI InfoFrame content type changed once configured */
+static void bench_content_switch(uint32_t hz)
+{
+  Mode_t mode = modes[2];
+  HDMI_Health_t health;
+  uint32_t ms = 0;
+
+  bring_up(hz, &mode.video, &health);
+  mode.video.content = HDMI_CONTENT_CINEMA;
+  HDMI_SetContentType(HDMI_CONTENT_CINEMA);
+  while ((ADV7513_MODEL_Peek(0x59) >> 4) != HDMI_CONTENT_CINEMA - HDMI_CONTENT_GRAPHICS &&
+         ms < RECOVERY_MAX_MS)
+  {
+    run_ms(1);
+    ms++;
+  }
+  run_ms(10);
+
+  print_row("content", hz, ms);
+  check_registers(&mode, hz, 0);
+  HDMI_SetContentType(HDMI_CONTENT_GAME);
+  run_ms(10);
+}
+
+/* AVI InfoFrame write NACKed while held: sent again, hold released */
+static void bench_infoframe_error(uint32_t hz)
+{
+  Mode_t mode = modes[2];
+  HDMI_Health_t health;
+  uint32_t ms = 0;
+
+  bring_up(hz, &mode.video, &health);
+  mode.video.content = HDMI_CONTENT_CINEMA;
+  ADV7513_MODEL_NackWrite(0x52);
+  HDMI_SetContentType(HDMI_CONTENT_CINEMA);
+  while (((ADV7513_MODEL_Peek(0x59) >> 4) != HDMI_CONTENT_CINEMA - HDMI_CONTENT_GRAPHICS ||
+          (ADV7513_MODEL_Peek(0x4a) & (1 << 6)) != 0) && ms < RECOVERY_MAX_MS)
+  {
+    run_ms(1);
+    ms++;
+  }
+  run_ms(10);
+
+  print_row("AVI NACK", hz, ms);
+  check_registers(&mode, hz, 1);
+  HDMI_SetContentType(HDMI_CONTENT_GAME);
+  run_ms(10);
+}
+
+/* DVI monitor with a CEA-861 extension: DVI mode unless the format is CEA */
+static void bench_dvi_sink(uint32_t hz)
+{
+  uint32_t i;
+
+  for (i = 0; i < sizeof(modes) / sizeof(modes[0]); i++)
+  {
+    ADV7513_MODEL_Reset(hz);
+    ADV7513_MODEL_SetHdmiSink(0);
+    HDMI_SetVideo(&modes[i].video);
+    check(HDMI_Detect(), "not detected", modes[i].name, hz);
+    HDMI_Init();
+    run_ms(1000);
+    check(((ADV7513_MODEL_Peek(0xaf) >> 1) & 1) == (modes[i].video.vic != 0), "DVI sink mode",
+          modes[i].name, hz);
+    check(((ADV7513_MODEL_Peek(0x44) >> 4) & 1) == (modes[i].video.vic != 0), "DVI sink InfoFrame",
+          modes[i].name, hz);
+  }
+}
+
+/* Monitor without RGB range selection: default range, limited for CEA formats
+ * but VIC 1, scaled by the CSC */
+static void bench_default_range(uint32_t hz)
+{
+  uint32_t i;
+  int limited;
+
+  for (i = 0; i < sizeof(modes) / sizeof(modes[0]); i++)
+  {
+    ADV7513_MODEL_Reset(hz);
+    ADV7513_MODEL_SetQuantSelect(0);
+    HDMI_SetVideo(&modes[i].video);
+    check(HDMI_Detect(), "not detected", modes[i].name, hz);
+    HDMI_Init();
+    run_ms(1000);
+    limited = modes[i].video.vic > 1;
+    check(((ADV7513_MODEL_Peek(0x57) >> 2) & 3) == 0, "AVI InfoFrame default quantization",
+          modes[i].name, hz);
+    check(((ADV7513_MODEL_Peek(0x18) >> 7) & 1) == limited, "CSC for the default range",
+          modes[i].name, hz);
+    if (limited)
+    {
+      /* Diagonal 219/255 and offset 16 */
+      check((ADV7513_MODEL_Peek(0x18) & 0x1f) == 0x0d && ADV7513_MODEL_Peek(0x19) == 0xbe &&
+            ADV7513_MODEL_Peek(0x22) == 0x0d && ADV7513_MODEL_Peek(0x2d) == 0xbe &&
+            ADV7513_MODEL_Peek(0x2e) == 0x01 && ADV7513_MODEL_Peek(0x1a) == 0x00,
+            "CSC coefficients", modes[i].name, hz);
+    }
+  }
+}
+
+static void bench_health(uint32_t hz)
+{
+  ADV7513_MODEL_Stats_t stats;
+  HDMI_Health_t before, after;
+  uint32_t checks;
+
+  bring_up(hz, &modes[2].video, &before);
+  run_ms(60000);
+  HDMI_GetHealth(&after);
+  ADV7513_MODEL_GetStats(&stats);
+
+  checks = after.checks - before.checks;
+  check(checks > 0, "no health check", "health", hz);
+  check(after.recoveries == before.recoveries, "link lost", "health", hz);
+  check(max_blocked_ns == 0, "main loop blocked", "health", hz);
+  printf("%-12s %5lu %6lu %6lu %9.3f %9lu\n", "health", (unsigned long)(hz / 1000),
+         (unsigned long)(stats.transactions / checks), (unsigned long)(stats.bytes / checks),
+         (double) stats.bus_ns / checks / NS_PER_MS, (unsigned long) checks);
+}
+
+int main(void)
+{
+  uint32_t j;
+
+  bench_bring_up();
+
+  printf("\nLink recovery and mode switch, 800x480 (traffic, time from the monitor back\n"
+         "or the switch to the link up, longest HDMI_Process() call)\n");
+  printf("%-12s %5s %6s %6s %9s %9s %9s\n", "event", "board", "xfers", "bytes", "bus ms", "up ms",
+         "block ms");
+  for (j = 0; j < sizeof(speeds) / sizeof(speeds[0]); j++)
+  {
+    bench_recovery("unplug", speeds[j], 0, 0, 0, 1000);
+    bench_recovery("standby", speeds[j], 1, 0, 0, 2000);
+    bench_recovery("chip reset", speeds[j], 1, 1, 1, 0);
+    bench_content_switch(speeds[j]);
+    bench_infoframe_error(speeds[j]);
+  }
+
+  for (j = 0; j < sizeof(speeds) / sizeof(speeds[0]); j++)
+  {
+    bench_dvi_sink(speeds[j]);
+    bench_default_range(speeds[j]);
+  }
+
+  printf("\nHealth check, per check over 60 s\n");
+  printf("%-12s %5s %6s %6s %9s %9s\n", "", "board", "xfers", "bytes", "bus ms", "checks");
+  for (j = 0; j < sizeof(speeds) / sizeof(speeds[0]); j++)
+  {
+    bench_health(speeds[j]);
+  }
+
+  if (failures)
+  {
+    printf("\n%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("\nAll checks passed\n");
+
+  return 0;
+}
@@ -0,0 +1,18 @@
+/*
+ * Host stand-in for the BSP I2C2 bus used by Src/hdmi_i2c.c, served by the
+ * ADV7513 register model (adv7513_model.c).
+ */
+#ifndef STM32N6570_DISCOVERY_BUS_H
+#define STM32N6570_DISCOVERY_BUS_H
+
+#include "stm32n6xx_hal.h"
+
+#define BSP_ERROR_NONE              0
+#define BSP_ERROR_BUS_FAILURE      -8
+
+extern I2C_HandleTypeDef hbus_i2c2;
+
+int32_t BSP_I2C2_Init(void);
+int32_t BSP_I2C2_DeInit(void);
+
+#endif /* STM32N6570_DISCOVERY_BUS_H */
@@ -0,0 +1,114 @@
+/*
+ * Host stand-in for the few HAL definitions used by Src/hdmi.c and
+ * Src/hdmi_i2c.c. The I2C and DMA transfers, and time, are simulated by
+ * adv7513_model.c: time advances with the modelled I2C bus time, HAL_Delay()
+ * and CPU_LOAD_Sleep().
+ */
+#ifndef STM32N6XX_HAL_H
+#define STM32N6XX_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum { HAL_OK, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+typedef enum { I2C2_EV_IRQn, I2C2_ER_IRQn, GPDMA1_Channel2_IRQn, GPDMA1_Channel3_IRQn } IRQn_Type;
+
+typedef struct
+{
+  volatile uint32_t CYCCNT;
+} DWT_Type;
+
+extern DWT_Type host_dwt;
+#define DWT (&host_dwt)
+
+extern uint32_t SystemCoreClock;
+
+typedef struct { int id; } DMA_Channel_TypeDef;
+extern DMA_Channel_TypeDef *GPDMA1_Channel2;
+extern DMA_Channel_TypeDef *GPDMA1_Channel3;
+
+#define GPDMA1_REQUEST_I2C2_RX        0U
+#define GPDMA1_REQUEST_I2C2_TX        1U
+#define DMA_BREQ_SINGLE_BURST         0U
+#define DMA_MEMORY_TO_PERIPH          1U
+#define DMA_PERIPH_TO_MEMORY          2U
+#define DMA_SINC_FIXED                0U
+#define DMA_SINC_INCREMENTED          1U
+#define DMA_DINC_FIXED                0U
+#define DMA_DINC_INCREMENTED          1U
+#define DMA_SRC_DATAWIDTH_BYTE        0U
+#define DMA_DEST_DATAWIDTH_BYTE       0U
+#define DMA_LOW_PRIORITY_LOW_WEIGHT   0U
+#define DMA_SRC_ALLOCATED_PORT0       0U
+#define DMA_DEST_ALLOCATED_PORT0      0U
+#define DMA_TCEM_BLOCK_TRANSFER       0U
+#define DMA_NORMAL                    0U
+#define DMA_CHANNEL_SEC               1U
+#define DMA_CHANNEL_PRIV              2U
+#define DMA_CHANNEL_SRC_SEC           4U
+#define DMA_CHANNEL_DEST_SEC          8U
+
+typedef struct
+{
+  uint32_t Request, BlkHWRequest, Direction, SrcInc, DestInc, SrcDataWidth, DestDataWidth;
+  uint32_t Priority, SrcBurstLength, DestBurstLength, TransferAllocatedPort, TransferEventMode, Mode;
+} DMA_InitTypeDef;
+
+typedef struct
+{
+  DMA_Channel_TypeDef *Instance;
+  DMA_InitTypeDef Init;
+  void *Parent;
+} DMA_HandleTypeDef;
+
+#define HAL_I2C_STATE_READY           0x20U
+#define HAL_I2C_STATE_BUSY            0x24U
+#define I2C_MEMADD_SIZE_8BIT          1U
+#define I2C_FASTMODEPLUS_ENABLE       1U
+#define I2C_FASTMODEPLUS_DISABLE      0U
+#define RCC_PERIPHCLK_I2C2            1ULL
+
+typedef struct
+{
+  uint32_t Timing;
+} I2C_InitTypeDef;
+
+typedef struct
+{
+  I2C_InitTypeDef Init;
+  volatile uint32_t State;
+  DMA_HandleTypeDef *hdmatx;
+  DMA_HandleTypeDef *hdmarx;
+} I2C_HandleTypeDef;
+
+#define __HAL_LINKDMA(h, field, dma)  do { (h)->field = &(dma); (dma).Parent = (h); } while (0)
+#define __HAL_RCC_GPDMA1_CLK_ENABLE() do { } while (0)
+
+/* Single thread: the simulated interrupts run from the model, never
+ * concurrently with the code under test */
+static inline uint32_t __get_PRIMASK(void) { return 0; }
+static inline void __set_PRIMASK(uint32_t primask) { (void) primask; }
+static inline void __disable_irq(void) { }
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+uint32_t HAL_RCCEx_GetPeriphCLKFreq(uint64_t PeriphClk);
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma);
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef *hdma);
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma);
+HAL_StatusTypeDef HAL_DMA_ConfigChannelAttributes(DMA_HandleTypeDef *hdma, uint32_t attributes);
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_I2CEx_ConfigFastModePlus(I2C_HandleTypeDef *hi2c, uint32_t FastModePlus);
+HAL_StatusTypeDef HAL_I2C_Mem_Write_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                        uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Mem_Read_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                       uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
+
+#endif /* STM32N6XX_HAL_H */
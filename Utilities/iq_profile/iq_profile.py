@@ -0,0 +1,90 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Build and inspect IQ profile images for the external NOR.
+
+Image layout (little endian), see Inc/iq_profile.h:
+    magic 'IQPF' | version u16 | count u16 | param_size u32 | name[16] | crc u32
+    ISP_IQParamTypeDef[count] in ISP_IQParamCacheInit[] order
+"""
+
+import argparse
+import struct
+import subprocess
+import sys
+import tempfile
+import zlib
+import os
+
+MAGIC = 0x46505149
+VERSION = 1
+NAME_LEN = 16
+HEADER = struct.Struct('<IHHI%dsI' % NAME_LEN)
+MAX_SIZE = 0x2000  # NVM_IQ_PROFILE_SIZE
+
+# Index order of ISP_IQParamCacheInit[] (IQ_PROFILE_TABLE_xxx)
+TABLES = ['ISP_IQParamCacheInit_IMX335', 'ISP_IQParamCacheInit_VD66GY']
+
+
+def extract(objcopy, obj, symbol):
+    with tempfile.TemporaryDirectory() as tmp:
+        out = os.path.join(tmp, symbol + '.raw')
+        subprocess.run([objcopy, '-O', 'binary', '-j', '.rodata.' + symbol, obj, out], check=True)
+        with open(out, 'rb') as f:
+            return f.read()
+
+
+def pack(args):
+    tables = [extract(args.objcopy, args.obj, name) for name in TABLES]
+    sizes = {len(t) for t in tables}
+    if len(sizes) != 1 or 0 in sizes:
+        sys.exit('error: inconsistent table sizes %s, was the object built with -fdata-sections?' % sizes)
+    param_size = sizes.pop()
+    payload = b''.join(tables)
+    name = args.name.encode()[:NAME_LEN - 1]
+    image = HEADER.pack(MAGIC, VERSION, len(tables), param_size, name, zlib.crc32(payload)) + payload
+    if len(image) > MAX_SIZE:
+        sys.exit('error: image is %d bytes, profile slot is %d' % (len(image), MAX_SIZE))
+    with open(args.output, 'wb') as f:
+        f.write(image)
+    print('%s: "%s", %d tables of %d bytes' % (args.output, args.name, len(tables), param_size))
+
+
+def info(args):
+    with open(args.image, 'rb') as f:
+        data = f.read()
+    magic, version, count, param_size, name, crc = HEADER.unpack_from(data)
+    payload = data[HEADER.size:HEADER.size + count * param_size]
+    ok = magic == MAGIC and version == VERSION and len(payload) == count * param_size \
+        and zlib.crc32(payload) == crc
+    print('name       : %s' % name.rstrip(b'\0').decode(errors='replace'))
+    print('version    : %d' % version)
+    print('tables     : %d x %d bytes' % (count, param_size))
+    print('crc        : 0x%08x (%s)' % (crc, 'ok' if ok else 'INVALID'))
+    return 0 if ok else 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest='cmd', required=True)
+    p = sub.add_parser('pack', help='build an image from iq_profile_tables.o')
+    p.add_argument('obj')
+    p.add_argument('-o', '--output', required=True)
+    p.add_argument('--name', default='default')
+    p.add_argument('--objcopy', default='arm-none-eabi-objcopy')
+    p.set_defaults(func=pack)
+    p = sub.add_parser('info', help='check and describe an image')
+    p.add_argument('image')
+    p.set_defaults(func=info)
+    args = parser.parse_args()
+    sys.exit(args.func(args))
+
+
+if __name__ == '__main__':
+    main()
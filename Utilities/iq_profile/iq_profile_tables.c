@@ -0,0 +1,35 @@
+ /**
+ ******************************************************************************
+ * @file    iq_profile_tables.c
+ * @author  GPM Application Team
+ * @brief   IQ tables extracted by iq_profile.py to build a NOR profile image.
+ *          Compiled with the target toolchain and flags so that the tables
+ *          have exactly the layout expected by the firmware.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "isp_api.h"
+
+/* Header generated by the IQ tuning tool, Inc/isp_param_conf.h by default */
+#ifndef IQ_PARAM_CONF
+#define IQ_PARAM_CONF "isp_param_conf.h"
+#endif
+#include IQ_PARAM_CONF
+
+/* The tables are static in the header: keep them in the object file, each in
+ * its own .rodata.<name> section (-fdata-sections) */
+__attribute__((used))
+static const ISP_IQParamTypeDef *const iq_profile_tables[] = {
+  &ISP_IQParamCacheInit_IMX335,
+  &ISP_IQParamCacheInit_VD66GY,
+};
@@ -0,0 +1,15 @@
+/*
+ * Host stand-in for the ISP library tool transport interface.
+ */
+#ifndef ISP_TOOL_COM_H
+#define ISP_TOOL_COM_H
+
+#include <stdint.h>
+
+void ISP_ToolCom_Init(void);
+uint32_t ISP_ToolCom_CheckCommandReceived(uint8_t **cmd);
+void ISP_ToolCom_PrepareNextCommand(void);
+void ISP_ToolCom_SendData(uint8_t *buffer, uint32_t buffer_size, char *dump_start_delimiter,
+                          char *dump_stop_delimiter);
+
+#endif /* ISP_TOOL_COM_H */
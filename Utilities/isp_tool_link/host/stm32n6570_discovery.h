@@ -0,0 +1,30 @@
+/*
+ * Host stand-in for the BSP COM port definitions used by Src/isp_tool_uart.c.
+ */
+#ifndef STM32N6570_DISCOVERY_H
+#define STM32N6570_DISCOVERY_H
+
+#include "stm32n6xx_hal.h"
+
+#define BSP_ERROR_NONE  0
+
+typedef enum { COM1 = 0, COMn } COM_TypeDef;
+typedef enum { COM_WORDLENGTH_8B } COM_WordLengthTypeDef;
+typedef enum { COM_STOPBITS_1 } COM_StopBitsTypeDef;
+typedef enum { COM_PARITY_NONE } COM_ParityTypeDef;
+typedef enum { COM_HWCONTROL_NONE } COM_HwFlowCtlTypeDef;
+
+typedef struct
+{
+  uint32_t BaudRate;
+  COM_WordLengthTypeDef WordLength;
+  COM_StopBitsTypeDef StopBits;
+  COM_ParityTypeDef Parity;
+  COM_HwFlowCtlTypeDef HwFlowCtl;
+} COM_InitTypeDef;
+
+extern UART_HandleTypeDef hcom_uart[COMn];
+
+int32_t BSP_COM_Init(COM_TypeDef COM, COM_InitTypeDef *COM_Init);
+
+#endif /* STM32N6570_DISCOVERY_H */
@@ -0,0 +1,84 @@
+/*
+ * Host stand-in for the few HAL definitions used by Src/isp_tool_uart.c.
+ * The UART and DMA are simulated by isp_tool_loopback.c.
+ */
+#ifndef STM32N6XX_HAL_H
+#define STM32N6XX_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum { HAL_OK, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+typedef enum { USART1_IRQn, GPDMA1_Channel0_IRQn, GPDMA1_Channel1_IRQn } IRQn_Type;
+
+#define HAL_UART_STATE_READY     0x20U
+#define HAL_UART_STATE_BUSY_TX   0x21U
+#define HAL_UART_STATE_BUSY_RX   0x22U
+#define HAL_UART_RXEVENT_TC      0U
+#define HAL_UART_RXEVENT_HT      1U
+#define HAL_UART_RXEVENT_IDLE    2U
+
+typedef struct { int id; } DMA_Channel_TypeDef;
+extern DMA_Channel_TypeDef *GPDMA1_Channel0;
+extern DMA_Channel_TypeDef *GPDMA1_Channel1;
+
+#define GPDMA1_REQUEST_USART1_RX      0U
+#define GPDMA1_REQUEST_USART1_TX      1U
+#define DMA_BREQ_SINGLE_BURST         0U
+#define DMA_MEMORY_TO_PERIPH          1U
+#define DMA_PERIPH_TO_MEMORY          2U
+#define DMA_SINC_FIXED                0U
+#define DMA_SINC_INCREMENTED          1U
+#define DMA_DINC_FIXED                0U
+#define DMA_DINC_INCREMENTED          1U
+#define DMA_SRC_DATAWIDTH_BYTE        0U
+#define DMA_DEST_DATAWIDTH_BYTE       0U
+#define DMA_LOW_PRIORITY_LOW_WEIGHT   0U
+#define DMA_SRC_ALLOCATED_PORT0       0U
+#define DMA_DEST_ALLOCATED_PORT0      0U
+#define DMA_TCEM_BLOCK_TRANSFER       0U
+#define DMA_NORMAL                    0U
+#define DMA_CHANNEL_SEC               1U
+#define DMA_CHANNEL_PRIV              2U
+#define DMA_CHANNEL_SRC_SEC           4U
+#define DMA_CHANNEL_DEST_SEC          8U
+
+typedef struct
+{
+  uint32_t Request, BlkHWRequest, Direction, SrcInc, DestInc, SrcDataWidth, DestDataWidth;
+  uint32_t Priority, SrcBurstLength, DestBurstLength, TransferAllocatedPort, TransferEventMode, Mode;
+} DMA_InitTypeDef;
+
+typedef struct
+{
+  DMA_Channel_TypeDef *Instance;
+  DMA_InitTypeDef Init;
+  void *Parent;
+} DMA_HandleTypeDef;
+
+typedef struct
+{
+  volatile uint32_t gState;
+  volatile uint32_t RxState;
+  DMA_HandleTypeDef *hdmatx;
+  DMA_HandleTypeDef *hdmarx;
+} UART_HandleTypeDef;
+
+#define __HAL_LINKDMA(h, field, dma)  do { (h)->field = &(dma); (dma).Parent = (h); } while (0)
+#define __HAL_RCC_GPDMA1_CLK_ENABLE() do { } while (0)
+#define __DMB()                       __sync_synchronize()
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma);
+HAL_StatusTypeDef HAL_DMA_ConfigChannelAttributes(DMA_HandleTypeDef *hdma, uint32_t attributes);
+HAL_StatusTypeDef HAL_UARTEx_EnableFifoMode(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+uint32_t HAL_UARTEx_GetRxEventType(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size);
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size);
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart);
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
+
+#endif /* STM32N6XX_HAL_H */
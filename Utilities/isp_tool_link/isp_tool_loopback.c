@@ -0,0 +1,341 @@
+ /**
+ ******************************************************************************
+ * @file    isp_tool_loopback.c
+ * @author  GPM Application Team
+ * @brief   Host loopback stand-in for the ISP tuning tool UART link.
+ *          Runs Src/isp_tool_uart.c unchanged on top of a simulated UART/DMA
+ *          and plays the tuning tool: each command is written at once and
+ *          ends with an idle line, received in random slices, some oversized
+ *          or hit by line errors; replies are checked on the wire.
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stm32n6xx_hal.h"
+#include "stm32n6570_discovery.h"
+#include "isp_tool_com.h"
+#include "isp_tool_uart.h"
+#include "cache_ctl.h"
+
+#define WIRE_SIZE        (64 * 1024 * 1024)
+#define WIRE_ENDS        (1024 * 1024)
+#define DUMP_SIZE        70000
+#define DUMP_START       "<dump>"
+#define DUMP_STOP        "</dump>"
+
+/* Simulated peripherals ---------------------------------------------------- */
+static DMA_Channel_TypeDef channel0, channel1;
+DMA_Channel_TypeDef *GPDMA1_Channel0 = &channel0;
+DMA_Channel_TypeDef *GPDMA1_Channel1 = &channel1;
+UART_HandleTypeDef hcom_uart[COMn];
+
+static uint8_t *sim_rx_buf;
+static uint32_t sim_rx_size;
+static uint32_t sim_rx_count;
+static uint32_t sim_rx_event;
+static const uint8_t *sim_tx_buf;
+static uint32_t sim_tx_size;
+
+/* Host side of the line */
+static uint8_t *wire_in;
+static uint32_t wire_in_len;
+static uint32_t wire_in_pos;
+static uint8_t *wire_out;
+static uint32_t wire_out_len;
+static uint8_t *expected;
+static uint32_t expected_len;
+/* Wire positions where the tool stops writing (line idle), of a line error */
+static uint32_t *wire_ends;
+static uint32_t wire_ends_nb;
+static uint32_t wire_ends_pos;
+static uint32_t wire_error_at = UINT32_MAX;
+/* Commands expected to be dropped by the target */
+static uint32_t dropped;
+
+static uint8_t dump_buffer[DUMP_SIZE];
+
+int32_t BSP_COM_Init(COM_TypeDef COM, COM_InitTypeDef *COM_Init)
+{
+  (void) COM_Init;
+  hcom_uart[COM].gState = HAL_UART_STATE_READY;
+  hcom_uart[COM].RxState = HAL_UART_STATE_READY;
+  return BSP_ERROR_NONE;
+}
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma) { (void) hdma; return HAL_OK; }
+HAL_StatusTypeDef HAL_DMA_ConfigChannelAttributes(DMA_HandleTypeDef *hdma, uint32_t attributes)
+{
+  (void) hdma;
+  (void) attributes;
+  return HAL_OK;
+}
+HAL_StatusTypeDef HAL_UARTEx_EnableFifoMode(UART_HandleTypeDef *huart) { (void) huart; return HAL_OK; }
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+  (void) IRQn;
+  (void) PreemptPriority;
+  (void) SubPriority;
+}
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn) { (void) IRQn; }
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn) { (void) IRQn; }
+void CACHE_CTL_Clean(const void *address, uint32_t size) { (void) address; (void) size; }
+void CACHE_CTL_Invalidate(void *address, uint32_t size) { (void) address; (void) size; }
+
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+  if (huart->RxState != HAL_UART_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+  huart->RxState = HAL_UART_STATE_BUSY_RX;
+  sim_rx_buf = pData;
+  sim_rx_size = Size;
+  sim_rx_count = 0;
+  return HAL_OK;
+}
+
+uint32_t HAL_UARTEx_GetRxEventType(UART_HandleTypeDef *huart)
+{
+  (void) huart;
+  return sim_rx_event;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size)
+{
+  if (huart->gState != HAL_UART_STATE_READY || Size == 0)
+  {
+    return HAL_BUSY;
+  }
+  huart->gState = HAL_UART_STATE_BUSY_TX;
+  sim_tx_buf = pData;
+  sim_tx_size = Size;
+  return HAL_OK;
+}
+
+static void sim_rx_raise(uint32_t event)
+{
+  UART_HandleTypeDef *huart = &hcom_uart[COM1];
+
+  sim_rx_event = event;
+  if (event != HAL_UART_RXEVENT_HT)
+  {
+    huart->RxState = HAL_UART_STATE_READY;
+  }
+  HAL_UARTEx_RxEventCallback(huart, (uint16_t) sim_rx_count);
+}
+
+/* Framing error: HAL aborts the reception, bytes not yet reported are lost */
+static void sim_rx_error(void)
+{
+  UART_HandleTypeDef *huart = &hcom_uart[COM1];
+
+  huart->RxState = HAL_UART_STATE_READY;
+  HAL_UART_ErrorCallback(huart);
+}
+
+/* Line delivers up to n bytes, idle once the tool has written everything */
+static void sim_rx_burst(uint32_t n)
+{
+  UART_HandleTypeDef *huart = &hcom_uart[COM1];
+
+  while (n-- && wire_in_pos < wire_in_len && huart->RxState == HAL_UART_STATE_BUSY_RX)
+  {
+    if (wire_in_pos == wire_error_at)
+    {
+      wire_error_at = UINT32_MAX;
+      sim_rx_error();
+      continue;
+    }
+    sim_rx_buf[sim_rx_count++] = wire_in[wire_in_pos++];
+    if (sim_rx_count == sim_rx_size / 2)
+    {
+      sim_rx_raise(HAL_UART_RXEVENT_HT);
+    }
+    else if (sim_rx_count == sim_rx_size)
+    {
+      sim_rx_raise(HAL_UART_RXEVENT_TC);
+    }
+    if (wire_ends_pos < wire_ends_nb && wire_in_pos == wire_ends[wire_ends_pos])
+    {
+      wire_ends_pos++;
+      /* HAL reports an idle line only with bytes in the buffer */
+      if (huart->RxState == HAL_UART_STATE_BUSY_RX && sim_rx_count > 0)
+      {
+        sim_rx_raise(HAL_UART_RXEVENT_IDLE);
+      }
+      break;
+    }
+  }
+}
+static void sim_tx_complete(void)
+{
+  UART_HandleTypeDef *huart = &hcom_uart[COM1];
+
+  if (huart->gState != HAL_UART_STATE_BUSY_TX)
+  {
+    return;
+  }
+  memcpy(&wire_out[wire_out_len], sim_tx_buf, sim_tx_size);
+  wire_out_len += sim_tx_size;
+  huart->gState = HAL_UART_STATE_READY;
+  HAL_UART_TxCpltCallback(huart);
+}
+
+/* Tuning tool side --------------------------------------------------------- */
+static void expect(const void *data, uint32_t size)
+{
+  memcpy(&expected[expected_len], data, size);
+  expected_len += size;
+}
+
+/* One write of the tool: the bytes follow each other, then the line is idle */
+static void host_send(const uint8_t *payload, uint32_t size)
+{
+  memcpy(&wire_in[wire_in_len], payload, size);
+  wire_in_len += size;
+  wire_ends[wire_ends_nb++] = wire_in_len;
+}
+
+static void host_command(void)
+{
+  uint8_t payload[ISP_TOOL_UART_CMD_MAX + 256];
+  uint32_t size;
+  uint32_t i;
+
+  if (rand() % 16 == 0)
+  {
+    memcpy(payload, "DUMP", 4);
+    host_send(payload, 4);
+    expect(DUMP_START, strlen(DUMP_START));
+    expect(dump_buffer, DUMP_SIZE);
+    expect(DUMP_STOP, strlen(DUMP_STOP));
+    return;
+  }
+
+  /* Oversized: dropped without reply, the next command must get through */
+  size = rand() % 16 == 0 ? ISP_TOOL_UART_CMD_MAX + 1 + rand() % 256 : 1 + rand() % ISP_TOOL_UART_CMD_MAX;
+  for (i = 0; i < size; i++)
+  {
+    payload[i] = rand() & 0xff;
+  }
+  payload[0] = 'E';
+  /* Line error within the command: dropped, the tool times out */
+  if (size <= ISP_TOOL_UART_CMD_MAX && rand() % 16 == 0)
+  {
+    wire_error_at = wire_in_len + rand() % size;
+    host_send(payload, size);
+    dropped++;
+    return;
+  }
+  host_send(payload, size);
+  if (size > ISP_TOOL_UART_CMD_MAX)
+  {
+    dropped++;
+    return;
+  }
+  expect(payload, size);
+}
+
+/* Stand-in for ISP_CmdParser_ProcessCommand(): echoes, or dumps on "DUMP" */
+static void loopback_parse(uint8_t *cmd, uint32_t size)
+{
+  if (size == 4 && memcmp(cmd, "DUMP", 4) == 0)
+  {
+    ISP_ToolCom_SendData(dump_buffer, DUMP_SIZE, DUMP_START, DUMP_STOP);
+    return;
+  }
+  ISP_ToolCom_SendData(cmd, size, NULL, NULL);
+}
+
+/* What the ISP core does for the tool from its background process */
+static void isp_background_process(void)
+{
+  uint8_t *cmd;
+  uint32_t size = ISP_ToolCom_CheckCommandReceived(&cmd);
+
+  if (size)
+  {
+    loopback_parse(cmd, size);
+    ISP_ToolCom_PrepareNextCommand();
+  }
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t nb_commands = argc > 1 ? strtoul(argv[1], NULL, 0) : 2000;
+  uint32_t sent = 0;
+  uint32_t steps = 0;
+  ISP_TOOL_UART_Stats_t stats;
+  uint32_t i;
+
+  srand(argc > 2 ? strtoul(argv[2], NULL, 0) : 1);
+  wire_in = malloc(WIRE_SIZE);
+  wire_out = malloc(WIRE_SIZE);
+  expected = malloc(WIRE_SIZE);
+  wire_ends = malloc(WIRE_ENDS * sizeof(wire_ends[0]));
+  for (i = 0; i < DUMP_SIZE; i++)
+  {
+    dump_buffer[i] = i * 7;
+  }
+
+  ISP_ToolCom_Init();
+  while (sent < nb_commands || wire_out_len < expected_len)
+  {
+    /* The tool waits for the previous reply before sending a command */
+    if (sent < nb_commands && wire_out_len == expected_len && wire_in_pos == wire_in_len)
+    {
+      host_command();
+      sent++;
+    }
+    sim_rx_burst(rand() % 300);
+    if (rand() % 2)
+    {
+      sim_tx_complete();
+    }
+    (void) ISP_TOOL_UART_Process();
+    /* The ISP does not run on every frame */
+    if (rand() % 3 == 0)
+    {
+      isp_background_process();
+    }
+    if (++steps > 100 * nb_commands + 100000)
+    {
+      break;
+    }
+  }
+
+  /* Last command taken in, even if dropped */
+  for (i = 0; i < 16; i++)
+  {
+    sim_rx_burst(300);
+    (void) ISP_TOOL_UART_Process();
+  }
+
+  ISP_TOOL_UART_GetStats(&stats);
+  printf("commands %u/%u, rx %u bytes (%u lost, %u dropped commands), tx %u bytes (%u dropped), %u steps\n",
+         stats.commands, sent, stats.rx_bytes, stats.rx_overruns, stats.frame_errors,
+         stats.tx_bytes, stats.tx_drops, steps);
+
+  if (stats.commands != sent - dropped || stats.frame_errors != dropped || wire_out_len != expected_len ||
+      memcmp(wire_out, expected, expected_len) != 0)
+  {
+    printf("FAIL: %u bytes received, %u expected\n", wire_out_len, expected_len);
+    return 1;
+  }
+  printf("PASS\n");
+
+  return 0;
+}
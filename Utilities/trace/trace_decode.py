@@ -0,0 +1,287 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Decode the video pipeline trace and report latency histograms.
+
+Packet layout (little endian), see Src/trace.c:
+    magic 'TRCE' | count u16 | lost u16 | first u32 | {timestamp u32, event u32}[count]
+event is (id << 24) | arg, timestamp is the DWT cycle counter.
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = 0x45435254
+HEADER = struct.Struct('<IHHI')
+RECORD = struct.Struct('<II')
+PACKET_MAX = 32  # TRACE_PACKET_MAX
+
+EVENTS = {
+    0x01: 'CAM_VSYNC',
+    0x02: 'CAM_FRAME',
+    0x03: 'CSI_ERROR',
+    0x04: 'CAM_RESTART',
+    0x05: 'CAM_RECOVERED',
+    0x10: 'LTDC_RELOAD',
+    0x11: 'LTDC_LINE',
+    0x12: 'FRAME_PRESENT',
+    0x13: 'LTDC_UNDERRUN',
+    0x20: 'ISP_RUN_START',
+    0x21: 'ISP_RUN_END',
+    0x30: 'HDMI_STATE',
+    0x31: 'HDMI_LINK_LOST',
+    0x32: 'HDMI_RECOVERED',
+    0x38: 'BOOT_PHASE',
+    0x40: 'PMU_REGION',
+    0x41: 'PMU_CYCLES',
+    0x42: 'PMU_INSTR',
+    0x43: 'PMU_DCACHE_MISS',
+    0x44: 'PMU_STALL',
+    0x45: 'PMU_BUS',
+    0x50: 'PSRAM_BENCH',
+    0x58: 'IRQ_LATENCY',
+    0x5c: 'BUS_ARB',
+    0x60: 'DISP_LATENCY',
+}
+
+PMU_REGIONS = ['ISP', 'OVERLAY', 'ISR_DCMIPP', 'ISR_LTDC']
+PMU_FIELDS = {0x41: 'cycles', 0x42: 'instr', 0x43: 'dcache_miss', 0x44: 'stall', 0x45: 'bus'}
+
+HDMI_CAUSES = ['-', 'HPD', 'sense', 'PLL', 'chip reset']
+
+HDMI_CONTENTS = ['none', 'graphics', 'photo', 'cinema', 'game']
+
+HDMI_STATES = ['ABSENT', 'DETECTED', 'WAIT_HPD', 'PLUGGED', 'POWERED', 'CONFIGURED']
+
+BOOT_PHASES = ['hw', 'nor', 'hdmi', 'lcd', 'cam', 'start', 'hpd', 'frame']
+
+DCMIPP_PIPE1 = 1
+
+
+def itm_payload(data, port):
+    """Keep the payload of the ITM software packets of one stimulus port."""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        header = data[i]
+        size = {1: 1, 2: 2, 3: 4}.get(header & 3, 0)
+        if size and (header & 4) == 0:
+            if header >> 3 == port:
+                out += data[i + 1:i + 1 + size]
+            i += 1 + size
+        elif (header & 3) == 0 and header not in (0x00, 0x80) and header & 0x80:
+            # Timestamp or extension packet: continuation bit on each byte
+            i += 1
+            while i < len(data):
+                i += 1
+                if data[i - 1] & 0x80 == 0:
+                    break
+        else:
+            i += 1 + size  # synchronisation, overflow, hardware source
+    return bytes(out)
+
+
+def parse(data):
+    """Yield (index, timestamp, event, arg) and the lost count per packet."""
+    lost = 0
+    i = 0
+    while True:
+        i = data.find(struct.pack('<I', MAGIC), i)
+        if i < 0 or i + HEADER.size > len(data):
+            break
+        _, count, packet_lost, first = HEADER.unpack_from(data, i)
+        end = i + HEADER.size + count * RECORD.size
+        if count == 0 or count > PACKET_MAX or end > len(data):
+            i += 1
+            continue
+        lost += packet_lost
+        for n in range(count):
+            timestamp, event = RECORD.unpack_from(data, i + HEADER.size + n * RECORD.size)
+            yield first + n, timestamp, event >> 24, event & 0xffffff
+        i = end
+    parse.lost = lost
+
+
+def unwrap(records):
+    """64-bit timestamps from the 32-bit cycle counter, in record order."""
+    out = []
+    base = 0
+    last = None
+    for index, timestamp, event, arg in sorted(records):
+        if last is not None and timestamp < last:
+            base += 1 << 32
+        last = timestamp
+        out.append((index, base + timestamp, event, arg))
+    return out
+
+
+def pairs(records, start, end, start_arg=None, end_arg=None):
+    """Durations from each start event to the next end event."""
+    out = []
+    t0 = None
+    for _, t, event, arg in records:
+        if event == start and (start_arg is None or arg == start_arg):
+            t0 = t
+        elif event == end and (end_arg is None or arg == end_arg) and t0 is not None:
+            out.append(t - t0)
+            t0 = None
+    return out
+
+
+def periods(records, event_id, arg=None):
+    times = [t for _, t, event, a in records if event == event_id and (arg is None or a == arg)]
+    return [b - a for a, b in zip(times, times[1:])]
+
+
+def pmu_reports(records):
+    """Per region totals of the PMU reports (per run averages x runs)."""
+    totals = {}
+    current = None
+    for _, _, event, arg in records:
+        if event == 0x40:
+            region, runs = arg >> 16, arg & 0xffff
+            current = totals.setdefault(region, dict.fromkeys(['runs'] + list(PMU_FIELDS.values()), 0))
+            current['runs'] += runs
+            weight = runs
+        elif event in PMU_FIELDS and current is not None:
+            current[PMU_FIELDS[event]] += arg * weight
+    return totals
+
+
+def pmu_table(totals, cpu_hz):
+    if not totals:
+        return
+    print('%-11s %8s %9s %6s %11s %7s %9s' % ('region', 'runs', 'us/run', 'IPC', 'D$miss/run', 'stall%', 'bus/run'))
+    for region in sorted(totals):
+        t = totals[region]
+        runs = t['runs'] or 1
+        name = PMU_REGIONS[region] if region < len(PMU_REGIONS) else str(region)
+        print('%-11s %8d %9.1f %6.2f %11d %7.1f %9d' %
+              (name, t['runs'], t['cycles'] / runs * 1e6 / cpu_hz, t['instr'] / (t['cycles'] or 1),
+               t['dcache_miss'] // runs, 100.0 * t['stall'] / (t['cycles'] or 1), t['bus'] // runs))
+
+
+def histogram(title, cycles, cpu_hz):
+    if not cycles:
+        print('%s: no samples' % title)
+        return
+    us = sorted(c * 1e6 / cpu_hz for c in cycles)
+    pct = lambda p: us[min(len(us) - 1, int(p * len(us)))]
+    print('%s: n=%d min=%.1f avg=%.1f p50=%.1f p99=%.1f max=%.1f us' %
+          (title, len(us), us[0], sum(us) / len(us), pct(0.5), pct(0.99), us[-1]))
+    buckets = {}
+    for v in us:
+        b = 0
+        while (1 << (b + 1)) <= v:
+            b += 1
+        buckets[b] = buckets.get(b, 0) + 1
+    peak = max(buckets.values())
+    for b in range(min(buckets), max(buckets) + 1):
+        n = buckets.get(b, 0)
+        print('  %8d us %7d %s' % (1 << b, n, '#' * ((n * 50 + peak - 1) // peak)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('capture', help='raw SWO or UART capture')
+    parser.add_argument('--itm', action='store_true', help='capture is ITM framed, keep stimulus port')
+    parser.add_argument('--port', type=int, default=1, help='ITM stimulus port (TRACE_ITM_PORT)')
+    parser.add_argument('--cpu-hz', type=float, default=800e6, help='DWT cycle counter frequency')
+    parser.add_argument('--timeline', action='store_true', help='print every record')
+    args = parser.parse_args()
+
+    with open(args.capture, 'rb') as f:
+        data = f.read()
+    if args.itm:
+        data = itm_payload(data, args.port)
+
+    parse.lost = 0
+    records = unwrap(list(parse(data)))
+    if not records:
+        print('no trace packet found', file=sys.stderr)
+        return 1
+
+    t0 = records[0][1]
+    if args.timeline:
+        for index, t, event, arg in records:
+            name = EVENTS.get(event, 'USER_%02X' % event if event >= 0x80 else '0x%02X' % event)
+            if event == 0x30 and arg < len(HDMI_STATES):
+                name += ' ' + HDMI_STATES[arg]
+            print('%8d %12.1f us %-14s 0x%06x' % (index, (t - t0) * 1e6 / args.cpu_hz, name, arg))
+
+    print('%d records over %.3f s, %d lost' %
+          (len(records), (records[-1][1] - t0) / args.cpu_hz, parse.lost))
+    histogram('camera frame period', periods(records, 0x02, DCMIPP_PIPE1), args.cpu_hz)
+    histogram('camera capture (vsync -> frame end)',
+              pairs(records, 0x01, 0x02, DCMIPP_PIPE1, DCMIPP_PIPE1), args.cpu_hz)
+    histogram('frame end -> ISP run', pairs(records, 0x02, 0x20, DCMIPP_PIPE1), args.cpu_hz)
+    histogram('ISP run', pairs(records, 0x20, 0x21), args.cpu_hz)
+    histogram('display line event period', periods(records, 0x11), args.cpu_hz)
+    histogram('frame end -> LTDC reload', pairs(records, 0x02, 0x10, DCMIPP_PIPE1), args.cpu_hz)
+    # Capture restarts before the vblank: pair with the frame end, not vsync
+    histogram('frame end -> first scanout', pairs(records, 0x02, 0x12, DCMIPP_PIPE1), args.cpu_hz)
+
+    pmu_table(pmu_reports(records), args.cpu_hz)
+
+    underruns = sum(1 for _, _, event, _ in records if event == 0x13)
+    if underruns:
+        print('LTDC underruns: %d frames' % underruns)
+    errors = [arg for _, _, event, arg in records if event == 0x03]
+    if errors:
+        bits = 0
+        for arg in errors:
+            bits |= arg
+        print('CSI errors: %d, SR1 bits seen 0x%06x' % (len(errors), bits))
+    for index, t, event, arg in records:
+        if event == 0x04:
+            print('camera restart #%d (%s) at %.1f ms' % (arg & 0xffff, 'stall' if arg >> 16 == 2 else 'errors',
+                                                       (t - t0) * 1e3 / args.cpu_hz))
+        if event == 0x05:
+            print('camera recovered, outage %d ms' % arg)
+    for index, t, event, arg in records:
+        if event == 0x30:
+            state = HDMI_STATES[arg] if arg < len(HDMI_STATES) else str(arg)
+            print('HDMI %s at %.1f ms' % (state, (t - t0) * 1e3 / args.cpu_hz))
+        if event == 0x31:
+            cause = HDMI_CAUSES[arg] if arg < len(HDMI_CAUSES) else str(arg)
+            print('HDMI link lost (%s) at %.1f ms' % (cause, (t - t0) * 1e3 / args.cpu_hz))
+        if event == 0x32:
+            cause = HDMI_CAUSES[arg >> 20] if arg >> 20 < len(HDMI_CAUSES) else str(arg >> 20)
+            print('HDMI link recovered (%s) in %d ms' % (cause, arg & 0xfffff))
+    for _, _, event, arg in records:
+        if event == 0x50:
+            print('PSRAM %d MHz: %d MB/s sequential reads under DMA load' % (arg >> 12, arg & 0xfff))
+        if event == 0x58:
+            print('IRQ latency, handler in %s: avg %d max %d cycles'
+                  % ('AXISRAM' if arg >> 22 else 'ITCM', arg & 0x7ff, (arg >> 11) & 0x7ff))
+        if event == 0x5c:
+            print('Bus arbitration preset %d: %d underruns in a period, raised' % (arg >> 16, arg & 0xffff))
+    # LED edges of the latency test, the photodiode side is on the scope
+    flashes = {}
+    for _, _, event, arg in records:
+        if event == 0x60:
+            content = arg >> 16
+            flashes[content] = flashes.get(content, 0) + 1
+    for content, count in sorted(flashes.items()):
+        name = HDMI_CONTENTS[content] if content < len(HDMI_CONTENTS) else str(content)
+        print('display latency test, content %s: %d flashes' % (name, count))
+    # Phase end times are measured from main(), in 10 us units
+    last = 0
+    for _, _, event, arg in records:
+        if event == 0x38:
+            phase, end_us = arg >> 20, (arg & 0xfffff) * 10
+            name = BOOT_PHASES[phase] if phase < len(BOOT_PHASES) else str(phase)
+            print('boot %-5s done at %8.1f ms (+%.1f ms)' % (name, end_us / 1e3, (end_us - last) / 1e3))
+            last = end_us
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())